@@ -8,9 +8,15 @@ public class DolbyIODebug : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 	
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "RHI", "DolbyIO" });
 
-		PrivateDependencyModuleNames.AddRange(new string[] {  });
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore", "HTTP", "Json", "AudioCaptureCore", "Media", "MediaAssets", "MediaUtils", "DolbyIODebugShaders" });
+
+		if (Target.Platform == UnrealTargetPlatform.Win64)
+		{
+			// Hot-plug notifications for the video device registry
+			PrivateDependencyModuleNames.AddRange(new string[] { "ApplicationCore", "Slate", "SlateCore" });
+		}
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
@@ -1,6 +1,111 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DolbyIODebug.h"
-#include "Modules/ModuleManager.h"
+#include "DolbyIODebugAudioLoad.h"
+#include "DolbyIODebugAudioProfile.h"
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebugJitterBuffer.h"
+#include "DolbyIODebugPreviewBudget.h"
+#include "DolbyIODebugStartupProfiler.h"
+#include "DolbyIODebugVideoTelemetry.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, DolbyIODebug, "DolbyIODebug" );
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY(LogDolbyIODebug);
+
+LLM_DEFINE_TAG(DolbyIODebug);
+LLM_DEFINE_TAG(DolbyIODebug_Events);
+LLM_DEFINE_TAG(DolbyIODebug_Frames);
+
+namespace DolbyIODebug
+{
+	float FramePoolIdleLifetime = 60.0f;
+	FAutoConsoleVariableRef CVarFramePoolIdleLifetime(TEXT("DolbyIODebug.FramePool.IdleLifetime"), FramePoolIdleLifetime,
+	                                                  TEXT("Seconds a pooled frame format is kept after it was last used."));
+
+	int32 FramePoolMaxFormats = 4;
+	FAutoConsoleVariableRef CVarFramePoolMaxFormats(TEXT("DolbyIODebug.FramePool.MaxFormats"), FramePoolMaxFormats,
+	                                                TEXT("Maximum number of frame formats kept in the pool."));
+
+	constexpr float FramePoolTrimInterval = 5.0f;
+
+	FAutoConsoleCommand CmdStartupSummary(TEXT("DolbyIODebug.Startup.Summary"),
+	                                      TEXT("Ends startup profiling and writes the summary of the phases reached so far."),
+	                                      FConsoleCommandDelegate::CreateLambda([] { FDolbyIODebugStartupProfiler::Get().WriteSummary(); }));
+}
+
+void FDolbyIODebugModule::StartupModule()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DolbyIODebugModuleStartup, DolbyIODebugChannel);
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::ModuleStartup);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FDolbyIODebugModule::HandlePostLoadMap);
+
+	// The game module is loaded before the engine creates the audio device, so the profile and the source workers apply to it.
+	FDolbyIODebugAudioProfile::ApplyFromCommandLine();
+	UDolbyIODebugAudioLoadController::ApplySourceWorkers();
+
+#if DOLBYIODEBUG_HEADLESS
+	if (FApp::CanEverRender())
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Headless build started with rendering enabled, pass -nullrhi to run without a GPU"));
+	}
+#endif
+
+	FramePool = MakeShared<FDolbyIODebugFramePool, ESPMode::ThreadSafe>();
+	TrimFramePoolHandle = FTSTicker::GetCoreTicker().AddTicker(
+	    FTickerDelegate::CreateRaw(this, &FDolbyIODebugModule::TrimFramePool), DolbyIODebug::FramePoolTrimInterval);
+	PublishTelemetryHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FDolbyIODebugModule::PublishTelemetry));
+	UpdatePreviewBudgetHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FDolbyIODebugModule::UpdatePreviewBudget));
+	PresentJitterBuffersHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FDolbyIODebugModule::PresentJitterBuffers));
+}
+
+void FDolbyIODebugModule::ShutdownModule()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	if (!GIsEditor)
+	{
+		FDolbyIODebugStartupProfiler::Get().WriteSummary();
+	}
+
+	FTSTicker::GetCoreTicker().RemoveTicker(TrimFramePoolHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(PublishTelemetryHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(UpdatePreviewBudgetHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(PresentJitterBuffersHandle);
+	FramePool->Empty();
+}
+
+bool FDolbyIODebugModule::TrimFramePool(float DeltaTime)
+{
+	FramePool->Trim(DolbyIODebug::FramePoolIdleLifetime, DolbyIODebug::FramePoolMaxFormats);
+	return true;
+}
+
+bool FDolbyIODebugModule::PublishTelemetry(float DeltaTime)
+{
+	FDolbyIODebugVideoTelemetry::Get().Publish();
+	return true;
+}
+
+bool FDolbyIODebugModule::UpdatePreviewBudget(float DeltaTime)
+{
+	FDolbyIODebugPreviewBudget::Get().Update(DeltaTime);
+	return true;
+}
+
+bool FDolbyIODebugModule::PresentJitterBuffers(float DeltaTime)
+{
+	// The core ticker runs at the start of the frame, so the textures are updated before the render thread draws it
+	FDolbyIODebugJitterBuffer::PresentAll(DeltaTime);
+	return true;
+}
+
+void FDolbyIODebugModule::HandlePostLoadMap(UWorld* World)
+{
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::MapLoaded);
+}
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDolbyIODebugModule, DolbyIODebug, "DolbyIODebug" );
@@ -3,4 +3,71 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "Modules/ModuleManager.h"
+#include "Subsystems/GameInstanceSubsystem.h"
 
+/** Set by DolbyIODebugHeadless.Target.cs, the target of the stress tests run on CI agents without GPUs. */
+#ifndef DOLBYIODEBUG_HEADLESS
+#define DOLBYIODEBUG_HEADLESS 0
+#endif
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDolbyIODebug, Log, All);
+
+/** Memory insights tags: the video event hot path, and the frame memory of the module's sinks. */
+LLM_DECLARE_TAG_API(DolbyIODebug, DOLBYIODEBUG_API);
+LLM_DECLARE_TAG_API(DolbyIODebug_Events, DOLBYIODEBUG_API);
+LLM_DECLARE_TAG_API(DolbyIODebug_Frames, DOLBYIODEBUG_API);
+
+class FDolbyIODebugFramePool;
+
+namespace DolbyIODebug
+{
+	/**
+	 * Returns a subsystem of the game instance an object belongs to, through the game instance of a game instance
+	 * subsystem or the world of anything else. Null when there is no game instance, as during teardown.
+	 */
+	template <typename TSubsystem>
+	TSubsystem* GetSubsystem(const UObject* Object)
+	{
+		const UGameInstance* GameInstance = nullptr;
+		if (const UGameInstanceSubsystem* GameInstanceSubsystem = Cast<UGameInstanceSubsystem>(Object))
+		{
+			GameInstance = GameInstanceSubsystem->GetGameInstance();
+		}
+		else if (const UWorld* World = Object ? Object->GetWorld() : nullptr)
+		{
+			GameInstance = World->GetGameInstance();
+		}
+		return GameInstance ? GameInstance->GetSubsystem<TSubsystem>() : nullptr;
+	}
+}
+
+class DOLBYIODEBUG_API FDolbyIODebugModule : public FDefaultGameModuleImpl
+{
+public:
+	static FDolbyIODebugModule& Get() { return FModuleManager::LoadModuleChecked<FDolbyIODebugModule>("DolbyIODebug"); }
+
+	void StartupModule() override;
+	void ShutdownModule() override;
+
+	/** Frame memory shared by every frame sink of the module, so it survives device switches. */
+	TSharedRef<FDolbyIODebugFramePool, ESPMode::ThreadSafe> GetFramePool() const { return FramePool.ToSharedRef(); }
+
+private:
+	bool TrimFramePool(float DeltaTime);
+	bool PublishTelemetry(float DeltaTime);
+	bool UpdatePreviewBudget(float DeltaTime);
+	bool PresentJitterBuffers(float DeltaTime);
+	void HandlePostLoadMap(UWorld* World);
+
+	TSharedPtr<FDolbyIODebugFramePool, ESPMode::ThreadSafe> FramePool;
+	FTSTicker::FDelegateHandle TrimFramePoolHandle;
+	FTSTicker::FDelegateHandle PublishTelemetryHandle;
+	FTSTicker::FDelegateHandle UpdatePreviewBudgetHandle;
+	FTSTicker::FDelegateHandle PresentJitterBuffersHandle;
+	FDelegateHandle PostLoadMapHandle;
+};
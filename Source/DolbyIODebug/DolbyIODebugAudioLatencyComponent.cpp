@@ -0,0 +1,239 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugAudioLatencyComponent.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugAudioProfile.h"
+#include "DolbyIODebugSwitchBenchmark.h"
+
+#include "AudioCaptureCore.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Sound/SoundWaveProcedural.h"
+#include "TimerManager.h"
+
+namespace DolbyIODebugAudioLatency
+{
+	constexpr int32 ClickSampleRate = 48000;
+	/** 5 ms burst of a 2 kHz square wave: short enough to time precisely, loud enough to survive voice processing. */
+	constexpr int32 ClickNumSamples = ClickSampleRate / 200;
+	constexpr int32 ClickHalfPeriod = ClickSampleRate / 4000;
+	constexpr int16 ClickAmplitude = 26000;
+
+	const TArray<uint8>& GetClickPcm()
+	{
+		static const TArray<uint8> ClickPcm = []
+		{
+			TArray<uint8> Pcm;
+			Pcm.SetNumUninitialized(ClickNumSamples * sizeof(int16));
+			int16* Samples = reinterpret_cast<int16*>(Pcm.GetData());
+			for (int32 Index = 0; Index < ClickNumSamples; ++Index)
+			{
+				Samples[Index] = (Index / ClickHalfPeriod) % 2 ? -ClickAmplitude : ClickAmplitude;
+			}
+			return Pcm;
+		}();
+		return ClickPcm;
+	}
+}
+
+/**
+ * Finds the two onsets of each click in the microphone signal. The capture callback runs on the audio capture thread;
+ * everything else is called from the game thread.
+ */
+class FDolbyIODebugLoopbackDetector
+{
+public:
+	~FDolbyIODebugLoopbackDetector() { Close(); }
+
+	bool Open(float InThreshold, double InHoldOff)
+	{
+		Threshold = InThreshold;
+		HoldOff = InHoldOff;
+
+		Audio::FAudioCaptureDeviceParams Params;
+		if (!Capture.OpenCaptureStream(Params,
+		                               [this](const float* InAudio, int32 NumFrames, int32 NumChannels, int32 SampleRate,
+		                                      double StreamTime, bool bOverFlow) { OnCapture(InAudio, NumFrames, NumChannels, SampleRate); },
+		                               256))
+		{
+			return false;
+		}
+		return Capture.StartStream();
+	}
+
+	void Close()
+	{
+		if (Capture.IsStreamOpen())
+		{
+			Capture.StopStream();
+			Capture.CloseStream();
+		}
+	}
+
+	void BeginClick(double InClickTime)
+	{
+		FScopeLock Lock(&CriticalSection);
+		ClickTime = InClickTime;
+		LocalOnsetTime = -1.0;
+	}
+
+	void GetResults(TArray<double>& OutLocalRoundTripMs, TArray<double>& OutMouthToEarMs) const
+	{
+		FScopeLock Lock(&CriticalSection);
+		OutLocalRoundTripMs = LocalRoundTripMs;
+		OutMouthToEarMs = MouthToEarMs;
+	}
+
+private:
+	void OnCapture(const float* InAudio, int32 NumFrames, int32 NumChannels, int32 SampleRate)
+	{
+		const double BufferEndTime = FPlatformTime::Seconds();
+
+		FScopeLock Lock(&CriticalSection);
+		for (int32 Frame = 0; Frame < NumFrames && ClickTime >= 0.0; ++Frame)
+		{
+			if (FMath::Abs(InAudio[Frame * NumChannels]) < Threshold)
+			{
+				continue;
+			}
+
+			const double OnsetTime = BufferEndTime - static_cast<double>(NumFrames - Frame) / SampleRate;
+			if (OnsetTime < HoldOffUntil || OnsetTime < ClickTime)
+			{
+				continue;
+			}
+			HoldOffUntil = OnsetTime + HoldOff;
+
+			if (LocalOnsetTime < 0.0)
+			{
+				LocalOnsetTime = OnsetTime;
+				LocalRoundTripMs.Add((OnsetTime - ClickTime) * 1000.0);
+			}
+			else
+			{
+				MouthToEarMs.Add((OnsetTime - LocalOnsetTime) * 500.0);
+				ClickTime = -1.0;
+			}
+		}
+	}
+
+	Audio::FAudioCapture Capture;
+	mutable FCriticalSection CriticalSection;
+	float Threshold = 0.0f;
+	double HoldOff = 0.0;
+	double ClickTime = -1.0;
+	double LocalOnsetTime = -1.0;
+	double HoldOffUntil = 0.0;
+	TArray<double> LocalRoundTripMs;
+	TArray<double> MouthToEarMs;
+};
+
+UDolbyIODebugAudioLatencyComponent::UDolbyIODebugAudioLatencyComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UDolbyIODebugAudioLatencyComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	int32 CommandLineClicks = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("DolbyIOAudioLatency="), CommandLineClicks) && CommandLineClicks > 0)
+	{
+		StartMeasurement(CommandLineClicks);
+	}
+}
+
+void UDolbyIODebugAudioLatencyComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopMeasurement();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDolbyIODebugAudioLatencyComponent::StartMeasurement(int32 NumClicks)
+{
+	if (bMeasuring || NumClicks <= 0)
+	{
+		return;
+	}
+
+	Detector = MakeShared<FDolbyIODebugLoopbackDetector, ESPMode::ThreadSafe>();
+	if (!Detector->Open(DetectionThreshold, OnsetHoldOff / 1000.0))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Cannot measure audio latency: failed to open the default capture device"));
+		Detector.Reset();
+		return;
+	}
+
+	bMeasuring = true;
+	RemainingClicks = NumClicks;
+	NumClicksPlayed = 0;
+	GetWorld()->GetTimerManager().SetTimer(ClickTimerHandle, this, &UDolbyIODebugAudioLatencyComponent::PlayClick, ClickInterval, true, 0.0f);
+}
+
+void UDolbyIODebugAudioLatencyComponent::StopMeasurement()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(ClickTimerHandle);
+	}
+	Detector.Reset();
+	RemainingClicks = 0;
+	bMeasuring = false;
+}
+
+void UDolbyIODebugAudioLatencyComponent::PlayClick()
+{
+	// The last click gets one interval to come back before the measurement ends.
+	if (RemainingClicks == 0)
+	{
+		FinishMeasurement();
+		return;
+	}
+
+	USoundWaveProcedural* Click = NewObject<USoundWaveProcedural>(this);
+	Click->SetSampleRate(DolbyIODebugAudioLatency::ClickSampleRate);
+	Click->NumChannels = 1;
+	Click->Duration = static_cast<float>(DolbyIODebugAudioLatency::ClickNumSamples) / DolbyIODebugAudioLatency::ClickSampleRate;
+	Click->SoundGroup = SOUNDGROUP_Default;
+	Click->bLooping = false;
+	const TArray<uint8>& ClickPcm = DolbyIODebugAudioLatency::GetClickPcm();
+	Click->QueueAudio(ClickPcm.GetData(), ClickPcm.Num());
+
+	Detector->BeginClick(FPlatformTime::Seconds());
+	UGameplayStatics::PlaySound2D(this, Click);
+	--RemainingClicks;
+	++NumClicksPlayed;
+}
+
+void UDolbyIODebugAudioLatencyComponent::FinishMeasurement()
+{
+	TArray<double> LocalRoundTripMs;
+	TArray<double> MouthToEarMs;
+	Detector->GetResults(LocalRoundTripMs, MouthToEarMs);
+	LocalRoundTripMs.Sort();
+	MouthToEarMs.Sort();
+
+	FDolbyIODebugAudioLatencyResult Result;
+	Result.AudioProfile = FDolbyIODebugAudioProfile::GetActiveProfileName();
+	Result.NumClicks = NumClicksPlayed;
+	Result.NumLocalDetected = LocalRoundTripMs.Num();
+	Result.NumConferenceDetected = MouthToEarMs.Num();
+	Result.LocalRoundTripP50 = FDolbyIODebugSwitchBenchmark::Percentile(LocalRoundTripMs, 50.0);
+	Result.LocalRoundTripP95 = FDolbyIODebugSwitchBenchmark::Percentile(LocalRoundTripMs, 95.0);
+	Result.MouthToEarP50 = FDolbyIODebugSwitchBenchmark::Percentile(MouthToEarMs, 50.0);
+	Result.MouthToEarP95 = FDolbyIODebugSwitchBenchmark::Percentile(MouthToEarMs, 95.0);
+
+	UE_LOG(LogDolbyIODebug, Display,
+	       TEXT("Audio latency (profile %s): local round trip p50 %.1f ms p95 %.1f ms (%d/%d clicks), ")
+	           TEXT("mouth-to-ear p50 %.1f ms p95 %.1f ms (%d/%d clicks)"),
+	       Result.AudioProfile.IsEmpty() ? TEXT("default") : *Result.AudioProfile, Result.LocalRoundTripP50,
+	       Result.LocalRoundTripP95, Result.NumLocalDetected, Result.NumClicks, Result.MouthToEarP50, Result.MouthToEarP95,
+	       Result.NumConferenceDetected, Result.NumClicks);
+
+	StopMeasurement();
+	OnLatencyMeasured.Broadcast(Result);
+}
@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DolbyIODebugAudioLatencyComponent.generated.h"
+
+class FDolbyIODebugLoopbackDetector;
+
+/** Latency percentiles of one loopback measurement, in milliseconds. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugAudioLatencyResult
+{
+	GENERATED_BODY()
+
+	/** Audio profile active when measuring, empty for the platform defaults. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString AudioProfile;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumClicks = 0;
+
+	/** Clicks heard directly by the local microphone. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumLocalDetected = 0;
+
+	/** Clicks heard again after travelling through the conference and back. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumConferenceDetected = 0;
+
+	/** From playing the click to hearing it in the local microphone: engine output + acoustic path + capture. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "ms"))
+	double LocalRoundTripP50 = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "ms"))
+	double LocalRoundTripP95 = 0.0;
+
+	/** Half of the time between hearing the click locally and hearing it again through the conference. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "ms"))
+	double MouthToEarP50 = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "ms"))
+	double MouthToEarP95 = 0.0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnAudioLatencyMeasuredDelegate, const FDolbyIODebugAudioLatencyResult&, Result);
+
+/**
+ * Measures audio latency with clicks played through the speakers and picked up again by the microphone.
+ *
+ * Each click is heard twice by the microphone: once directly from the local speakers, and once more after the Dolby.io
+ * SDK has captured it, sent it to a remote participant that plays it back (a second instance of the game with its
+ * speakers next to its microphone, or any echoing participant) and received it back. The first onset gives the local
+ * round trip, which is what the audio profiles tune; half of the gap between the two onsets gives the mouth-to-ear
+ * latency through the conference. The SDK keeps its audio pipeline to itself, so the microphone is opened a second
+ * time through AudioCapture, which devices in shared mode allow.
+ *
+ * Can be started with -DolbyIOAudioLatency=<clicks> on the command line.
+ */
+UCLASS(ClassGroup = (DolbyIO), Meta = (BlueprintSpawnableComponent))
+class DOLBYIODEBUG_API UDolbyIODebugAudioLatencyComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDolbyIODebugAudioLatencyComponent();
+
+	/** Seconds between clicks. Must be longer than the latency through the conference. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.2", Units = "s"))
+	float ClickInterval = 1.0f;
+
+	/** Microphone level, as a linear amplitude, above which a click is detected. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float DetectionThreshold = 0.2f;
+
+	/** Time after an onset during which the ringing of the same click is ignored. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "ms"))
+	float OnsetHoldOff = 30.0f;
+
+	/** Starts playing NumClicks clicks. Does nothing if a measurement is already running. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StartMeasurement(int32 NumClicks = 10);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StopMeasurement();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsMeasuring() const { return bMeasuring; }
+
+	/** Broadcast when the last click of a measurement has had time to come back. */
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnAudioLatencyMeasuredDelegate OnLatencyMeasured;
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void PlayClick();
+	void FinishMeasurement();
+
+	TSharedPtr<FDolbyIODebugLoopbackDetector, ESPMode::ThreadSafe> Detector;
+	FTimerHandle ClickTimerHandle;
+	int32 RemainingClicks = 0;
+	int32 NumClicksPlayed = 0;
+	bool bMeasuring = false;
+};
@@ -0,0 +1,333 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugAudioLoad.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugAudioProfile.h"
+
+#include "AudioDevice.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Parse.h"
+
+#include <atomic>
+
+namespace DolbyIODebugAudioLoad
+{
+	/** Saved in the user settings, read back by ApplySourceWorkers on the next run. */
+	const TCHAR* const SavedSection = TEXT("DolbyIODebug.AudioLoad");
+
+	/** Voices a source worker is expected to keep up with until it was measured. */
+	constexpr float DefaultVoicesPerSourceWorker = 8.0f;
+
+	/** Weight of the measurement of a run in the saved voices per source worker. */
+	constexpr float MeasurementWeight = 0.5f;
+
+	/** A callback this much later than its buffer lasts is one the device underran for. */
+	constexpr double LateIntervalFactor = 1.5;
+
+	/** Mixed sources are never limited below this. */
+	constexpr int32 MinMaxChannels = 8;
+
+	struct FLevel
+	{
+		bool bDisableBinaural;
+		float MaxChannelsFraction;
+	};
+
+	constexpr FLevel Levels[] = {{false, 1.0f}, {true, 1.0f}, {true, 0.75f}, {true, 0.5f}};
+	constexpr int32 NumLevels = UE_ARRAY_COUNT(Levels);
+
+	/** Times the render callbacks of the main submix of one audio device, on the audio render thread. */
+	class FRenderCallbackTimer : public ISubmixBufferListener
+	{
+	public:
+		void OnNewSubmixBuffer(const USoundSubmix* OwningSubmix, float* AudioData, int32 NumSamples, int32 NumChannels, const int32 SampleRate,
+		                       double AudioClock) override
+		{
+			const double Now = FPlatformTime::Seconds();
+			if (LastCallbackTime > 0.0 && NumChannels > 0 && SampleRate > 0)
+			{
+				const double BufferDuration = static_cast<double>(NumSamples) / NumChannels / SampleRate;
+				if (Now - LastCallbackTime > BufferDuration * LateIntervalFactor)
+				{
+					NumLateCallbacks.fetch_add(1, std::memory_order_relaxed);
+				}
+				NumCallbacks.fetch_add(1, std::memory_order_relaxed);
+			}
+			LastCallbackTime = Now;
+		}
+
+		std::atomic<uint64> NumCallbacks{0};
+		std::atomic<uint64> NumLateCallbacks{0};
+
+	private:
+		/** Audio render thread only. */
+		double LastCallbackTime = 0.0;
+	};
+
+	/**
+	 * One timer per audio device, kept for the lifetime of the process: unregistering a listener only takes effect
+	 * on the next render, so a timer is never deleted while the audio render thread may still call it.
+	 */
+	FRenderCallbackTimer& GetTimer(Audio::FDeviceId DeviceID)
+	{
+		static TMap<Audio::FDeviceId, TUniquePtr<FRenderCallbackTimer>> Timers;
+		TUniquePtr<FRenderCallbackTimer>& Timer = Timers.FindOrAdd(DeviceID);
+		if (!Timer)
+		{
+			Timer = MakeUnique<FRenderCallbackTimer>();
+		}
+		return *Timer;
+	}
+
+	IConsoleVariable* GetDisableBinauralVariable()
+	{
+		return IConsoleManager::Get().FindConsoleVariable(TEXT("au.DisableBinauralSpatialization"));
+	}
+
+	int32 GetNumSourceWorkers()
+	{
+		int32 NumSourceWorkers = 0;
+		GConfig->GetInt(FPlatformProperties::GetRuntimeSettingsClassName(), TEXT("AudioNumSourceWorkers"), NumSourceWorkers, GEngineIni);
+		return FMath::Max(NumSourceWorkers, 1);
+	}
+}
+
+void UDolbyIODebugAudioLoadController::ApplySourceWorkers()
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	// An audio profile that sets the workers itself is left alone
+	FString ProfileWorkers;
+	if (!FDolbyIODebugAudioProfile::GetActiveProfileName().IsEmpty() &&
+	    GConfig->GetString(*(TEXT("DolbyIODebug.AudioProfile.") + FDolbyIODebugAudioProfile::GetActiveProfileName()),
+	                       TEXT("AudioNumSourceWorkers"), ProfileWorkers, GEngineIni))
+	{
+		return;
+	}
+
+	int32 ExpectedVoices = 0;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("DolbyIOExpectedVoices="), ExpectedVoices))
+	{
+		GConfig->GetInt(SavedSection, TEXT("PeakVoices"), ExpectedVoices, GGameUserSettingsIni);
+	}
+	if (ExpectedVoices <= 0)
+	{
+		return;
+	}
+
+	float VoicesPerSourceWorker = DefaultVoicesPerSourceWorker;
+	GConfig->GetFloat(SavedSection, TEXT("VoicesPerSourceWorker"), VoicesPerSourceWorker, GGameUserSettingsIni);
+	const int32 MaxSourceWorkers = FMath::Max(FPlatformMisc::NumberOfCores() - 1, 1);
+	const int32 NumSourceWorkers = FMath::Clamp(FMath::CeilToInt(ExpectedVoices / FMath::Max(VoicesPerSourceWorker, 1.0f)), 1, MaxSourceWorkers);
+
+	GConfig->SetInt(FPlatformProperties::GetRuntimeSettingsClassName(), TEXT("AudioNumSourceWorkers"), NumSourceWorkers, GEngineIni);
+	UE_LOG(LogDolbyIODebug, Log, TEXT("%d audio source workers for %d sources at %.1f sources per worker"), NumSourceWorkers, ExpectedVoices,
+	       VoicesPerSourceWorker);
+}
+
+void UDolbyIODebugAudioLoadController::Initialize(FSubsystemCollectionBase& Collection)
+{
+	using namespace DolbyIODebugAudioLoad;
+	Super::Initialize(Collection);
+
+	if (FAudioDevice* AudioDevice = GetAudioDevice())
+	{
+		FRenderCallbackTimer& Timer = GetTimer(AudioDevice->DeviceID);
+		LastNumCallbacks = Timer.NumCallbacks.load(std::memory_order_relaxed);
+		LastNumLateCallbacks = Timer.NumLateCallbacks.load(std::memory_order_relaxed);
+		AudioDevice->RegisterSubmixBufferListener(&Timer);
+	}
+}
+
+void UDolbyIODebugAudioLoadController::Deinitialize()
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	SetLevel(0);
+	if (FAudioDevice* AudioDevice = GetAudioDevice())
+	{
+		AudioDevice->UnregisterSubmixBufferListener(&GetTimer(AudioDevice->DeviceID));
+	}
+
+	SaveSourceWorkerMeasurement();
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugAudioLoadController::SaveSourceWorkerMeasurement()
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	if (PeakVoices == 0)
+	{
+		return;
+	}
+
+	// A run that fell behind measured an upper bound, and one that kept up a lower bound: the saved value is only moved
+	// toward the bound it is on the wrong side of
+	float SavedVoicesPerSourceWorker = 0.0f;
+	GConfig->GetFloat(SavedSection, TEXT("VoicesPerSourceWorker"), SavedVoicesPerSourceWorker, GGameUserSettingsIni);
+	const float KeptUpVoicesPerSourceWorker = static_cast<float>(PeakVoices) / GetNumSourceWorkers();
+	float VoicesPerSourceWorker = SavedVoicesPerSourceWorker;
+	if (MeasuredVoicesPerSourceWorker > 0.0f)
+	{
+		VoicesPerSourceWorker = SavedVoicesPerSourceWorker > MeasuredVoicesPerSourceWorker
+		                            ? FMath::Lerp(SavedVoicesPerSourceWorker, MeasuredVoicesPerSourceWorker, MeasurementWeight)
+		                            : (SavedVoicesPerSourceWorker > 0.0f ? SavedVoicesPerSourceWorker : MeasuredVoicesPerSourceWorker);
+	}
+	else if (SavedVoicesPerSourceWorker > 0.0f && KeptUpVoicesPerSourceWorker > SavedVoicesPerSourceWorker)
+	{
+		VoicesPerSourceWorker = FMath::Lerp(SavedVoicesPerSourceWorker, KeptUpVoicesPerSourceWorker, MeasurementWeight);
+	}
+
+	GConfig->SetInt(SavedSection, TEXT("PeakVoices"), PeakVoices, GGameUserSettingsIni);
+	if (VoicesPerSourceWorker > 0.0f)
+	{
+		GConfig->SetFloat(SavedSection, TEXT("VoicesPerSourceWorker"), VoicesPerSourceWorker, GGameUserSettingsIni);
+	}
+	GConfig->Flush(false, GGameUserSettingsIni);
+}
+
+bool UDolbyIODebugAudioLoadController::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDolbyIODebugAudioLoadController::Tick(float DeltaTime)
+{
+	TimeSinceEvaluation += DeltaTime;
+	if (TimeSinceEvaluation >= EvaluationInterval)
+	{
+		Evaluate();
+	}
+}
+
+TStatId UDolbyIODebugAudioLoadController::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDolbyIODebugAudioLoadController, STATGROUP_Tickables);
+}
+
+void UDolbyIODebugAudioLoadController::Evaluate()
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	const float ElapsedTime = TimeSinceEvaluation;
+	TimeSinceEvaluation = 0.0f;
+
+	const FAudioDevice* AudioDevice = GetAudioDevice();
+	if (!AudioDevice || !bEnabled)
+	{
+		SetLevel(0);
+		return;
+	}
+
+	const FRenderCallbackTimer& Timer = GetTimer(AudioDevice->DeviceID);
+	const uint64 NumCallbacks = Timer.NumCallbacks.load(std::memory_order_relaxed);
+	const uint64 NumLateCallbacks = Timer.NumLateCallbacks.load(std::memory_order_relaxed);
+	const uint64 NewCallbacks = NumCallbacks - LastNumCallbacks;
+	const uint64 NewLateCallbacks = NumLateCallbacks - LastNumLateCallbacks;
+	LastNumCallbacks = NumCallbacks;
+	LastNumLateCallbacks = NumLateCallbacks;
+	LateFraction = NewCallbacks > 0 ? static_cast<float>(NewLateCallbacks) / NewCallbacks : 0.0f;
+
+	// The sources the mixer renders are what loads the callback; the conference voices are mixed by the SDK instead
+	NumVoices = AudioDevice->GetNumActiveSources();
+	PeakVoices = FMath::Max(PeakVoices, NumVoices);
+
+	if (LateFraction > MaxLateFraction)
+	{
+		TimeWithoutLateCallbacks = 0.0f;
+		if (Level == 0)
+		{
+			RecordOverload();
+		}
+		SetLevel(GetNextLevel(1));
+	}
+	else if (NewLateCallbacks == 0)
+	{
+		TimeWithoutLateCallbacks += ElapsedTime;
+		if (TimeWithoutLateCallbacks >= RestoreDelay && Level > 0)
+		{
+			TimeWithoutLateCallbacks = 0.0f;
+			SetLevel(GetNextLevel(-1));
+		}
+	}
+}
+
+void UDolbyIODebugAudioLoadController::RecordOverload()
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	if (NumVoices == 0)
+	{
+		return;
+	}
+
+	const float VoicesPerSourceWorker = static_cast<float>(NumVoices) / GetNumSourceWorkers();
+	MeasuredVoicesPerSourceWorker =
+	    MeasuredVoicesPerSourceWorker > 0.0f ? FMath::Min(MeasuredVoicesPerSourceWorker, VoicesPerSourceWorker) : VoicesPerSourceWorker;
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Audio render callback fell behind at %d sources on %d source workers"), NumVoices, GetNumSourceWorkers());
+}
+
+int32 UDolbyIODebugAudioLoadController::GetNextLevel(int32 Direction) const
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	// Without a spatialization plugin nothing renders HRTF, so disabling it is no step at all
+	const FAudioDevice* AudioDevice = GetAudioDevice();
+	const bool bHasSpatialization = AudioDevice && AudioDevice->IsSpatializationPluginEnabled();
+	for (int32 NextLevel = Level + Direction; NextLevel >= 0 && NextLevel < NumLevels; NextLevel += Direction)
+	{
+		const FLevel& From = Levels[NextLevel - Direction];
+		const FLevel& To = Levels[NextLevel];
+		if (To.MaxChannelsFraction != From.MaxChannelsFraction || (bHasSpatialization && To.bDisableBinaural != From.bDisableBinaural))
+		{
+			return NextLevel;
+		}
+	}
+	return Direction < 0 ? 0 : Level;
+}
+
+void UDolbyIODebugAudioLoadController::SetLevel(int32 NewLevel)
+{
+	using namespace DolbyIODebugAudioLoad;
+
+	if (NewLevel == Level)
+	{
+		return;
+	}
+
+	FAudioDevice* AudioDevice = GetAudioDevice();
+	IConsoleVariable* DisableBinaural = GetDisableBinauralVariable();
+	if (Level == 0)
+	{
+		OriginalMaxChannels = AudioDevice ? AudioDevice->GetMaxChannels() : 0;
+		OriginalDisableBinaural = DisableBinaural ? DisableBinaural->GetInt() : 0;
+	}
+
+	Level = NewLevel;
+	const FLevel& Settings = Levels[Level];
+	if (DisableBinaural)
+	{
+		DisableBinaural->Set(Settings.bDisableBinaural ? 1 : OriginalDisableBinaural, ECVF_SetByCode);
+	}
+	if (AudioDevice && OriginalMaxChannels > 0)
+	{
+		AudioDevice->SetMaxChannels(FMath::Max(FMath::RoundToInt(OriginalMaxChannels * Settings.MaxChannelsFraction),
+		                                       FMath::Min(MinMaxChannels, OriginalMaxChannels)));
+	}
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Audio load level %d at %d sources, %.1f%% late callbacks: %s, %d sources"), Level, NumVoices,
+	       LateFraction * 100.0f, Settings.bDisableBinaural ? TEXT("panning") : TEXT("HRTF"),
+	       AudioDevice ? AudioDevice->GetMaxChannels() : 0);
+}
+
+FAudioDevice* UDolbyIODebugAudioLoadController::GetAudioDevice() const
+{
+	const UWorld* World = GetWorld();
+	return World ? World->GetAudioDeviceRaw() : nullptr;
+}
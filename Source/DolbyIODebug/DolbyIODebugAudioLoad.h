@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DolbyIODebugAudioLoad.generated.h"
+
+/**
+ * Keeps the render callback of the engine's audio mixer within its budget as the number of sounds it mixes grows.
+ *
+ * This only covers the audio the engine mixes: game sounds, and the audio of a replayed recording. The voices of the
+ * conference are rendered by the Dolby.io SDK in its own pipeline, which exposes neither its load nor its quality, so
+ * they are neither measured nor throttled here.
+ *
+ * The render callback of the main submix is timed on the audio render thread: a callback that comes later than its
+ * buffer lasts is one the device had to underrun for. While more than MaxLateFraction of the callbacks are late the
+ * audio steps down a ladder, first replacing HRTF with panning if a spatialization plugin renders HRTF at all, and
+ * then lowering the number of sources mixed at once, which virtualizes the quietest and furthest ones first; once the
+ * callbacks keep up again it steps back up.
+ *
+ * The number of source workers is fixed when the audio device is created, so it is scaled across runs instead: the
+ * number of active sources per source worker the mixer keeps up with, and the peak number of active sources of the
+ * run, are saved, and ApplySourceWorkers sets AudioNumSourceWorkers from them before the next audio device is created.
+ * Each run moves the saved sources per worker halfway toward what it measured, up when it kept up with more sources
+ * and down when it fell behind with fewer, so one hitch does not size the workers for good.
+ * -DolbyIOExpectedVoices=<n> on the command line sizes the workers for n sources instead of the last peak.
+ */
+UCLASS(Config = Game)
+class DOLBYIODEBUG_API UDolbyIODebugAudioLoadController : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug")
+	bool bEnabled = true;
+
+	/** Late callbacks tolerated, as a fraction of the callbacks over an evaluation. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MaxLateFraction = 0.01f;
+
+	/** Seconds without late callbacks before the audio steps back up. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "s"))
+	float RestoreDelay = 10.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.1", Units = "s"))
+	float EvaluationInterval = 1.0f;
+
+	/** Sets AudioNumSourceWorkers for the voices of the last run. Must be called before the audio device is created. */
+	static void ApplySourceWorkers();
+
+	/** Index in the ladder, 0 being full quality. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	int32 GetLevel() const { return Level; }
+
+	/** Fraction of the render callbacks that were late over the last evaluation. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	float GetLateFraction() const { return LateFraction; }
+
+	/** Sources the mixer rendered at the last evaluation. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	int32 GetNumVoices() const { return NumVoices; }
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+
+protected:
+	bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void Evaluate();
+	void SetLevel(int32 NewLevel);
+	/** The next level in Direction that changes anything on this audio device, Level if there is none. */
+	int32 GetNextLevel(int32 Direction) const;
+	void RecordOverload();
+	void SaveSourceWorkerMeasurement();
+	class FAudioDevice* GetAudioDevice() const;
+
+	int32 Level = 0;
+	float LateFraction = 0.0f;
+	int32 NumVoices = 0;
+	/** Peak of NumVoices over this run. */
+	int32 PeakVoices = 0;
+	/** Lowest number of voices per source worker at which the callbacks fell behind this run, 0 until they did. */
+	float MeasuredVoicesPerSourceWorker = 0.0f;
+	float TimeSinceEvaluation = 0.0f;
+	float TimeWithoutLateCallbacks = 0.0f;
+	uint64 LastNumCallbacks = 0;
+	uint64 LastNumLateCallbacks = 0;
+
+	/** What the ladder overrides, saved at the first step down to restore at level 0. */
+	int32 OriginalMaxChannels = 0;
+	int32 OriginalDisableBinaural = 0;
+};
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugAudioProfile.h"
+#include "DolbyIODebug.h"
+
+#include "Misc/CommandLine.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Parse.h"
+
+namespace DolbyIODebugAudioProfile
+{
+	FString ActiveProfileName;
+}
+
+bool FDolbyIODebugAudioProfile::ApplyFromCommandLine()
+{
+	FString ProfileName;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("DolbyIOAudioProfile="), ProfileName))
+	{
+		return true;
+	}
+	return Apply(ProfileName);
+}
+
+bool FDolbyIODebugAudioProfile::Apply(const FString& ProfileName)
+{
+	const FString ProfileSection = TEXT("DolbyIODebug.AudioProfile.") + ProfileName;
+	TArray<FString> Settings;
+	if (!GConfig->GetSection(*ProfileSection, Settings, GEngineIni))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Audio profile %s not found, expected a [%s] section"), *ProfileName, *ProfileSection);
+		return false;
+	}
+
+	const TCHAR* PlatformSection = FPlatformProperties::GetRuntimeSettingsClassName();
+	for (const FString& Setting : Settings)
+	{
+		FString Key;
+		FString Value;
+		if (Setting.Split(TEXT("="), &Key, &Value))
+		{
+			GConfig->SetString(PlatformSection, *Key, *Value, GEngineIni);
+			UE_LOG(LogDolbyIODebug, Log, TEXT("Audio profile %s: %s=%s"), *ProfileName, *Key, *Value);
+		}
+	}
+
+	DolbyIODebugAudioProfile::ActiveProfileName = ProfileName;
+	return true;
+}
+
+const FString& FDolbyIODebugAudioProfile::GetActiveProfileName()
+{
+	return DolbyIODebugAudioProfile::ActiveProfileName;
+}
@@ -0,0 +1,25 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Audio device settings profiles, selected with -DolbyIOAudioProfile=<Name> on the command line.
+ *
+ * A profile is the [DolbyIODebug.AudioProfile.<Name>] section of the engine config. Its keys override the audio keys
+ * of the platform's target settings section (AudioCallbackBufferFrameSize, AudioNumBuffersToEnqueue, ...), which is
+ * where the audio mixer reads them from. The game module loads before the engine creates the audio device, so the
+ * profile applies to the main audio device.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugAudioProfile
+{
+public:
+	/** Applies the profile given on the command line, if any. Returns false if the profile does not exist. */
+	static bool ApplyFromCommandLine();
+
+	static bool Apply(const FString& ProfileName);
+
+	/** Name of the profile that was applied, empty if none. */
+	static const FString& GetActiveProfileName();
+};
@@ -0,0 +1,695 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugColorConversion.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugVideoFrame.h"
+
+#include "DolbyIODebugYuvToRgba.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+
+#include <atomic>
+
+#if PLATFORM_CPU_X86_FAMILY
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DOLBYIODEBUG_TARGET_SSE41
+#define DOLBYIODEBUG_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define DOLBYIODEBUG_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DOLBYIODEBUG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#include <immintrin.h>
+#endif
+
+#define DOLBYIODEBUG_WITH_NEON (PLATFORM_CPU_ARM_FAMILY && (defined(__ARM_NEON) || defined(__ARM_NEON__)))
+#if DOLBYIODEBUG_WITH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace DolbyIODebugColorConversion
+{
+	/**
+	 * BT.601 limited range in 6-bit fixed point. The SIMD kernels compute the same sums in saturating 16-bit
+	 * arithmetic; only blue can exceed the 16-bit range, and only when it is clamped to 255 either way.
+	 */
+	constexpr int32 CoefY = 75;
+	constexpr int32 CoefRV = 102;
+	constexpr int32 CoefGU = 25;
+	constexpr int32 CoefGV = 52;
+	constexpr int32 CoefBU = 129;
+	constexpr int32 Round = 32;
+	constexpr int32 Shift = 6;
+
+	/** Pixels converted per iteration of the SIMD kernels. */
+	constexpr int32 BlockWidth = 16;
+
+	FORCEINLINE uint8 Clamp8(int32 Value)
+	{
+		return static_cast<uint8>(FMath::Clamp(Value, 0, 255));
+	}
+
+	FORCEINLINE void ConvertPixelScalar(int32 Y, int32 U, int32 V, uint8* Dst)
+	{
+		const int32 YTerm = CoefY * (Y - 16) + Round;
+		const int32 D = U - 128;
+		const int32 E = V - 128;
+		Dst[0] = Clamp8((YTerm + CoefBU * D) >> Shift);
+		Dst[1] = Clamp8((YTerm - CoefGU * D - CoefGV * E) >> Shift);
+		Dst[2] = Clamp8((YTerm + CoefRV * E) >> Shift);
+		Dst[3] = 255;
+	}
+
+	/** Converts one row. Src0 is the Y row or the packed row; Src1 and Src2 are the chroma rows if the format has them. */
+	using FRowFunction = void (*)(const uint8* Src0, const uint8* Src1, const uint8* Src2, uint8* Dst, int32 Begin, int32 End);
+
+	struct FKernel
+	{
+		FRowFunction NV12;
+		FRowFunction YUY2;
+		FRowFunction I420;
+	};
+
+	void ConvertRowNV12Scalar(const uint8* Y, const uint8* UV, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		for (int32 X = Begin; X < End; ++X)
+		{
+			ConvertPixelScalar(Y[X], UV[X & ~1], UV[X | 1], Dst + X * 4);
+		}
+	}
+
+	void ConvertRowYUY2Scalar(const uint8* Packed, const uint8*, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		for (int32 X = Begin; X < End; ++X)
+		{
+			const uint8* Pair = Packed + (X & ~1) * 2;
+			ConvertPixelScalar(Pair[(X & 1) * 2], Pair[1], Pair[3], Dst + X * 4);
+		}
+	}
+
+	void ConvertRowI420Scalar(const uint8* Y, const uint8* U, const uint8* V, uint8* Dst, int32 Begin, int32 End)
+	{
+		for (int32 X = Begin; X < End; ++X)
+		{
+			ConvertPixelScalar(Y[X], U[X / 2], V[X / 2], Dst + X * 4);
+		}
+	}
+
+	const FKernel ScalarKernel = {&ConvertRowNV12Scalar, &ConvertRowYUY2Scalar, &ConvertRowI420Scalar};
+
+#if PLATFORM_CPU_X86_FAMILY
+	void GetCpuId(int32 Leaf, int32 SubLeaf, int32 OutRegisters[4])
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		__cpuidex(OutRegisters, Leaf, SubLeaf);
+#else
+		uint32 Registers[4] = {};
+		__cpuid_count(Leaf, SubLeaf, Registers[0], Registers[1], Registers[2], Registers[3]);
+		FMemory::Memcpy(OutRegisters, Registers, sizeof(Registers));
+#endif
+	}
+
+	bool HasSse41()
+	{
+		int32 Registers[4];
+		GetCpuId(1, 0, Registers);
+		return (Registers[2] & (1 << 19)) != 0;
+	}
+
+	bool HasAvx2()
+	{
+		int32 Registers[4];
+		GetCpuId(0, 0, Registers);
+		if (Registers[0] < 7)
+		{
+			return false;
+		}
+
+		// AVX2 also needs the OS to save the YMM registers, which OSXSAVE and XCR0 tell
+		GetCpuId(1, 0, Registers);
+		const bool bOsSavesYmm = (Registers[2] & (1 << 27)) != 0 && (Registers[2] & (1 << 28)) != 0;
+		if (!bOsSavesYmm)
+		{
+			return false;
+		}
+#if defined(_MSC_VER) && !defined(__clang__)
+		const uint64 Xcr0 = _xgetbv(0);
+#else
+		uint32 Xcr0Low = 0;
+		uint32 Xcr0High = 0;
+		__asm__ volatile("xgetbv" : "=a"(Xcr0Low), "=d"(Xcr0High) : "c"(0));
+		const uint64 Xcr0 = Xcr0Low;
+#endif
+		if ((Xcr0 & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		GetCpuId(7, 0, Registers);
+		return (Registers[1] & (1 << 5)) != 0;
+	}
+
+	/** Interleaves 16 blue, green and red bytes with opaque alpha and stores the 16 BGRA pixels. */
+	DOLBYIODEBUG_TARGET_SSE41 FORCEINLINE void StoreBGRA(__m128i B, __m128i G, __m128i R, uint8* Dst)
+	{
+		const __m128i A = _mm_set1_epi8(static_cast<char>(0xFF));
+		const __m128i BGLow = _mm_unpacklo_epi8(B, G);
+		const __m128i BGHigh = _mm_unpackhi_epi8(B, G);
+		const __m128i RALow = _mm_unpacklo_epi8(R, A);
+		const __m128i RAHigh = _mm_unpackhi_epi8(R, A);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst), _mm_unpacklo_epi16(BGLow, RALow));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + 16), _mm_unpackhi_epi16(BGLow, RALow));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + 32), _mm_unpacklo_epi16(BGHigh, RAHigh));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + 48), _mm_unpackhi_epi16(BGHigh, RAHigh));
+	}
+
+	/** Y is 8 pixels as int16, U and V the 8 matching chroma samples, already replicated. Returns packed-ready int16 B, G, R. */
+	DOLBYIODEBUG_TARGET_SSE41 FORCEINLINE void ConvertHalfSse41(__m128i Y, __m128i U, __m128i V, __m128i& OutB, __m128i& OutG, __m128i& OutR)
+	{
+		const __m128i YTerm = _mm_add_epi16(_mm_mullo_epi16(_mm_sub_epi16(Y, _mm_set1_epi16(16)), _mm_set1_epi16(CoefY)), _mm_set1_epi16(Round));
+		const __m128i D = _mm_sub_epi16(U, _mm_set1_epi16(128));
+		const __m128i E = _mm_sub_epi16(V, _mm_set1_epi16(128));
+		OutB = _mm_srai_epi16(_mm_adds_epi16(YTerm, _mm_mullo_epi16(D, _mm_set1_epi16(CoefBU))), Shift);
+		OutG = _mm_srai_epi16(
+		    _mm_subs_epi16(_mm_subs_epi16(YTerm, _mm_mullo_epi16(D, _mm_set1_epi16(CoefGU))), _mm_mullo_epi16(E, _mm_set1_epi16(CoefGV))), Shift);
+		OutR = _mm_srai_epi16(_mm_adds_epi16(YTerm, _mm_mullo_epi16(E, _mm_set1_epi16(CoefRV))), Shift);
+	}
+
+	/** Converts 16 pixels: 16 Y bytes and their 8 U and 8 V samples as int16. */
+	DOLBYIODEBUG_TARGET_SSE41 FORCEINLINE void ConvertBlockSse41(__m128i Y, __m128i U, __m128i V, uint8* Dst)
+	{
+		const __m128i Zero = _mm_setzero_si128();
+		__m128i BLow, GLow, RLow, BHigh, GHigh, RHigh;
+		ConvertHalfSse41(_mm_unpacklo_epi8(Y, Zero), _mm_unpacklo_epi16(U, U), _mm_unpacklo_epi16(V, V), BLow, GLow, RLow);
+		ConvertHalfSse41(_mm_unpackhi_epi8(Y, Zero), _mm_unpackhi_epi16(U, U), _mm_unpackhi_epi16(V, V), BHigh, GHigh, RHigh);
+		StoreBGRA(_mm_packus_epi16(BLow, BHigh), _mm_packus_epi16(GLow, GHigh), _mm_packus_epi16(RLow, RHigh), Dst);
+	}
+
+	DOLBYIODEBUG_TARGET_SSE41 void ConvertRowNV12Sse41(const uint8* Y, const uint8* UV, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		const __m128i LowBytes = _mm_set1_epi16(0x00FF);
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			const __m128i Chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UV + X));
+			ConvertBlockSse41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + X)), _mm_and_si128(Chroma, LowBytes),
+			                  _mm_srli_epi16(Chroma, 8), Dst + X * 4);
+		}
+		ConvertRowNV12Scalar(Y, UV, nullptr, Dst, X, End);
+	}
+
+	DOLBYIODEBUG_TARGET_SSE41 void ConvertRowYUY2Sse41(const uint8* Packed, const uint8*, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		const __m128i LowBytes = _mm_set1_epi16(0x00FF);
+		const __m128i LowWords = _mm_set1_epi32(0x0000FFFF);
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			const __m128i First = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Packed + X * 2));
+			const __m128i Second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Packed + X * 2 + 16));
+			const __m128i Y = _mm_packus_epi16(_mm_and_si128(First, LowBytes), _mm_and_si128(Second, LowBytes));
+
+			// The odd bytes hold U V U V..., as int16 they are U in the low and V in the high half of every int32
+			const __m128i FirstChroma = _mm_srli_epi16(First, 8);
+			const __m128i SecondChroma = _mm_srli_epi16(Second, 8);
+			const __m128i U = _mm_packus_epi32(_mm_and_si128(FirstChroma, LowWords), _mm_and_si128(SecondChroma, LowWords));
+			const __m128i V = _mm_packus_epi32(_mm_srli_epi32(FirstChroma, 16), _mm_srli_epi32(SecondChroma, 16));
+			ConvertBlockSse41(Y, U, V, Dst + X * 4);
+		}
+		ConvertRowYUY2Scalar(Packed, nullptr, nullptr, Dst, X, End);
+	}
+
+	DOLBYIODEBUG_TARGET_SSE41 void ConvertRowI420Sse41(const uint8* Y, const uint8* U, const uint8* V, uint8* Dst, int32 Begin, int32 End)
+	{
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			ConvertBlockSse41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + X)),
+			                  _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(U + X / 2))),
+			                  _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(V + X / 2))), Dst + X * 4);
+		}
+		ConvertRowI420Scalar(Y, U, V, Dst, X, End);
+	}
+
+	const FKernel Sse41Kernel = {&ConvertRowNV12Sse41, &ConvertRowYUY2Sse41, &ConvertRowI420Sse41};
+
+	/** Same as ConvertBlockSse41, with the arithmetic on all 16 pixels at once. */
+	DOLBYIODEBUG_TARGET_AVX2 FORCEINLINE void ConvertBlockAvx2(__m128i Y, __m128i U, __m128i V, uint8* Dst)
+	{
+		const __m256i Y16 = _mm256_cvtepu8_epi16(Y);
+		const __m256i U16 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(U, U)), _mm_unpackhi_epi16(U, U), 1);
+		const __m256i V16 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(V, V)), _mm_unpackhi_epi16(V, V), 1);
+
+		const __m256i YTerm = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(Y16, _mm256_set1_epi16(16)), _mm256_set1_epi16(CoefY)),
+		                                       _mm256_set1_epi16(Round));
+		const __m256i D = _mm256_sub_epi16(U16, _mm256_set1_epi16(128));
+		const __m256i E = _mm256_sub_epi16(V16, _mm256_set1_epi16(128));
+		const __m256i B = _mm256_srai_epi16(_mm256_adds_epi16(YTerm, _mm256_mullo_epi16(D, _mm256_set1_epi16(CoefBU))), Shift);
+		const __m256i G = _mm256_srai_epi16(_mm256_subs_epi16(_mm256_subs_epi16(YTerm, _mm256_mullo_epi16(D, _mm256_set1_epi16(CoefGU))),
+		                                                      _mm256_mullo_epi16(E, _mm256_set1_epi16(CoefGV))),
+		                                    Shift);
+		const __m256i R = _mm256_srai_epi16(_mm256_adds_epi16(YTerm, _mm256_mullo_epi16(E, _mm256_set1_epi16(CoefRV))), Shift);
+
+		// Packing across the two lanes keeps the pixels in order
+		StoreBGRA(_mm_packus_epi16(_mm256_castsi256_si128(B), _mm256_extracti128_si256(B, 1)),
+		          _mm_packus_epi16(_mm256_castsi256_si128(G), _mm256_extracti128_si256(G, 1)),
+		          _mm_packus_epi16(_mm256_castsi256_si128(R), _mm256_extracti128_si256(R, 1)), Dst);
+	}
+
+	DOLBYIODEBUG_TARGET_AVX2 void ConvertRowNV12Avx2(const uint8* Y, const uint8* UV, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		const __m128i LowBytes = _mm_set1_epi16(0x00FF);
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			const __m128i Chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UV + X));
+			ConvertBlockAvx2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + X)), _mm_and_si128(Chroma, LowBytes),
+			                 _mm_srli_epi16(Chroma, 8), Dst + X * 4);
+		}
+		ConvertRowNV12Scalar(Y, UV, nullptr, Dst, X, End);
+	}
+
+	DOLBYIODEBUG_TARGET_AVX2 void ConvertRowYUY2Avx2(const uint8* Packed, const uint8*, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		const __m128i LowBytes = _mm_set1_epi16(0x00FF);
+		const __m128i LowWords = _mm_set1_epi32(0x0000FFFF);
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			const __m128i First = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Packed + X * 2));
+			const __m128i Second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Packed + X * 2 + 16));
+			const __m128i Y = _mm_packus_epi16(_mm_and_si128(First, LowBytes), _mm_and_si128(Second, LowBytes));
+			const __m128i FirstChroma = _mm_srli_epi16(First, 8);
+			const __m128i SecondChroma = _mm_srli_epi16(Second, 8);
+			const __m128i U = _mm_packus_epi32(_mm_and_si128(FirstChroma, LowWords), _mm_and_si128(SecondChroma, LowWords));
+			const __m128i V = _mm_packus_epi32(_mm_srli_epi32(FirstChroma, 16), _mm_srli_epi32(SecondChroma, 16));
+			ConvertBlockAvx2(Y, U, V, Dst + X * 4);
+		}
+		ConvertRowYUY2Scalar(Packed, nullptr, nullptr, Dst, X, End);
+	}
+
+	DOLBYIODEBUG_TARGET_AVX2 void ConvertRowI420Avx2(const uint8* Y, const uint8* U, const uint8* V, uint8* Dst, int32 Begin, int32 End)
+	{
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			ConvertBlockAvx2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + X)),
+			                 _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(U + X / 2))),
+			                 _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(V + X / 2))), Dst + X * 4);
+		}
+		ConvertRowI420Scalar(Y, U, V, Dst, X, End);
+	}
+
+	const FKernel Avx2Kernel = {&ConvertRowNV12Avx2, &ConvertRowYUY2Avx2, &ConvertRowI420Avx2};
+#endif
+
+#if DOLBYIODEBUG_WITH_NEON
+	FORCEINLINE void ConvertHalfNeon(int16x8_t Y, int16x8_t U, int16x8_t V, int16x8_t& OutB, int16x8_t& OutG, int16x8_t& OutR)
+	{
+		const int16x8_t YTerm = vaddq_s16(vmulq_n_s16(vsubq_s16(Y, vdupq_n_s16(16)), CoefY), vdupq_n_s16(Round));
+		const int16x8_t D = vsubq_s16(U, vdupq_n_s16(128));
+		const int16x8_t E = vsubq_s16(V, vdupq_n_s16(128));
+		OutB = vshrq_n_s16(vqaddq_s16(YTerm, vmulq_n_s16(D, CoefBU)), Shift);
+		OutG = vshrq_n_s16(vqsubq_s16(vqsubq_s16(YTerm, vmulq_n_s16(D, CoefGU)), vmulq_n_s16(E, CoefGV)), Shift);
+		OutR = vshrq_n_s16(vqaddq_s16(YTerm, vmulq_n_s16(E, CoefRV)), Shift);
+	}
+
+	/** Converts 16 pixels: 16 Y bytes and their 8 U and 8 V samples. */
+	FORCEINLINE void ConvertBlockNeon(uint8x16_t Y, uint8x8_t U, uint8x8_t V, uint8* Dst)
+	{
+		const int16x8x2_t U16 = vzipq_s16(vreinterpretq_s16_u16(vmovl_u8(U)), vreinterpretq_s16_u16(vmovl_u8(U)));
+		const int16x8x2_t V16 = vzipq_s16(vreinterpretq_s16_u16(vmovl_u8(V)), vreinterpretq_s16_u16(vmovl_u8(V)));
+		int16x8_t BLow, GLow, RLow, BHigh, GHigh, RHigh;
+		ConvertHalfNeon(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(Y))), U16.val[0], V16.val[0], BLow, GLow, RLow);
+		ConvertHalfNeon(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(Y))), U16.val[1], V16.val[1], BHigh, GHigh, RHigh);
+
+		uint8x16x4_t BGRA;
+		BGRA.val[0] = vcombine_u8(vqmovun_s16(BLow), vqmovun_s16(BHigh));
+		BGRA.val[1] = vcombine_u8(vqmovun_s16(GLow), vqmovun_s16(GHigh));
+		BGRA.val[2] = vcombine_u8(vqmovun_s16(RLow), vqmovun_s16(RHigh));
+		BGRA.val[3] = vdupq_n_u8(255);
+		vst4q_u8(Dst, BGRA);
+	}
+
+	void ConvertRowNV12Neon(const uint8* Y, const uint8* UV, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			const uint8x8x2_t Chroma = vld2_u8(UV + X);
+			ConvertBlockNeon(vld1q_u8(Y + X), Chroma.val[0], Chroma.val[1], Dst + X * 4);
+		}
+		ConvertRowNV12Scalar(Y, UV, nullptr, Dst, X, End);
+	}
+
+	void ConvertRowYUY2Neon(const uint8* Packed, const uint8*, const uint8*, uint8* Dst, int32 Begin, int32 End)
+	{
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			// Y0 U Y1 V de-interleaved, then the even and odd Y zipped back into pixel order
+			const uint8x8x4_t Pairs = vld4_u8(Packed + X * 2);
+			const uint8x8x2_t Y = vzip_u8(Pairs.val[0], Pairs.val[2]);
+			ConvertBlockNeon(vcombine_u8(Y.val[0], Y.val[1]), Pairs.val[1], Pairs.val[3], Dst + X * 4);
+		}
+		ConvertRowYUY2Scalar(Packed, nullptr, nullptr, Dst, X, End);
+	}
+
+	void ConvertRowI420Neon(const uint8* Y, const uint8* U, const uint8* V, uint8* Dst, int32 Begin, int32 End)
+	{
+		int32 X = Begin;
+		for (; X + BlockWidth <= End; X += BlockWidth)
+		{
+			ConvertBlockNeon(vld1q_u8(Y + X), vld1_u8(U + X / 2), vld1_u8(V + X / 2), Dst + X * 4);
+		}
+		ConvertRowI420Scalar(Y, U, V, Dst, X, End);
+	}
+
+	const FKernel NeonKernel = {&ConvertRowNV12Neon, &ConvertRowYUY2Neon, &ConvertRowI420Neon};
+#endif
+
+	const FKernel* GetKernel(EDolbyIODebugConversionKernel Kernel)
+	{
+		switch (Kernel)
+		{
+#if PLATFORM_CPU_X86_FAMILY
+			case EDolbyIODebugConversionKernel::SSE41:
+				return &Sse41Kernel;
+			case EDolbyIODebugConversionKernel::AVX2:
+				return &Avx2Kernel;
+#endif
+#if DOLBYIODEBUG_WITH_NEON
+			case EDolbyIODebugConversionKernel::NEON:
+				return &NeonKernel;
+#endif
+			default:
+				return &ScalarKernel;
+		}
+	}
+
+	/** Planes of a random test frame, all tightly packed. */
+	struct FTestFrame
+	{
+		TArray<uint8> Planes[3];
+		FDolbyIODebugVideoFrame Frame;
+	};
+
+	void MakeTestFrame(EDolbyIODebugPixelFormat Format, int32 Width, int32 Height, FTestFrame& OutTestFrame)
+	{
+		FRandomStream Random(Width * 31 + Height);
+		const int32 ChromaStride = Format == EDolbyIODebugPixelFormat::NV12 ? Width : Width / 2;
+		const int32 Sizes[3] = {(Format == EDolbyIODebugPixelFormat::YUY2 ? Width * 2 : Width) * Height,
+		                        Format == EDolbyIODebugPixelFormat::YUY2 ? 0 : ChromaStride * (Height / 2),
+		                        Format == EDolbyIODebugPixelFormat::I420 ? ChromaStride * (Height / 2) : 0};
+		for (int32 Plane = 0; Plane < 3; ++Plane)
+		{
+			OutTestFrame.Planes[Plane].SetNumUninitialized(Sizes[Plane]);
+			for (uint8& Value : OutTestFrame.Planes[Plane])
+			{
+				Value = static_cast<uint8>(Random.RandHelper(256));
+			}
+		}
+
+		FDolbyIODebugVideoFrame& Frame = OutTestFrame.Frame;
+		Frame.Width = Width;
+		Frame.Height = Height;
+		Frame.Format = Format;
+		Frame.Data = OutTestFrame.Planes[0].GetData();
+		Frame.Stride = Format == EDolbyIODebugPixelFormat::YUY2 ? Width * 2 : Width;
+		Frame.ChromaData[0] = OutTestFrame.Planes[1].GetData();
+		Frame.ChromaData[1] = OutTestFrame.Planes[2].GetData();
+		Frame.ChromaStride = Format == EDolbyIODebugPixelFormat::YUY2 ? 0 : ChromaStride;
+	}
+
+	/** Uploads the planes of a test frame and times the compute conversion, in milliseconds per frame. Render thread only. */
+	double TimeGpuConversion(FRHICommandListImmediate& RHICmdList, const FTestFrame& TestFrame, int32 Iterations)
+	{
+		const FDolbyIODebugVideoFrame& Frame = TestFrame.Frame;
+		const FIntPoint ChromaSize(Frame.Width / 2, Frame.Height / 2);
+
+		EDolbyIODebugYuvLayout Layout = EDolbyIODebugYuvLayout::I420;
+		FIntPoint PlaneSizes[3] = {{Frame.Width, Frame.Height}, ChromaSize, ChromaSize};
+		EPixelFormat PlaneFormats[3] = {PF_G8, PF_G8, PF_G8};
+		int32 BytesPerTexel[3] = {1, 1, 1};
+		if (Frame.Format == EDolbyIODebugPixelFormat::NV12)
+		{
+			Layout = EDolbyIODebugYuvLayout::NV12;
+			PlaneFormats[1] = PF_R8G8;
+			BytesPerTexel[1] = 2;
+		}
+		else if (Frame.Format == EDolbyIODebugPixelFormat::YUY2)
+		{
+			Layout = EDolbyIODebugYuvLayout::YUY2;
+			PlaneSizes[0] = {Frame.Width / 2, Frame.Height};
+			PlaneFormats[0] = PF_R8G8B8A8;
+			BytesPerTexel[0] = 4;
+		}
+
+		TRefCountPtr<IPooledRenderTarget> PlaneTargets[3];
+		for (int32 Plane = 0; Plane < 3; ++Plane)
+		{
+			if (TestFrame.Planes[Plane].Num() == 0)
+			{
+				continue;
+			}
+			FTextureRHIRef Texture = RHICreateTexture(FRHITextureCreateDesc::Create2D(TEXT("DolbyIODebugBenchmarkPlane"), PlaneSizes[Plane],
+			                                                                          PlaneFormats[Plane])
+			                                              .SetFlags(ETextureCreateFlags::ShaderResource));
+			RHIUpdateTexture2D(Texture, 0, FUpdateTextureRegion2D(0, 0, 0, 0, PlaneSizes[Plane].X, PlaneSizes[Plane].Y),
+			                   PlaneSizes[Plane].X * BytesPerTexel[Plane], TestFrame.Planes[Plane].GetData());
+			PlaneTargets[Plane] = CreateRenderTarget(Texture, TEXT("DolbyIODebugBenchmarkPlane"));
+		}
+
+		FRenderQueryRHIRef BeginQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+		FRenderQueryRHIRef EndQuery = RHICreateRenderQuery(RQT_AbsoluteTime);
+		RHICmdList.EndRenderQuery(BeginQuery);
+		{
+			FRDGBuilder GraphBuilder(RHICmdList);
+			FRDGTextureRef Planes[3] = {};
+			for (int32 Plane = 0; Plane < 3; ++Plane)
+			{
+				Planes[Plane] = PlaneTargets[Plane] ? GraphBuilder.RegisterExternalTexture(PlaneTargets[Plane]) : nullptr;
+			}
+			FRDGTextureRef Output = GraphBuilder.CreateTexture(
+			    FRDGTextureDesc::Create2D({Frame.Width, Frame.Height}, PF_R8G8B8A8, FClearValueBinding::None,
+			                              TexCreate_ShaderResource | TexCreate_UAV),
+			    TEXT("DolbyIODebugBenchmarkOutput"));
+			for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+			{
+				AddYuvToRgbaPass(GraphBuilder, Layout, {Frame.Width, Frame.Height}, Planes[0], Planes[1], Planes[2], Output);
+			}
+			GraphBuilder.Execute();
+		}
+		RHICmdList.EndRenderQuery(EndQuery);
+		RHICmdList.SubmitCommandsAndFlushGPU();
+
+		// Absolute time queries are in microseconds
+		uint64 BeginTime = 0;
+		uint64 EndTime = 0;
+		if (!RHIGetRenderQueryResult(BeginQuery, BeginTime, true) || !RHIGetRenderQueryResult(EndQuery, EndTime, true))
+		{
+			return -1.0;
+		}
+		return static_cast<double>(EndTime - BeginTime) / 1000.0 / Iterations;
+	}
+
+	void RunBenchmark(const TArray<FString>& Args)
+	{
+		const int32 Width = Args.IsValidIndex(0) ? FMath::Max(FCString::Atoi(*Args[0]) & ~1, 2) : 1920;
+		const int32 Height = Args.IsValidIndex(1) ? FMath::Max(FCString::Atoi(*Args[1]) & ~1, 2) : 1080;
+		const int32 Iterations = Args.IsValidIndex(2) ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 100;
+		UE_LOG(LogDolbyIODebug, Display, TEXT("Colour conversion benchmark, %dx%d, %d iterations, active kernel %s"), Width, Height,
+		       Iterations, FDolbyIODebugColorConversion::GetKernelName(FDolbyIODebugColorConversion::GetActiveKernel()));
+
+		const int32 DstStride = Width * 4;
+		TArray<uint8> Reference;
+		TArray<uint8> Converted;
+		Reference.SetNumUninitialized(DstStride * Height);
+		Converted.SetNumUninitialized(DstStride * Height);
+
+		for (EDolbyIODebugPixelFormat Format : {EDolbyIODebugPixelFormat::NV12, EDolbyIODebugPixelFormat::YUY2, EDolbyIODebugPixelFormat::I420})
+		{
+			const TCHAR* FormatName = Format == EDolbyIODebugPixelFormat::NV12 ? TEXT("NV12")
+			                          : Format == EDolbyIODebugPixelFormat::YUY2 ? TEXT("YUY2")
+			                                                                    : TEXT("I420");
+			TSharedRef<FTestFrame> TestFrame = MakeShared<FTestFrame>();
+			MakeTestFrame(Format, Width, Height, *TestFrame);
+			FDolbyIODebugColorConversion::ConvertToBGRA(TestFrame->Frame, Reference.GetData(), DstStride, EDolbyIODebugConversionKernel::Scalar);
+
+			for (int32 Index = 0; Index < static_cast<int32>(EDolbyIODebugConversionKernel::Count); ++Index)
+			{
+				const EDolbyIODebugConversionKernel Kernel = static_cast<EDolbyIODebugConversionKernel>(Index);
+				if (!FDolbyIODebugColorConversion::IsSupported(Kernel))
+				{
+					continue;
+				}
+
+				const double StartTime = FPlatformTime::Seconds();
+				for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+				{
+					FDolbyIODebugColorConversion::ConvertToBGRA(TestFrame->Frame, Converted.GetData(), DstStride, Kernel);
+				}
+				const double TimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / Iterations;
+				const bool bMatches = FMemory::Memcmp(Reference.GetData(), Converted.GetData(), Reference.Num()) == 0;
+				UE_LOG(LogDolbyIODebug, Display, TEXT("  %s %-6s %8.3f ms  %7.1f Mpixel/s%s"), FormatName,
+				       FDolbyIODebugColorConversion::GetKernelName(Kernel), TimeMs, Width * Height / (TimeMs * 1000.0),
+				       bMatches ? TEXT("") : TEXT("  MISMATCH"));
+			}
+
+			if (!FApp::CanEverRender())
+			{
+				continue;
+			}
+			ENQUEUE_RENDER_COMMAND(DolbyIODebugConversionBenchmark)
+			([TestFrame, FormatName, Iterations, Width, Height](FRHICommandListImmediate& RHICmdList)
+			 {
+				 const double TimeMs = TimeGpuConversion(RHICmdList, *TestFrame, Iterations);
+				 UE_LOG(LogDolbyIODebug, Display, TEXT("  %s %-6s %8.3f ms  %7.1f Mpixel/s, without the upload"), FormatName, TEXT("GPU"),
+				        TimeMs, TimeMs > 0.0 ? Width * Height / (TimeMs * 1000.0) : 0.0);
+			 });
+			FlushRenderingCommands();
+		}
+	}
+
+	FAutoConsoleCommand CmdBenchmark(TEXT("DolbyIODebug.Conversion.Benchmark"),
+	                                 TEXT("Times every colour conversion kernel, and the compute pass to compare: [Width Height Iterations]."),
+	                                 FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+
+	EDolbyIODebugConversionKernel DetectBestKernel()
+	{
+		for (EDolbyIODebugConversionKernel Kernel :
+		     {EDolbyIODebugConversionKernel::AVX2, EDolbyIODebugConversionKernel::SSE41, EDolbyIODebugConversionKernel::NEON})
+		{
+			if (FDolbyIODebugColorConversion::IsSupported(Kernel))
+			{
+				return Kernel;
+			}
+		}
+		return EDolbyIODebugConversionKernel::Scalar;
+	}
+
+	/** The kernel frames are converted with, resolved whenever KernelOverride changes so that frames never read the string. */
+	std::atomic<EDolbyIODebugConversionKernel> ActiveKernel{DetectBestKernel()};
+
+	FString KernelOverride;
+
+	void HandleKernelOverrideChanged(IConsoleVariable* Variable)
+	{
+		EDolbyIODebugConversionKernel Kernel = DetectBestKernel();
+		if (!KernelOverride.IsEmpty())
+		{
+			bool bForced = false;
+			for (int32 Index = 0; Index < static_cast<int32>(EDolbyIODebugConversionKernel::Count); ++Index)
+			{
+				const EDolbyIODebugConversionKernel Candidate = static_cast<EDolbyIODebugConversionKernel>(Index);
+				if (KernelOverride.Equals(FDolbyIODebugColorConversion::GetKernelName(Candidate), ESearchCase::IgnoreCase) &&
+				    FDolbyIODebugColorConversion::IsSupported(Candidate))
+				{
+					Kernel = Candidate;
+					bForced = true;
+					break;
+				}
+			}
+			if (!bForced)
+			{
+				UE_LOG(LogDolbyIODebug, Warning, TEXT("Colour conversion kernel %s is unknown or unsupported, using %s"), *KernelOverride,
+				       FDolbyIODebugColorConversion::GetKernelName(Kernel));
+			}
+		}
+		ActiveKernel.store(Kernel, std::memory_order_relaxed);
+	}
+
+	FAutoConsoleVariableRef CVarKernel(TEXT("DolbyIODebug.Conversion.Kernel"), KernelOverride,
+	                                   TEXT("Forces the colour conversion kernel: scalar, sse41, avx2 or neon. Empty picks the fastest."),
+	                                   FConsoleVariableDelegate::CreateStatic(&HandleKernelOverrideChanged));
+}
+
+void FDolbyIODebugColorConversion::ConvertToBGRA(const FDolbyIODebugVideoFrame& Frame, uint8* Dst, int32 DstStride)
+{
+	ConvertToBGRA(Frame, Dst, DstStride, GetActiveKernel());
+}
+
+void FDolbyIODebugColorConversion::ConvertToBGRA(const FDolbyIODebugVideoFrame& Frame, uint8* Dst, int32 DstStride,
+                                                 EDolbyIODebugConversionKernel Kernel)
+{
+	using namespace DolbyIODebugColorConversion;
+
+	const FKernel& RowKernel = *GetKernel(IsSupported(Kernel) ? Kernel : EDolbyIODebugConversionKernel::Scalar);
+	for (int32 Row = 0; Row < Frame.Height; ++Row)
+	{
+		const uint8* Src = Frame.Data + static_cast<int64>(Row) * Frame.Stride;
+		const int64 ChromaOffset = static_cast<int64>(Row / 2) * Frame.ChromaStride;
+		uint8* DstRow = Dst + static_cast<int64>(Row) * DstStride;
+		switch (Frame.Format)
+		{
+			case EDolbyIODebugPixelFormat::NV12:
+				RowKernel.NV12(Src, Frame.ChromaData[0] + ChromaOffset, nullptr, DstRow, 0, Frame.Width);
+				break;
+			case EDolbyIODebugPixelFormat::YUY2:
+				RowKernel.YUY2(Src, nullptr, nullptr, DstRow, 0, Frame.Width);
+				break;
+			case EDolbyIODebugPixelFormat::I420:
+				RowKernel.I420(Src, Frame.ChromaData[0] + ChromaOffset, Frame.ChromaData[1] + ChromaOffset, DstRow, 0, Frame.Width);
+				break;
+			default:
+				FMemory::Memcpy(DstRow, Src, static_cast<int64>(Frame.Width) * 4);
+				break;
+		}
+	}
+}
+
+bool FDolbyIODebugColorConversion::IsSupported(EDolbyIODebugConversionKernel Kernel)
+{
+	switch (Kernel)
+	{
+		case EDolbyIODebugConversionKernel::Scalar:
+			return true;
+#if PLATFORM_CPU_X86_FAMILY
+		case EDolbyIODebugConversionKernel::SSE41:
+		{
+			static const bool bHasSse41 = DolbyIODebugColorConversion::HasSse41();
+			return bHasSse41;
+		}
+		case EDolbyIODebugConversionKernel::AVX2:
+		{
+			static const bool bHasAvx2 = DolbyIODebugColorConversion::HasSse41() && DolbyIODebugColorConversion::HasAvx2();
+			return bHasAvx2;
+		}
+#endif
+#if DOLBYIODEBUG_WITH_NEON
+		case EDolbyIODebugConversionKernel::NEON:
+			return true;
+#endif
+		default:
+			return false;
+	}
+}
+
+EDolbyIODebugConversionKernel FDolbyIODebugColorConversion::GetActiveKernel()
+{
+	return DolbyIODebugColorConversion::ActiveKernel.load(std::memory_order_relaxed);
+}
+
+const TCHAR* FDolbyIODebugColorConversion::GetKernelName(EDolbyIODebugConversionKernel Kernel)
+{
+	switch (Kernel)
+	{
+		case EDolbyIODebugConversionKernel::Scalar:
+			return TEXT("Scalar");
+		case EDolbyIODebugConversionKernel::SSE41:
+			return TEXT("SSE41");
+		case EDolbyIODebugConversionKernel::AVX2:
+			return TEXT("AVX2");
+		case EDolbyIODebugConversionKernel::NEON:
+			return TEXT("NEON");
+		default:
+			return TEXT("Unknown");
+	}
+}
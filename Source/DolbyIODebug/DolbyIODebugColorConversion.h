@@ -0,0 +1,41 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FDolbyIODebugVideoFrame;
+
+enum class EDolbyIODebugConversionKernel : uint8
+{
+	Scalar,
+	SSE41,
+	AVX2,
+	NEON,
+
+	Count
+};
+
+/**
+ * Converts NV12, YUY2 and I420 frames to BGRA8 on the CPU, with BT.601 limited range coefficients.
+ *
+ * Every kernel computes in 16-bit fixed point with the same coefficients, so all of them produce exactly the same
+ * pixels as the scalar one. The fastest kernel the CPU supports is used unless DolbyIODebug.Conversion.Kernel forces
+ * one; the variable is resolved when it is set, so converting a frame only reads the resolved kernel. Chroma is
+ * upsampled by replicating each sample.
+ *
+ * The compute pass of DolbyIODebugShaders is not one of the kernels: the preview sink stages frames from the CPU, so
+ * a conversion on the GPU would add an upload per plane and a copy from its linear target into the ring texture.
+ * DolbyIODebug.Conversion.Benchmark times it next to the CPU kernels, for comparison only.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugColorConversion
+{
+public:
+	/** Converts with the active kernel. Dst must hold Frame.Height rows of DstStride bytes. */
+	static void ConvertToBGRA(const FDolbyIODebugVideoFrame& Frame, uint8* Dst, int32 DstStride);
+	static void ConvertToBGRA(const FDolbyIODebugVideoFrame& Frame, uint8* Dst, int32 DstStride, EDolbyIODebugConversionKernel Kernel);
+
+	static bool IsSupported(EDolbyIODebugConversionKernel Kernel);
+	static EDolbyIODebugConversionKernel GetActiveKernel();
+	static const TCHAR* GetKernelName(EDolbyIODebugConversionKernel Kernel);
+};
@@ -0,0 +1,570 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugDeviceCyclerComponent.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugDeviceRegistry.h"
+#include "DolbyIODebugEncoderProbe.h"
+#include "DolbyIODebugSendLayer.h"
+#include "DolbyIODebugSession.h"
+#include "DolbyIODebugStartupProfiler.h"
+#include "DolbyIODebugSyntheticVideo.h"
+#include "DolbyIODebugVideoEvents.h"
+#include "DolbyIODebugVideoSwitcher.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/Texture2D.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "TimerManager.h"
+
+namespace DolbyIODebugDeviceCycler
+{
+	/** How often a device held while the send layer is Off checks whether it can be activated. */
+	constexpr float HeldDeviceRetryInterval = 1.0f;
+}
+
+UDolbyIODebugDeviceCyclerComponent::UDolbyIODebugDeviceCyclerComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void UDolbyIODebugDeviceCyclerComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this))
+	{
+		DevicesChangedHandle = DeviceRegistry->OnDevicesChangedNative.AddUObject(this, &UDolbyIODebugDeviceCyclerComponent::HandleDevicesChanged);
+	}
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugDeviceCyclerComponent::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugDeviceCyclerComponent::HandleVideoDisabled);
+	}
+
+	if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		SyntheticVideo->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugDeviceCyclerComponent::HandleVideoEnabled);
+		SyntheticVideo->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugDeviceCyclerComponent::HandleVideoDisabled);
+	}
+
+	int32 CommandLineBenchmarkCycles = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("DolbyIOSwitchBenchmark="), CommandLineBenchmarkCycles) && CommandLineBenchmarkCycles > 0)
+	{
+		bBenchmarkMode = true;
+		BenchmarkCycles = CommandLineBenchmarkCycles;
+	}
+
+	if (bAutoStart || bBenchmarkMode)
+	{
+		StartCycling();
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leave the video live for the cycler of the next map, which resumes from the device the session remembers
+	if (EndPlayReason == EEndPlayReason::LevelTransition && bVideoEnabled && DolbyIODebug::GetSubsystem<UDolbyIODebugSession>(this))
+	{
+		bVideoEnabled = false;
+	}
+	StopCycling();
+
+	if (UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this))
+	{
+		DeviceRegistry->OnDevicesChangedNative.Remove(DevicesChangedHandle);
+	}
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		SyntheticVideo->OnVideoEnabledNative.RemoveAll(this);
+		SyntheticVideo->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDolbyIODebugDeviceCyclerComponent::StartCycling()
+{
+	if (bCycling)
+	{
+		return;
+	}
+
+	UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (!DeviceRegistry || !DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Cannot start device cycling: Dolby.io subsystem is not available"));
+		return;
+	}
+
+	bCycling = true;
+	if (bBenchmarkMode)
+	{
+		Benchmark.Reset(BenchmarkCycles);
+	}
+
+	// The synthetic devices are there before the SDK enumerated, and the real ones join the cycle when it answers
+	if (!DeviceRegistry->HasEnumerated())
+	{
+		DeviceRegistry->Refresh();
+	}
+
+	if (ResumeLiveDevice())
+	{
+		return;
+	}
+
+	const int32 FirstDeviceIndex = GetNextCycledIndex(INDEX_NONE);
+	if (FirstDeviceIndex == INDEX_NONE)
+	{
+		bAwaitingDevices = true;
+		return;
+	}
+
+	ActivateDevice(FirstDeviceIndex);
+}
+
+void UDolbyIODebugDeviceCyclerComponent::StopCycling()
+{
+	if (!bCycling)
+	{
+		return;
+	}
+
+	bCycling = false;
+	bAwaitingDevices = false;
+	PendingDeviceIndex = INDEX_NONE;
+	HeldDeviceIndex = INDEX_NONE;
+	ClearDwellTimer();
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(FirstFrameTimerHandle);
+	}
+
+	if (bVideoEnabled)
+	{
+		DeactivateCurrentDevice();
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::HandleDevicesChanged()
+{
+	if (!bAwaitingDevices)
+	{
+		return;
+	}
+
+	const int32 FirstDeviceIndex = GetNextCycledIndex(INDEX_NONE);
+	if (FirstDeviceIndex == INDEX_NONE)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("No video devices to cycle through, waiting for one to be plugged in"));
+		return;
+	}
+
+	bAwaitingDevices = false;
+	ActivateDevice(FirstDeviceIndex);
+}
+
+void UDolbyIODebugDeviceCyclerComponent::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (!bCycling || !DeviceRegistry)
+	{
+		return;
+	}
+
+	// The send layer switched the video back on to the device it had switched off, which the cycle resumes from
+	if (HeldDeviceIndex != INDEX_NONE)
+	{
+		HeldDeviceIndex = INDEX_NONE;
+		ClearDwellTimer();
+	}
+
+	if (PendingDeviceIndex != INDEX_NONE)
+	{
+		// When handing over, the previous device goes away with this event rather than with OnVideoDisabled
+		if (bVideoEnabled && DeviceRegistry->IsValidIndex(CurrentDeviceIndex) && CurrentDeviceIndex != PendingDeviceIndex)
+		{
+			BroadcastDeviceDeactivated(CurrentDeviceIndex);
+		}
+		CurrentDeviceIndex = PendingDeviceIndex;
+		PendingDeviceIndex = INDEX_NONE;
+	}
+
+	if (!DeviceRegistry->IsValidIndex(CurrentDeviceIndex))
+	{
+		return;
+	}
+
+	bVideoEnabled = true;
+	UDolbyIODebugVideoEvents::AssignID(ActiveVideoTrackID, VideoTrackID);
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::VideoEnabled);
+	if (UDolbyIODebugSession* Session = DolbyIODebug::GetSubsystem<UDolbyIODebugSession>(this))
+	{
+		Session->SetLiveVideoDeviceIndex(CurrentDeviceIndex);
+	}
+	BroadcastDeviceActivated(CurrentDeviceIndex);
+	ScheduleDwell();
+}
+
+void UDolbyIODebugDeviceCyclerComponent::BroadcastDeviceActivated(int32 DeviceIndex)
+{
+	const FDolbyIOVideoDevice& VideoDevice = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this)->GetDevice(DeviceIndex);
+	OnDeviceActivatedNative.Broadcast(VideoDevice, DeviceIndex);
+	if (OnDeviceActivated.IsBound())
+	{
+		OnDeviceActivated.Broadcast(VideoDevice, DeviceIndex);
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::BroadcastDeviceDeactivated(int32 DeviceIndex)
+{
+	const FDolbyIOVideoDevice& VideoDevice = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this)->GetDevice(DeviceIndex);
+	OnDeviceDeactivatedNative.Broadcast(VideoDevice, DeviceIndex);
+	if (OnDeviceDeactivated.IsBound())
+	{
+		OnDeviceDeactivated.Broadcast(VideoDevice, DeviceIndex);
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::ScheduleDwell()
+{
+	if (UWorld* World = GetWorld())
+	{
+		if (bBenchmarkMode)
+		{
+			Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::VideoEnabled);
+		}
+		if (bBenchmarkMode || !FDolbyIODebugStartupProfiler::Get().IsComplete())
+		{
+			FirstFrameTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &UDolbyIODebugDeviceCyclerComponent::PollFirstFrame);
+		}
+
+		if (bPrewarmNextDevice)
+		{
+			World->GetTimerManager().SetTimer(DwellTimerHandle, this, &UDolbyIODebugDeviceCyclerComponent::HandOverToNextDevice,
+			                                  FMath::Max(DwellTime - GetPrewarmLeadTime(), KINDA_SMALL_NUMBER), false);
+		}
+		else
+		{
+			World->GetTimerManager().SetTimer(DwellTimerHandle, this, &UDolbyIODebugDeviceCyclerComponent::DeactivateCurrentDevice,
+			                                  DwellTime, false);
+		}
+	}
+}
+
+bool UDolbyIODebugDeviceCyclerComponent::ResumeLiveDevice()
+{
+	const UDolbyIODebugSession* Session = DolbyIODebug::GetSubsystem<UDolbyIODebugSession>(this);
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (!Session || Session->GetLiveVideoTrackID().IsEmpty())
+	{
+		return false;
+	}
+
+	const int32 DeviceIndex = Session->GetLiveVideoDeviceIndex();
+	if (!DeviceRegistry->IsPresent(DeviceIndex))
+	{
+		return false;
+	}
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Resuming from video device %d, live since the previous map"), DeviceIndex);
+	CurrentDeviceIndex = DeviceIndex;
+	bVideoEnabled = true;
+	ActiveVideoTrackID = Session->GetLiveVideoTrackID();
+	BroadcastDeviceActivated(CurrentDeviceIndex);
+	ScheduleDwell();
+	return true;
+}
+
+void UDolbyIODebugDeviceCyclerComponent::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	if (!bVideoEnabled)
+	{
+		return;
+	}
+
+	bVideoEnabled = false;
+	ActiveVideoTrackID.Reset();
+	if (bBenchmarkMode)
+	{
+		Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::VideoDisabled);
+	}
+
+	UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (DeviceRegistry && DeviceRegistry->IsValidIndex(CurrentDeviceIndex))
+	{
+		BroadcastDeviceDeactivated(CurrentDeviceIndex);
+	}
+
+	if (!bCycling || !DeviceRegistry)
+	{
+		CurrentDeviceIndex = INDEX_NONE;
+		return;
+	}
+
+	const int32 NextDeviceIndex = AdvanceDeviceIndex();
+	if (NextDeviceIndex == INDEX_NONE)
+	{
+		CurrentDeviceIndex = INDEX_NONE;
+		return;
+	}
+
+	ActivateDevice(NextDeviceIndex);
+}
+
+void UDolbyIODebugDeviceCyclerComponent::ActivateDevice(int32 DeviceIndex)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DolbyIODebugActivateDevice, DolbyIODebugChannel);
+	UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+	UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (!DolbyIOSubsystem || !DeviceRegistry || !DeviceRegistry->IsPresent(DeviceIndex))
+	{
+		bCycling = false;
+		return;
+	}
+
+	if (IsSendLayerOff())
+	{
+		UE_LOG(LogDolbyIODebug, Log, TEXT("Holding video device %d while the send layer is off"), DeviceIndex);
+		HeldDeviceIndex = DeviceIndex;
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().SetTimer(DwellTimerHandle, this, &UDolbyIODebugDeviceCyclerComponent::ActivateHeldDevice,
+			                                  DolbyIODebugDeviceCycler::HeldDeviceRetryInterval, true);
+		}
+		return;
+	}
+
+	const FDolbyIOVideoDevice& VideoDevice = DeviceRegistry->GetDevice(DeviceIndex);
+	PendingDeviceIndex = DeviceIndex;
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Previewing video device %d: %s"), DeviceIndex, *VideoDevice.DisplayName);
+
+	if (bBenchmarkMode)
+	{
+		if (!Benchmark.HasOpenSample())
+		{
+			Benchmark.BeginSample();
+		}
+		Benchmark.SetSampleDevice(VideoDevice);
+		Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::EnableRequested);
+	}
+
+	if (UDolbyIODebugSyntheticVideo::IsSynthetic(VideoDevice))
+	{
+		if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+		{
+			SyntheticVideo->EnableVideo(VideoDevice);
+		}
+		return;
+	}
+	if (UDolbyIODebugEncoderProbe* EncoderProbe = DolbyIODebug::GetSubsystem<UDolbyIODebugEncoderProbe>(this))
+	{
+		EncoderProbe->NotifyEnableRequested(VideoDevice);
+	}
+	DolbyIOSubsystem->EnableVideo(VideoDevice);
+}
+
+bool UDolbyIODebugDeviceCyclerComponent::IsSendLayerOff() const
+{
+	const UDolbyIODebugSendLayerController* SendLayer = DolbyIODebug::GetSubsystem<UDolbyIODebugSendLayerController>(this);
+	return SendLayer && SendLayer->GetLayer() == EDolbyIODebugSendLayer::Off;
+}
+
+void UDolbyIODebugDeviceCyclerComponent::ActivateHeldDevice()
+{
+	// The controller switches the video back on itself when it had switched it off, which must not be raced
+	const UDolbyIODebugVideoSwitcher* VideoSwitcher = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoSwitcher>(this);
+	if (!bCycling || HeldDeviceIndex == INDEX_NONE || IsSendLayerOff() || (VideoSwitcher && VideoSwitcher->IsSwitching()))
+	{
+		return;
+	}
+
+	ClearDwellTimer();
+	const int32 DeviceIndex = HeldDeviceIndex;
+	HeldDeviceIndex = INDEX_NONE;
+	ActivateDevice(DeviceIndex);
+}
+
+void UDolbyIODebugDeviceCyclerComponent::DeactivateCurrentDevice()
+{
+	ClearDwellTimer();
+	if (bBenchmarkMode && bCycling)
+	{
+		Benchmark.BeginSample();
+		Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::DisableRequested);
+	}
+
+	if (IsSyntheticDevice(CurrentDeviceIndex))
+	{
+		if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+		{
+			SyntheticVideo->DisableVideo();
+		}
+	}
+	else if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->DisableVideo();
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::HandOverToNextDevice()
+{
+	ClearDwellTimer();
+	if (!bCycling)
+	{
+		return;
+	}
+
+	// Synthetic devices do not go through the SDK, so the SDK cannot hand over between them and real devices
+	int32 PeekDeviceIndex = GetNextCycledIndex(CurrentDeviceIndex);
+	if (PeekDeviceIndex == INDEX_NONE && ShouldLoop())
+	{
+		PeekDeviceIndex = GetNextCycledIndex(INDEX_NONE);
+	}
+	if (PeekDeviceIndex != INDEX_NONE && IsSyntheticDevice(PeekDeviceIndex) != IsSyntheticDevice(CurrentDeviceIndex))
+	{
+		DeactivateCurrentDevice();
+		return;
+	}
+
+	const int32 NextDeviceIndex = AdvanceDeviceIndex();
+	if (NextDeviceIndex == INDEX_NONE)
+	{
+		DeactivateCurrentDevice();
+		return;
+	}
+
+	if (NextDeviceIndex == CurrentDeviceIndex)
+	{
+		// Only one device left, keep it live for another dwell instead of re-opening it
+		GetWorld()->GetTimerManager().SetTimer(DwellTimerHandle, this, &UDolbyIODebugDeviceCyclerComponent::HandOverToNextDevice,
+		                                       DwellTime, false);
+		return;
+	}
+
+	// The benchmark sample of a handover has no disable phases, the new device is opened while the old one is live
+	if (bBenchmarkMode)
+	{
+		Benchmark.BeginSample();
+	}
+	ActivateDevice(NextDeviceIndex);
+}
+
+int32 UDolbyIODebugDeviceCyclerComponent::AdvanceDeviceIndex()
+{
+	int32 NextDeviceIndex = GetNextCycledIndex(CurrentDeviceIndex);
+	if (NextDeviceIndex == INDEX_NONE)
+	{
+		OnCycleCompleted.Broadcast();
+		NextDeviceIndex = ShouldLoop() ? GetNextCycledIndex(INDEX_NONE) : INDEX_NONE;
+		if (NextDeviceIndex == INDEX_NONE)
+		{
+			bCycling = false;
+			if (bBenchmarkMode)
+			{
+				// Every device is gone, write what was recorded rather than waiting for switches that will not come
+				FinishBenchmark();
+			}
+		}
+	}
+	return NextDeviceIndex;
+}
+
+int32 UDolbyIODebugDeviceCyclerComponent::GetNextCycledIndex(int32 DeviceIndex) const
+{
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	const UDolbyIODebugEncoderProbe* EncoderProbe = DolbyIODebug::GetSubsystem<UDolbyIODebugEncoderProbe>(this);
+	int32 NextDeviceIndex = DeviceRegistry->GetNextPresentIndex(DeviceIndex);
+	while (NextDeviceIndex != INDEX_NONE && EncoderProbe && EncoderProbe->ShouldSkip(DeviceRegistry->GetDevice(NextDeviceIndex)))
+	{
+		NextDeviceIndex = DeviceRegistry->GetNextPresentIndex(NextDeviceIndex);
+	}
+	return NextDeviceIndex;
+}
+
+float UDolbyIODebugDeviceCyclerComponent::GetPrewarmLeadTime() const
+{
+	// A device that enabled before only needs to be opened as far ahead as it took
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	const UDolbyIODebugEncoderProbe* EncoderProbe = DolbyIODebug::GetSubsystem<UDolbyIODebugEncoderProbe>(this);
+	int32 NextDeviceIndex = GetNextCycledIndex(CurrentDeviceIndex);
+	if (NextDeviceIndex == INDEX_NONE && ShouldLoop())
+	{
+		NextDeviceIndex = GetNextCycledIndex(INDEX_NONE);
+	}
+	const float ExpectedEnableTime = EncoderProbe && NextDeviceIndex != INDEX_NONE
+	                                     ? EncoderProbe->GetExpectedEnableTime(DeviceRegistry->GetDevice(NextDeviceIndex))
+	                                     : 0.0f;
+	return ExpectedEnableTime > 0.0f ? ExpectedEnableTime : PrewarmLeadTime;
+}
+
+void UDolbyIODebugDeviceCyclerComponent::ClearDwellTimer()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(DwellTimerHandle);
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::PollFirstFrame()
+{
+	UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+	if (!DolbyIOSubsystem || ActiveVideoTrackID.IsEmpty())
+	{
+		return;
+	}
+
+	const UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this);
+	const bool bHasFrame = IsSyntheticDevice(CurrentDeviceIndex) ? SyntheticVideo && SyntheticVideo->GetTexture(ActiveVideoTrackID)
+	                                                             : DolbyIOSubsystem->GetTexture(ActiveVideoTrackID) != nullptr;
+	if (!bHasFrame)
+	{
+		FirstFrameTimerHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UDolbyIODebugDeviceCyclerComponent::PollFirstFrame);
+		return;
+	}
+
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::FirstVideoFrame);
+	if (!bBenchmarkMode)
+	{
+		return;
+	}
+
+	Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::FirstFrame);
+	if (Benchmark.IsComplete())
+	{
+		FinishBenchmark();
+	}
+}
+
+void UDolbyIODebugDeviceCyclerComponent::FinishBenchmark()
+{
+	const FString BaseName = FString::Printf(TEXT("DeviceSwitch-%s"), *FDateTime::Now().ToString());
+	Benchmark.WriteCsv(BaseName);
+
+	const FDolbyIODebugLatencySummary Summary =
+	    Benchmark.Summarize(EDolbyIODebugSwitchPhase::EnableRequested, EDolbyIODebugSwitchPhase::FirstFrame);
+	UE_LOG(LogDolbyIODebug, Display, TEXT("Device switch benchmark finished: first frame p50 %.1f ms, p95 %.1f ms, p99 %.1f ms"),
+	       Summary.P50, Summary.P95, Summary.P99);
+
+	bBenchmarkMode = false;
+	StopCycling();
+}
+
+bool UDolbyIODebugDeviceCyclerComponent::IsSyntheticDevice(int32 DeviceIndex) const
+{
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	return DeviceRegistry && DeviceRegistry->IsValidIndex(DeviceIndex) &&
+	       UDolbyIODebugSyntheticVideo::IsSynthetic(DeviceRegistry->GetDevice(DeviceIndex));
+}
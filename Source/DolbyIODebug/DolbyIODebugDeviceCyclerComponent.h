@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DolbyIODebugSwitchBenchmark.h"
+#include "DolbyIOSubsystem.h"
+#include "DolbyIODebugDeviceCyclerComponent.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FDolbyIODebugOnCycledDevice, const FDolbyIOVideoDevice& /* VideoDevice */, int32 /* DeviceIndex */);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDolbyIODebugOnDeviceActivatedDelegate, const FDolbyIOVideoDevice&, VideoDevice, int32, DeviceIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDolbyIODebugOnDeviceDeactivatedDelegate, const FDolbyIOVideoDevice&, VideoDevice, int32, DeviceIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDolbyIODebugOnCycleCompletedDelegate);
+
+/**
+ * Cycles the local video through every available video device.
+ *
+ * This is the native replacement for the OnVideoDevicesReceived -> Enable Video -> Delay -> Disable Video loop
+ * in BP_Dolby_Debug_Actor. The schedule is driven by the world timer manager, so the component never ticks,
+ * and the Blueprint events are only broadcast for observation. Devices come from UDolbyIODebugDeviceRegistry and
+ * are referred to by their stable registry index, so switching never enumerates the devices again. Synthetic devices
+ * are enabled through UDolbyIODebugSyntheticVideo instead of the SDK. The video stays enabled through a level
+ * transition, and the cycler of the next map resumes from the device UDolbyIODebugSession remembers. Devices
+ * UDolbyIODebugEncoderProbe inferred to be software encoded can be left out of the cycle. While
+ * UDolbyIODebugSendLayerController has the video Off, no device is enabled: the cycle holds until the controller
+ * switches the video back on, or until the layer is back up and the video still off.
+ */
+UCLASS(ClassGroup = (DolbyIO), Meta = (BlueprintSpawnableComponent))
+class DOLBYIODEBUG_API UDolbyIODebugDeviceCyclerComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDolbyIODebugDeviceCyclerComponent();
+
+	/** Seconds each device stays enabled before switching to the next one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.1", Units = "s"))
+	float DwellTime = 5.0f;
+
+	/** Request the video devices and start cycling on BeginPlay. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug")
+	bool bAutoStart = true;
+
+	/** Start over from the first device after the last one instead of stopping. Always on in benchmark mode. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug")
+	bool bLoop = true;
+
+	/**
+	 * Hand the local video over to the next device without disabling it first. The next Enable Video is issued
+	 * PrewarmLeadTime seconds before the dwell ends, so the next device opens and negotiates while the current one
+	 * is still previewing and the preview never goes black between devices.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug")
+	bool bPrewarmNextDevice = false;
+
+	/**
+	 * How long before the end of the dwell the next device is opened when pre-warming. Devices UDolbyIODebugEncoderProbe
+	 * has seen enable are opened as long before as they took instead.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "s", EditCondition = "bPrewarmNextDevice"))
+	float PrewarmLeadTime = 1.0f;
+
+	/**
+	 * Time every switch and write the latency percentiles to Saved/Benchmarks once BenchmarkCycles switches have completed.
+	 * Can also be enabled with -DolbyIOSwitchBenchmark=<cycles> on the command line.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug|Benchmark")
+	bool bBenchmarkMode = false;
+
+	/** Number of switches to record in benchmark mode before cycling stops. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug|Benchmark", Meta = (ClampMin = "1", EditCondition = "bBenchmarkMode"))
+	int32 BenchmarkCycles = 20;
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StartCycling();
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StopCycling();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsCycling() const { return bCycling; }
+
+	/** Registry index of the device currently being previewed, or INDEX_NONE. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	int32 GetCurrentDeviceIndex() const { return CurrentDeviceIndex; }
+
+	/** Broadcast once the SDK reports that the video for a device has been enabled. */
+	FDolbyIODebugOnCycledDevice OnDeviceActivatedNative;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnDeviceActivatedDelegate OnDeviceActivated;
+
+	/** Broadcast once the SDK reports that the video for a device has been disabled. */
+	FDolbyIODebugOnCycledDevice OnDeviceDeactivatedNative;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnDeviceDeactivatedDelegate OnDeviceDeactivated;
+
+	/** Broadcast after the last device in the list has been shown. */
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnCycleCompletedDelegate OnCycleCompleted;
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void HandleDevicesChanged();
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+
+	/** The Blueprint events copy the device, so they are only broadcast when something is bound to them. */
+	void BroadcastDeviceActivated(int32 DeviceIndex);
+	void BroadcastDeviceDeactivated(int32 DeviceIndex);
+	void ScheduleDwell();
+	/** Picks up the device the session kept live through map travel, returns false if there is none. */
+	bool ResumeLiveDevice();
+	void ActivateDevice(int32 DeviceIndex);
+	/** Whether the send layer has the video Off, which enabling a device would undo. */
+	bool IsSendLayerOff() const;
+	/** Activates the device held while the send layer was Off, once it no longer is and nothing else enabled the video. */
+	void ActivateHeldDevice();
+	void DeactivateCurrentDevice();
+	void HandOverToNextDevice();
+	int32 AdvanceDeviceIndex();
+	/** Benchmark mode loops until BenchmarkCycles switches are recorded, as a single pass may have fewer. */
+	bool ShouldLoop() const { return bLoop || bBenchmarkMode; }
+	/** The present device after DeviceIndex that the encoder probe does not skip. */
+	int32 GetNextCycledIndex(int32 DeviceIndex) const;
+	float GetPrewarmLeadTime() const;
+	void ClearDwellTimer();
+	void PollFirstFrame();
+	void FinishBenchmark();
+
+	bool IsSyntheticDevice(int32 DeviceIndex) const;
+
+	int32 CurrentDeviceIndex = INDEX_NONE;
+	int32 PendingDeviceIndex = INDEX_NONE;
+	/** Device to activate once the send layer is no longer Off. */
+	int32 HeldDeviceIndex = INDEX_NONE;
+	FTimerHandle DwellTimerHandle;
+	FTimerHandle FirstFrameTimerHandle;
+	FString ActiveVideoTrackID;
+	FDolbyIODebugSwitchBenchmark Benchmark;
+	FDelegateHandle DevicesChangedHandle;
+	bool bCycling = false;
+	bool bVideoEnabled = false;
+	bool bAwaitingDevices = false;
+};
@@ -0,0 +1,259 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugDeviceRegistry.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugStartupProfiler.h"
+#include "DolbyIODebugSyntheticVideo.h"
+
+#include "Engine/GameInstance.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+#if PLATFORM_WINDOWS
+#include "Framework/Application/SlateApplication.h"
+#include "Windows/WindowsApplication.h"
+
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <dbt.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
+
+namespace DolbyIODebugDeviceRegistry
+{
+	/** Hot-plug notifications come in bursts, one per device node, so wait for them to settle before enumerating. */
+	constexpr float HotPlugRefreshDelay = 0.5f;
+
+	/** The SDK reports no error for a failed enumeration, so one that has not answered by then is given up on. */
+	constexpr float RefreshTimeout = 10.0f;
+}
+
+#if PLATFORM_WINDOWS
+class FDolbyIODebugDeviceChangeHandler : public IWindowsMessageHandler
+{
+public:
+	explicit FDolbyIODebugDeviceChangeHandler(TFunction<void()> InOnDeviceChange) : OnDeviceChange(MoveTemp(InOnDeviceChange)) {}
+
+	bool ProcessMessage(HWND Hwnd, uint32 Message, WPARAM WParam, LPARAM LParam, int32& OutResult) override
+	{
+		if (Message == WM_DEVICECHANGE &&
+		    (WParam == DBT_DEVNODES_CHANGED || WParam == DBT_DEVICEARRIVAL || WParam == DBT_DEVICEREMOVECOMPLETE))
+		{
+			OnDeviceChange();
+		}
+		return false;
+	}
+
+private:
+	TFunction<void()> OnDeviceChange;
+};
+#else
+class FDolbyIODebugDeviceChangeHandler
+{
+};
+#endif
+
+void UDolbyIODebugDeviceRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugSyntheticVideo>();
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::SdkSubsystemInitialized);
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnVideoDevicesReceived.AddDynamic(this, &UDolbyIODebugDeviceRegistry::HandleVideoDevicesReceived);
+	}
+
+	// Synthetic devices need no enumeration, so they can be cycled through before the SDK answers, or if it never does
+	MergeVideoDevices({});
+
+#if PLATFORM_WINDOWS
+	if (FSlateApplication::IsInitialized())
+	{
+		if (TSharedPtr<GenericApplication> PlatformApplication = FSlateApplication::Get().GetPlatformApplication())
+		{
+			DeviceChangeHandler = MakeShared<FDolbyIODebugDeviceChangeHandler>(
+			    [WeakThis = TWeakObjectPtr<UDolbyIODebugDeviceRegistry>(this)]
+			    {
+				    if (WeakThis.IsValid())
+				    {
+					    WeakThis->ScheduleHotPlugRefresh();
+				    }
+			    });
+			static_cast<FWindowsApplication*>(PlatformApplication.Get())->AddMessageHandler(*DeviceChangeHandler);
+		}
+	}
+#endif
+}
+
+void UDolbyIODebugDeviceRegistry::Deinitialize()
+{
+#if PLATFORM_WINDOWS
+	if (DeviceChangeHandler && FSlateApplication::IsInitialized())
+	{
+		if (TSharedPtr<GenericApplication> PlatformApplication = FSlateApplication::Get().GetPlatformApplication())
+		{
+			static_cast<FWindowsApplication*>(PlatformApplication.Get())->RemoveMessageHandler(*DeviceChangeHandler);
+		}
+	}
+#endif
+	DeviceChangeHandler.Reset();
+	FTSTicker::GetCoreTicker().RemoveTicker(HotPlugRefreshHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(RefreshTimeoutHandle);
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnVideoDevicesReceived.RemoveDynamic(this, &UDolbyIODebugDeviceRegistry::HandleVideoDevicesReceived);
+	}
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugDeviceRegistry::Refresh()
+{
+	if (bRefreshInFlight)
+	{
+		// The devices may have changed after the SDK took its snapshot, so enumerate again once this one completes
+		bRefreshAgain = true;
+		return;
+	}
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		bRefreshInFlight = true;
+		bRefreshAgain = false;
+		RefreshTimeoutHandle = FTSTicker::GetCoreTicker().AddTicker(
+		    FTickerDelegate::CreateUObject(this, &UDolbyIODebugDeviceRegistry::HandleRefreshTimeout),
+		    DolbyIODebugDeviceRegistry::RefreshTimeout);
+		DolbyIOSubsystem->GetVideoDevices();
+	}
+}
+
+TArray<FDolbyIOVideoDevice> UDolbyIODebugDeviceRegistry::GetPresentDevices() const
+{
+	TArray<FDolbyIOVideoDevice> PresentDevices;
+	for (const FEntry& Entry : Entries)
+	{
+		if (Entry.bPresent)
+		{
+			PresentDevices.Add(Entry.Device);
+		}
+	}
+	return PresentDevices;
+}
+
+int32 UDolbyIODebugDeviceRegistry::FindIndex(const FString& UniqueID) const
+{
+	const int32* Index = IndexByUniqueID.Find(UniqueID);
+	return Index ? *Index : INDEX_NONE;
+}
+
+int32 UDolbyIODebugDeviceRegistry::GetNextPresentIndex(int32 Index) const
+{
+	for (int32 NextIndex = FMath::Max(Index + 1, 0); NextIndex < Entries.Num(); ++NextIndex)
+	{
+		if (Entries[NextIndex].bPresent)
+		{
+			return NextIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+void UDolbyIODebugDeviceRegistry::HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& ReceivedVideoDevices)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DolbyIODebugRegistryUpdate, DolbyIODebugChannel);
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::DevicesEnumerated);
+	FinishRefresh();
+	const bool bFirstEnumeration = !bHasEnumerated;
+	bHasEnumerated = true;
+	MergeVideoDevices(ReceivedVideoDevices, bFirstEnumeration);
+
+	if (bRefreshAgain)
+	{
+		Refresh();
+	}
+}
+
+void UDolbyIODebugDeviceRegistry::MergeVideoDevices(const TArray<FDolbyIOVideoDevice>& ReceivedVideoDevices,
+                                                    bool bForceChanged)
+{
+	// Synthetic devices are always present, after the real ones
+	TArray<FDolbyIOVideoDevice> VideoDevices = ReceivedVideoDevices;
+	if (const UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		VideoDevices.Append(SyntheticVideo->GetVideoDevices());
+	}
+
+	TBitArray<> SeenEntries(false, Entries.Num());
+	bool bChanged = bForceChanged;
+	for (const FDolbyIOVideoDevice& VideoDevice : VideoDevices)
+	{
+		if (const int32* ExistingIndex = IndexByUniqueID.Find(VideoDevice.UniqueID))
+		{
+			FEntry& Entry = Entries[*ExistingIndex];
+			SeenEntries[*ExistingIndex] = true;
+			if (!Entry.bPresent || Entry.Device.DisplayName != VideoDevice.DisplayName)
+			{
+				Entry.Device = VideoDevice;
+				Entry.bPresent = true;
+				bChanged = true;
+			}
+			continue;
+		}
+
+		const int32 NewIndex = Entries.Add({VideoDevice, true});
+		IndexByUniqueID.Add(VideoDevice.UniqueID, NewIndex);
+		bChanged = true;
+	}
+
+	for (int32 Index = 0; Index < SeenEntries.Num(); ++Index)
+	{
+		if (!SeenEntries[Index] && Entries[Index].bPresent)
+		{
+			Entries[Index].bPresent = false;
+			bChanged = true;
+		}
+	}
+
+	if (bChanged)
+	{
+		UE_LOG(LogDolbyIODebug, Log, TEXT("Video device registry updated: %d devices reported, %d known"), VideoDevices.Num(),
+		       Entries.Num());
+		OnDevicesChangedNative.Broadcast();
+		OnDevicesChanged.Broadcast();
+	}
+}
+
+bool UDolbyIODebugDeviceRegistry::HandleRefreshTimeout(float)
+{
+	UE_LOG(LogDolbyIODebug, Warning, TEXT("Video device enumeration did not complete within %.1f seconds"),
+	       DolbyIODebugDeviceRegistry::RefreshTimeout);
+	RefreshTimeoutHandle.Reset();
+	bRefreshInFlight = false;
+	if (bRefreshAgain)
+	{
+		Refresh();
+	}
+	return false;
+}
+
+void UDolbyIODebugDeviceRegistry::FinishRefresh()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(RefreshTimeoutHandle);
+	RefreshTimeoutHandle.Reset();
+	bRefreshInFlight = false;
+}
+
+void UDolbyIODebugDeviceRegistry::ScheduleHotPlugRefresh()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(HotPlugRefreshHandle);
+	HotPlugRefreshHandle = FTSTicker::GetCoreTicker().AddTicker(
+	    FTickerDelegate::CreateWeakLambda(this,
+	                                      [this](float)
+	                                      {
+		                                      HotPlugRefreshHandle.Reset();
+		                                      Refresh();
+		                                      return false;
+	                                      }),
+	    DolbyIODebugDeviceRegistry::HotPlugRefreshDelay);
+}
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugDeviceRegistry.generated.h"
+
+DECLARE_MULTICAST_DELEGATE(FDolbyIODebugOnDevicesChanged);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDolbyIODebugOnDevicesChangedDelegate);
+
+/**
+ * Caches the video devices reported by the Dolby.io SDK so that they only need to be enumerated once.
+ *
+ * Devices are keyed by their unique ID and keep the index in which they were first seen for the lifetime of the
+ * game instance, so indices can be held across refreshes. Devices that disappear stay in the registry but are no
+ * longer present. The devices are only enumerated again when the OS reports a hot-plug event (Windows) or when
+ * Refresh is called explicitly. The devices of UDolbyIODebugSyntheticVideo are present from Initialize on, whether or not
+ * the SDK ever answers, and are kept after the real ones in every enumeration.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugDeviceRegistry : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	/**
+	 * Enumerates the devices again. If an enumeration is already in flight, another one is started once it completes
+	 * or times out, so that changes made while the SDK was enumerating are not missed.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void Refresh();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool HasEnumerated() const { return bHasEnumerated; }
+
+	/** Returns a copy of the devices that are currently present. Not meant for the hot path. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	TArray<FDolbyIOVideoDevice> GetPresentDevices() const;
+
+	/** Number of stable indices handed out so far, including devices that are no longer present. */
+	int32 Num() const { return Entries.Num(); }
+
+	const FDolbyIOVideoDevice& GetDevice(int32 Index) const { return Entries[Index].Device; }
+	bool IsValidIndex(int32 Index) const { return Entries.IsValidIndex(Index); }
+	bool IsPresent(int32 Index) const { return Entries.IsValidIndex(Index) && Entries[Index].bPresent; }
+
+	/** Returns the stable index of a device or INDEX_NONE if it was never seen. */
+	int32 FindIndex(const FString& UniqueID) const;
+
+	/** Returns the first present index after Index, or INDEX_NONE if there is none. Pass INDEX_NONE to get the first one. */
+	int32 GetNextPresentIndex(int32 Index) const;
+
+	/** Broadcast when the set of present devices or their names change. */
+	FDolbyIODebugOnDevicesChanged OnDevicesChangedNative;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnDevicesChangedDelegate OnDevicesChanged;
+
+private:
+	struct FEntry
+	{
+		FDolbyIOVideoDevice Device;
+		bool bPresent = false;
+	};
+
+	UFUNCTION()
+	void HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& ReceivedVideoDevices);
+
+	/** Merges the devices reported by the SDK and the synthetic ones into the registry, broadcasting if they changed. */
+	void MergeVideoDevices(const TArray<FDolbyIOVideoDevice>& ReceivedVideoDevices, bool bForceChanged = false);
+
+	void ScheduleHotPlugRefresh();
+	bool HandleRefreshTimeout(float DeltaTime);
+	void FinishRefresh();
+
+	TArray<FEntry> Entries;
+	TMap<FString, int32> IndexByUniqueID;
+	TSharedPtr<class FDolbyIODebugDeviceChangeHandler> DeviceChangeHandler;
+	FTSTicker::FDelegateHandle HotPlugRefreshHandle;
+	FTSTicker::FDelegateHandle RefreshTimeoutHandle;
+	bool bHasEnumerated = false;
+	bool bRefreshInFlight = false;
+	bool bRefreshAgain = false;
+};
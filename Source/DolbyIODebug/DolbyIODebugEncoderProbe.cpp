@@ -0,0 +1,269 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugEncoderProbe.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugSyntheticVideo.h"
+#include "DolbyIODebugVideoEvents.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/Texture.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ConfigCacheIni.h"
+#include "RHI.h"
+
+namespace DolbyIODebugEncoderProbe
+{
+	const TCHAR* const SavedSection = TEXT("DolbyIODebug.EncoderProbe");
+	/** Renamed with the encoder name field, so that capabilities saved with it are probed again. */
+	const TCHAR* const SavedKey = TEXT("InferredCapability");
+	constexpr float SampleInterval = 0.1f;
+	/** Weight of the latest enable in the smoothed enable time. */
+	constexpr float EnableTimeWeight = 0.25f;
+
+	float GetProcessCores()
+	{
+		return FPlatformTime::GetCPUTime().CPUTimePctRelative / 100.0f;
+	}
+}
+
+void UDolbyIODebugEncoderProbe::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugVideoEvents>();
+
+	Load();
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugEncoderProbe::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugEncoderProbe::HandleVideoDisabled);
+	}
+}
+
+void UDolbyIODebugEncoderProbe::Deinitialize()
+{
+	StopSampling();
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugEncoderProbe::NotifyEnableRequested(const FDolbyIOVideoDevice& VideoDevice)
+{
+	if (UDolbyIODebugSyntheticVideo::IsSynthetic(VideoDevice))
+	{
+		return;
+	}
+
+	FProbe& Probe = Requested.Emplace();
+	Probe.Device = VideoDevice;
+	Probe.RequestTime = FPlatformTime::Seconds();
+	Probe.BaselineCores = DolbyIODebugEncoderProbe::GetProcessCores();
+	Probe.ReplacedCost = LiveCost;
+}
+
+const FDolbyIODebugEncoderCapability* UDolbyIODebugEncoderProbe::FindCapability(const FString& UniqueID) const
+{
+	const TArray<FDolbyIODebugEncoderCapability>* Formats = Capabilities.Find(UniqueID);
+	return Formats && Formats->Num() > 0 ? &Formats->Last() : nullptr;
+}
+
+bool UDolbyIODebugEncoderProbe::GetCapability(const FDolbyIOVideoDevice& VideoDevice, FDolbyIODebugEncoderCapability& OutCapability) const
+{
+	const FDolbyIODebugEncoderCapability* Capability = FindCapability(VideoDevice.UniqueID);
+	if (!Capability)
+	{
+		return false;
+	}
+	OutCapability = *Capability;
+	return true;
+}
+
+TArray<FDolbyIODebugEncoderCapability> UDolbyIODebugEncoderProbe::GetCapabilities() const
+{
+	TArray<FDolbyIODebugEncoderCapability> AllCapabilities;
+	for (const TPair<FString, TArray<FDolbyIODebugEncoderCapability>>& Formats : Capabilities)
+	{
+		AllCapabilities.Append(Formats.Value);
+	}
+	return AllCapabilities;
+}
+
+float UDolbyIODebugEncoderProbe::GetExpectedEnableTime(const FDolbyIOVideoDevice& VideoDevice) const
+{
+	const FDolbyIODebugEncoderCapability* Capability = FindCapability(VideoDevice.UniqueID);
+	return Capability ? Capability->EnableTime : 0.0f;
+}
+
+bool UDolbyIODebugEncoderProbe::ShouldSkip(const FDolbyIOVideoDevice& VideoDevice) const
+{
+	if (!bSkipSoftwareEncodedDevices)
+	{
+		return false;
+	}
+	const FDolbyIODebugEncoderCapability* Capability = FindCapability(VideoDevice.UniqueID);
+	return Capability && !Capability->IsHardware();
+}
+
+void UDolbyIODebugEncoderProbe::ResetCapabilities()
+{
+	Capabilities.Reset();
+	Save();
+}
+
+bool UDolbyIODebugEncoderProbe::IsEncoderCapableGpu()
+{
+	return IsRHIDeviceNVIDIA() || IsRHIDeviceAMD() || IsRHIDeviceIntel();
+}
+
+void UDolbyIODebugEncoderProbe::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	if (!Requested)
+	{
+		return;
+	}
+
+	StopSampling();
+	Active = MoveTemp(Requested);
+	Requested.Reset();
+	Active->VideoTrackID = VideoTrackID;
+	Active->EnableTime = static_cast<float>(FPlatformTime::Seconds() - Active->RequestTime);
+
+	// The format is only known once the first frame is in
+	SampleHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UDolbyIODebugEncoderProbe::Sample),
+	                                                    DolbyIODebugEncoderProbe::SampleInterval);
+}
+
+void UDolbyIODebugEncoderProbe::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	// A probe cut short by a disable says nothing about the cost
+	StopSampling();
+	LiveCost = 0.0f;
+}
+
+bool UDolbyIODebugEncoderProbe::Sample(float DeltaTime)
+{
+	if (Active->Width == 0)
+	{
+		UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+		const UTexture* Texture = DolbyIOSubsystem ? DolbyIOSubsystem->GetTexture(Active->VideoTrackID) : nullptr;
+		if (!Texture)
+		{
+			return true;
+		}
+		Active->Width = static_cast<int32>(Texture->GetSurfaceWidth());
+		Active->Height = static_cast<int32>(Texture->GetSurfaceHeight());
+
+		if (FDolbyIODebugEncoderCapability* Capability = FindFormat(Active->Device.UniqueID, Active->Width, Active->Height))
+		{
+			Capability->EnableTime = FMath::Lerp(Capability->EnableTime, Active->EnableTime, DolbyIODebugEncoderProbe::EnableTimeWeight);
+			LiveCost = Capability->CpuCost;
+
+			// The format the device was last enabled at goes last
+			TArray<FDolbyIODebugEncoderCapability>& Formats = Capabilities.FindChecked(Active->Device.UniqueID);
+			FDolbyIODebugEncoderCapability Reused = *Capability;
+			Formats.RemoveAll([&Reused](const FDolbyIODebugEncoderCapability& Format)
+			                  { return Format.Width == Reused.Width && Format.Height == Reused.Height; });
+			Formats.Add(MoveTemp(Reused));
+			Save();
+			StopSampling();
+			return false;
+		}
+		Active->SampleStartTime = FPlatformTime::Seconds();
+		return true;
+	}
+
+	Active->SumCores += DolbyIODebugEncoderProbe::GetProcessCores();
+	++Active->NumSamples;
+	if (FPlatformTime::Seconds() - Active->SampleStartTime < ProbeDuration)
+	{
+		return true;
+	}
+
+	FinishProbe();
+	return false;
+}
+
+void UDolbyIODebugEncoderProbe::FinishProbe()
+{
+	using namespace DolbyIODebugEncoderProbe;
+
+	const FProbe& Probe = *Active;
+	const float MeanCores = Probe.SumCores / FMath::Max(Probe.NumSamples, 1);
+
+	// On a handover the device replaced stops being encoded as this one starts
+	FDolbyIODebugEncoderCapability Capability;
+	Capability.UniqueID = Probe.Device.UniqueID;
+	Capability.Width = Probe.Width;
+	Capability.Height = Probe.Height;
+	Capability.EnableTime = Probe.EnableTime;
+	Capability.CpuCost = FMath::Max(MeanCores - Probe.BaselineCores + Probe.ReplacedCost, 0.0f);
+	Capability.InferredEncoding = IsEncoderCapableGpu() && Capability.CpuCost <= MaxHardwareCost ? EDolbyIODebugInferredEncoding::Hardware
+	                                                                                              : EDolbyIODebugInferredEncoding::Software;
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Video device %s at %dx%d: %.2f cores, likely %s encoded, enabled in %.2f s"),
+	       *Probe.Device.DisplayName, Capability.Width, Capability.Height, Capability.CpuCost,
+	       Capability.IsHardware() ? TEXT("hardware") : TEXT("software"), Capability.EnableTime);
+
+	LiveCost = Capability.CpuCost;
+	TArray<FDolbyIODebugEncoderCapability>& Formats = Capabilities.FindOrAdd(Capability.UniqueID);
+	Formats.RemoveAll([&Capability](const FDolbyIODebugEncoderCapability& Format)
+	                  { return Format.Width == Capability.Width && Format.Height == Capability.Height; });
+	Formats.Add(MoveTemp(Capability));
+	Save();
+	StopSampling();
+}
+
+void UDolbyIODebugEncoderProbe::StopSampling()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(SampleHandle);
+	SampleHandle.Reset();
+	Active.Reset();
+}
+
+FDolbyIODebugEncoderCapability* UDolbyIODebugEncoderProbe::FindFormat(const FString& UniqueID, int32 Width, int32 Height)
+{
+	TArray<FDolbyIODebugEncoderCapability>* Formats = Capabilities.Find(UniqueID);
+	if (!Formats)
+	{
+		return nullptr;
+	}
+	return Formats->FindByPredicate([Width, Height](const FDolbyIODebugEncoderCapability& Format)
+	                                { return Format.Width == Width && Format.Height == Height; });
+}
+
+void UDolbyIODebugEncoderProbe::Load()
+{
+	TArray<FString> Lines;
+	GConfig->GetArray(DolbyIODebugEncoderProbe::SavedSection, DolbyIODebugEncoderProbe::SavedKey, Lines, GGameUserSettingsIni);
+
+	UScriptStruct* Struct = FDolbyIODebugEncoderCapability::StaticStruct();
+	for (const FString& Line : Lines)
+	{
+		FDolbyIODebugEncoderCapability Capability;
+		if (Struct->ImportText(*Line, &Capability, nullptr, PPF_None, GLog, Struct->GetName()) && !Capability.UniqueID.IsEmpty())
+		{
+			Capabilities.FindOrAdd(Capability.UniqueID).Add(MoveTemp(Capability));
+		}
+	}
+}
+
+void UDolbyIODebugEncoderProbe::Save() const
+{
+	TArray<FString> Lines;
+	UScriptStruct* Struct = FDolbyIODebugEncoderCapability::StaticStruct();
+	const FDolbyIODebugEncoderCapability Defaults;
+	for (const FDolbyIODebugEncoderCapability& Capability : GetCapabilities())
+	{
+		Struct->ExportText(Lines.AddDefaulted_GetRef(), &Capability, &Defaults, nullptr, PPF_None, nullptr);
+	}
+
+	GConfig->SetArray(DolbyIODebugEncoderProbe::SavedSection, DolbyIODebugEncoderProbe::SavedKey, Lines, GGameUserSettingsIni);
+	GConfig->Flush(false, GGameUserSettingsIni);
+}
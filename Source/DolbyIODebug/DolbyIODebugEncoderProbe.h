@@ -0,0 +1,151 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugEncoderProbe.generated.h"
+
+/** How the local video of a device is taken to be encoded, inferred from its CPU cost and the GPU. */
+UENUM(BlueprintType)
+enum class EDolbyIODebugInferredEncoding : uint8
+{
+	/** Too costly for a GPU encoder, or no GPU with one. */
+	Software,
+	/** Cheap enough on a GPU that has an encoder to be taken as encoded by it. */
+	Hardware,
+};
+
+/** What the local video of a capture device at a given format was measured to cost, and how it is taken to be encoded. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugEncoderCapability
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString UniqueID;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 Width = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 Height = 0;
+
+	/**
+	 * Inferred, not reported: the SDK does not tell which encoder it uses, so this is only a guess from the GPU vendor
+	 * and the CPU cost.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	EDolbyIODebugInferredEncoding InferredEncoding = EDolbyIODebugInferredEncoding::Software;
+
+	/** From the Enable Video request to the SDK reporting the video as enabled, smoothed over the enables so far. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "s"))
+	float EnableTime = 0.0f;
+
+	/** Cores the process spent on capturing and encoding the device, as measured by the probe. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	float CpuCost = 0.0f;
+
+	bool IsHardware() const { return InferredEncoding == EDolbyIODebugInferredEncoding::Hardware; }
+};
+
+/**
+ * Measures, once per capture device and format, what the local video costs and how long it takes to enable.
+ *
+ * The SDK picks the encoder of the local video itself and does not report it, so the probe measures the outcome
+ * instead of configuring it: the first time a device is enabled at a format, the CPU time of the process is sampled
+ * for ProbeDuration once the first frame is in, against the time just before the request. On a GPU from a vendor with
+ * a video encoder, a cost below MaxHardwareCost is taken as hardware encoding; anything else is taken as software
+ * encoding. That classification is an inference, not the name of an encoder. The capabilities are kept in
+ * GameUserSettings, so later enables of the same device and format, in this run or the next ones, reuse what was
+ * measured without sampling again: the switcher times requests out from the enable time of the device, the cycler
+ * opens the next device only as far ahead as it takes to enable, and devices inferred to be software encoded can be
+ * skipped. Nothing of the encoder setup itself is reused, that stays with the SDK.
+ *
+ * Synthetic devices never reach the SDK and are not probed.
+ */
+UCLASS(Config = Game)
+class DOLBYIODEBUG_API UDolbyIODebugEncoderProbe : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.5", Units = "s"))
+	float ProbeDuration = 3.0f;
+
+	/** Cores of encoding above which a device is taken as software encoded, whatever the GPU. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0"))
+	float MaxHardwareCost = 0.25f;
+
+	/** Leave devices inferred to be software encoded out of the device cycle. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug")
+	bool bSkipSoftwareEncodedDevices = false;
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	/** To be called right before the SDK is asked to enable the video of a device. */
+	void NotifyEnableRequested(const FDolbyIOVideoDevice& VideoDevice);
+
+	/** Returns the capability of the format the device was last enabled at, or nullptr if it was never probed. */
+	const FDolbyIODebugEncoderCapability* FindCapability(const FString& UniqueID) const;
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool GetCapability(const FDolbyIOVideoDevice& VideoDevice, FDolbyIODebugEncoderCapability& OutCapability) const;
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	TArray<FDolbyIODebugEncoderCapability> GetCapabilities() const;
+
+	/** Seconds the device is expected to take to enable, 0 if it was never enabled. */
+	float GetExpectedEnableTime(const FDolbyIOVideoDevice& VideoDevice) const;
+
+	/** Whether the device was inferred to be software encoded and those are to be skipped. */
+	bool ShouldSkip(const FDolbyIOVideoDevice& VideoDevice) const;
+
+	/** Forgets every capability, so that every device is probed again. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void ResetCapabilities();
+
+	/**
+	 * Whether the GPU the game renders on is from a vendor whose GPUs have a video encoder: NVIDIA, AMD or Intel. Says
+	 * nothing of whether the SDK encodes on it.
+	 */
+	static bool IsEncoderCapableGpu();
+
+private:
+	struct FProbe
+	{
+		FDolbyIOVideoDevice Device;
+		FString VideoTrackID;
+		double RequestTime = 0.0;
+		/** Cores in use right before the request, and what the device live then was costing of it. */
+		float BaselineCores = 0.0f;
+		float ReplacedCost = 0.0f;
+		float EnableTime = 0.0f;
+		double SampleStartTime = 0.0;
+		float SumCores = 0.0f;
+		int32 NumSamples = 0;
+		int32 Width = 0;
+		int32 Height = 0;
+	};
+
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+
+	bool Sample(float DeltaTime);
+	void FinishProbe();
+	void StopSampling();
+	FDolbyIODebugEncoderCapability* FindFormat(const FString& UniqueID, int32 Width, int32 Height);
+	void Load();
+	void Save() const;
+
+	/** Per device, the formats it was probed at, the one it was last enabled at last. */
+	TMap<FString, TArray<FDolbyIODebugEncoderCapability>> Capabilities;
+	TOptional<FProbe> Requested;
+	TOptional<FProbe> Active;
+	/** Cores the live device costs, from its capability. */
+	float LiveCost = 0.0f;
+	FTSTicker::FDelegateHandle SampleHandle;
+};
@@ -0,0 +1,261 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugEventProcessor.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugVideoEvents.h"
+
+#include "Containers/Queue.h"
+#include "Engine/GameInstance.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+#include <atomic>
+
+class FDolbyIODebugEventWorker : public FRunnable
+{
+public:
+	FDolbyIODebugEventWorker()
+	{
+		Thread.Reset(FRunnableThread::Create(this, TEXT("DolbyIODebugEventWorker"), 0, TPri_BelowNormal));
+	}
+
+	~FDolbyIODebugEventWorker() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+		}
+	}
+
+	void Enqueue(FDolbyIODebugObserverEvent&& Event)
+	{
+		Events.Enqueue(MoveTemp(Event));
+		WakeUp->Trigger();
+	}
+
+	/** Game thread only. Returns false if nothing was published since the last call. */
+	bool PollSnapshot(FDolbyIODebugObserverSnapshot& OutSnapshot)
+	{
+		FDolbyIODebugObserverSnapshot Snapshot;
+		if (!Snapshots.Dequeue(Snapshot))
+		{
+			return false;
+		}
+
+		// The counters are cumulative, only the device deltas need to be merged
+		TArray<FString> AddedDeviceIDs = MoveTemp(Snapshot.AddedDeviceIDs);
+		TArray<FString> RemovedDeviceIDs = MoveTemp(Snapshot.RemovedDeviceIDs);
+		while (Snapshots.Dequeue(Snapshot))
+		{
+			AddedDeviceIDs.Append(MoveTemp(Snapshot.AddedDeviceIDs));
+			RemovedDeviceIDs.Append(MoveTemp(Snapshot.RemovedDeviceIDs));
+		}
+		OutSnapshot = MoveTemp(Snapshot);
+		OutSnapshot.AddedDeviceIDs = MoveTemp(AddedDeviceIDs);
+		OutSnapshot.RemovedDeviceIDs = MoveTemp(RemovedDeviceIDs);
+		return true;
+	}
+
+	uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			WakeUp->Wait();
+
+			bool bProcessedAny = false;
+			FDolbyIODebugObserverEvent Event;
+			while (Events.Dequeue(Event))
+			{
+				Process(Event);
+				bProcessedAny = true;
+			}
+
+			if (bProcessedAny)
+			{
+				Snapshots.Enqueue(Current);
+				Current.AddedDeviceIDs.Reset();
+				Current.RemovedDeviceIDs.Reset();
+			}
+		}
+		return 0;
+	}
+
+	void Stop() override
+	{
+		bStopping = true;
+		WakeUp->Trigger();
+	}
+
+private:
+	void Process(const FDolbyIODebugObserverEvent& Event)
+	{
+		++Current.NumEventsProcessed;
+
+		switch (Event.Type)
+		{
+			case EDolbyIODebugObserverEventType::TokenNeeded:
+				++Current.NumTokenRequests;
+				UE_LOG(LogDolbyIODebug, Verbose, TEXT("Token needed"));
+				break;
+
+			case EDolbyIODebugObserverEventType::VideoDevicesReceived:
+				++Current.NumDeviceLists;
+				DiffDevices(Event.VideoDevices);
+				break;
+		}
+	}
+
+	void DiffDevices(const TArray<FDolbyIOVideoDevice>& VideoDevices)
+	{
+		TSet<FString> ReceivedDeviceIDs;
+		ReceivedDeviceIDs.Reserve(VideoDevices.Num());
+		for (const FDolbyIOVideoDevice& VideoDevice : VideoDevices)
+		{
+			ReceivedDeviceIDs.Add(VideoDevice.UniqueID);
+			if (!KnownDeviceIDs.Contains(VideoDevice.UniqueID))
+			{
+				Current.AddedDeviceIDs.Add(VideoDevice.UniqueID);
+				UE_LOG(LogDolbyIODebug, Log, TEXT("Video device added: %s (%s)"), *VideoDevice.DisplayName, *VideoDevice.UniqueID);
+			}
+		}
+
+		for (const FString& KnownDeviceID : KnownDeviceIDs)
+		{
+			if (!ReceivedDeviceIDs.Contains(KnownDeviceID))
+			{
+				Current.RemovedDeviceIDs.Add(KnownDeviceID);
+				UE_LOG(LogDolbyIODebug, Log, TEXT("Video device removed: %s"), *KnownDeviceID);
+			}
+		}
+
+		KnownDeviceIDs = MoveTemp(ReceivedDeviceIDs);
+	}
+
+	TQueue<FDolbyIODebugObserverEvent, EQueueMode::Mpsc> Events;
+	TQueue<FDolbyIODebugObserverSnapshot, EQueueMode::Spsc> Snapshots;
+	FEventRef WakeUp;
+	std::atomic<bool> bStopping{false};
+	TUniquePtr<FRunnableThread> Thread;
+
+	/** Only touched on the worker thread. */
+	FDolbyIODebugObserverSnapshot Current;
+	TSet<FString> KnownDeviceIDs;
+};
+
+void UDolbyIODebugEventProcessor::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugVideoEvents>();
+
+	Worker = MakeShared<FDolbyIODebugEventWorker>();
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnTokenNeeded.AddDynamic(this, &UDolbyIODebugEventProcessor::HandleTokenNeeded);
+	}
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugEventProcessor::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugEventProcessor::HandleVideoDisabled);
+		VideoEvents->OnVideoDevicesReceivedNative.AddUObject(this, &UDolbyIODebugEventProcessor::HandleVideoDevicesReceived);
+	}
+}
+
+void UDolbyIODebugEventProcessor::Deinitialize()
+{
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnTokenNeeded.RemoveDynamic(this, &UDolbyIODebugEventProcessor::HandleTokenNeeded);
+	}
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDevicesReceivedNative.RemoveAll(this);
+	}
+
+	Worker.Reset();
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugEventProcessor::EnqueueEvent(FDolbyIODebugObserverEvent&& Event)
+{
+	if (Worker)
+	{
+		Worker->Enqueue(MoveTemp(Event));
+	}
+}
+
+void UDolbyIODebugEventProcessor::Tick(float DeltaTime)
+{
+	const bool bWorkerPublished = Worker->PollSnapshot(WorkerSnapshot);
+	if (!bWorkerPublished && !bTrackEventsChanged)
+	{
+		return;
+	}
+
+	// The device deltas are since the previous broadcast, so a broadcast for the track events alone has none
+	LatestSnapshot.AddedDeviceIDs.Reset();
+	LatestSnapshot.RemovedDeviceIDs.Reset();
+	if (bWorkerPublished)
+	{
+		LatestSnapshot.NumTokenRequests = WorkerSnapshot.NumTokenRequests;
+		LatestSnapshot.NumDeviceLists = WorkerSnapshot.NumDeviceLists;
+		LatestSnapshot.AddedDeviceIDs = MoveTemp(WorkerSnapshot.AddedDeviceIDs);
+		LatestSnapshot.RemovedDeviceIDs = MoveTemp(WorkerSnapshot.RemovedDeviceIDs);
+	}
+	LatestSnapshot.NumEventsProcessed = WorkerSnapshot.NumEventsProcessed + NumTrackEventsProcessed;
+	bTrackEventsChanged = false;
+
+	OnSnapshotNative.Broadcast(LatestSnapshot);
+	// The Blueprint event copies the snapshot
+	if (OnSnapshot.IsBound())
+	{
+		OnSnapshot.Broadcast(LatestSnapshot);
+	}
+}
+
+TStatId UDolbyIODebugEventProcessor::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDolbyIODebugEventProcessor, STATGROUP_Tickables);
+}
+
+void UDolbyIODebugEventProcessor::HandleTokenNeeded()
+{
+	EnqueueEvent({EDolbyIODebugObserverEventType::TokenNeeded, FPlatformTime::Seconds()});
+}
+
+void UDolbyIODebugEventProcessor::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	LLM_SCOPE_BYTAG(DolbyIODebug_Events);
+	++LatestSnapshot.NumVideoEnabled;
+	++NumTrackEventsProcessed;
+	UDolbyIODebugVideoEvents::AssignID(LatestSnapshot.ActiveVideoTrackID, VideoTrackID);
+	VideoEnabledTime = FPlatformTime::Seconds();
+	bTrackEventsChanged = true;
+	UE_LOG(LogDolbyIODebug, Verbose, TEXT("Video enabled: %s"), *VideoTrackID);
+}
+
+void UDolbyIODebugEventProcessor::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	++LatestSnapshot.NumVideoDisabled;
+	++NumTrackEventsProcessed;
+	LatestSnapshot.ActiveVideoTrackID.Reset();
+	if (VideoEnabledTime > 0.0)
+	{
+		LatestSnapshot.LastVideoEnabledDurationMs = static_cast<float>((FPlatformTime::Seconds() - VideoEnabledTime) * 1000.0);
+		VideoEnabledTime = 0.0;
+	}
+	bTrackEventsChanged = true;
+	UE_LOG(LogDolbyIODebug, Verbose, TEXT("Video disabled: %s"), *VideoTrackID);
+}
+
+void UDolbyIODebugEventProcessor::HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices, TConstArrayView<FName> DeviceIDs)
+{
+	EnqueueEvent({EDolbyIODebugObserverEventType::VideoDevicesReceived, FPlatformTime::Seconds(), VideoDevices});
+}
@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "DolbyIODebugEventProcessor.generated.h"
+
+enum class EDolbyIODebugObserverEventType : uint8
+{
+	TokenNeeded,
+	VideoDevicesReceived,
+};
+
+/** An observer event as queued for the worker thread. */
+struct FDolbyIODebugObserverEvent
+{
+	EDolbyIODebugObserverEventType Type = EDolbyIODebugObserverEventType::TokenNeeded;
+
+	/** FPlatformTime::Seconds() at which the event was received. */
+	double Timestamp = 0.0;
+
+	TArray<FDolbyIOVideoDevice> VideoDevices;
+};
+
+/** What the worker thread made of the observer events, published to the game thread at most once per frame. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugObserverSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumTokenRequests = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumVideoEnabled = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumVideoDisabled = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 NumDeviceLists = 0;
+
+	/** Unique IDs of the devices that appeared since the previous snapshot. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	TArray<FString> AddedDeviceIDs;
+
+	/** Unique IDs of the devices that disappeared since the previous snapshot. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	TArray<FString> RemovedDeviceIDs;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString ActiveVideoTrackID;
+
+	/** How long the last video stayed enabled, in milliseconds. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	float LastVideoEnabledDurationMs = 0.0f;
+
+	/** Number of observer events processed, on the worker thread or for the track events on the game thread. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 NumEventsProcessed = 0;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnObserverSnapshot, const FDolbyIODebugObserverSnapshot&);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnObserverSnapshotDelegate, const FDolbyIODebugObserverSnapshot&, Snapshot);
+
+/**
+ * Moves the processing of the Dolby.io observer events off the game thread.
+ *
+ * The game thread handlers only push a compact event onto a lock-free MPSC queue, which other threads can also feed
+ * through EnqueueEvent. A worker thread diffs the device lists, aggregates the stats and does the logging, and the
+ * result is broadcast on the game thread at most once per frame. The video track events come every device switch and
+ * only bump a counter, so they are counted straight from UDolbyIODebugVideoEvents on the game thread instead: queueing
+ * them would allocate a node and a copy of the track ID per event.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugEventProcessor : public UGameInstanceSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	/** Queues an event for the worker thread. Can be called from any thread. */
+	void EnqueueEvent(FDolbyIODebugObserverEvent&& Event);
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	const FDolbyIODebugObserverSnapshot& GetLatestSnapshot() const { return LatestSnapshot; }
+
+	FDolbyIODebugOnObserverSnapshot OnSnapshotNative;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnObserverSnapshotDelegate OnSnapshot;
+
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+	bool IsTickable() const override { return Worker.IsValid(); }
+	ETickableTickType GetTickableTickType() const override { return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional; }
+
+private:
+	UFUNCTION()
+	void HandleTokenNeeded();
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+	void HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices, TConstArrayView<FName> DeviceIDs);
+
+	TSharedPtr<class FDolbyIODebugEventWorker> Worker;
+	FDolbyIODebugObserverSnapshot LatestSnapshot;
+	/** The last snapshot of the worker, whose fields other than the track ones are published. */
+	FDolbyIODebugObserverSnapshot WorkerSnapshot;
+	int64 NumTrackEventsProcessed = 0;
+	double VideoEnabledTime = 0.0;
+	bool bTrackEventsChanged = false;
+};
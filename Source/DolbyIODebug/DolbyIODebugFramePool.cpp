@@ -0,0 +1,174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebug.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+TArray64<uint8> FDolbyIODebugFramePool::AcquireBuffer(const FDolbyIODebugFrameFormat& Format)
+{
+	LLM_SCOPE_BYTAG(DolbyIODebug_Frames);
+	{
+		FScopeLock Lock(&CriticalSection);
+		FBucket& Bucket = FindOrAddBucket(Format);
+		if (Bucket.Buffers.Num() > 0)
+		{
+			++Stats.BuffersReused;
+			Stats.PooledBytes -= Format.GetSizeBytes();
+			return Bucket.Buffers.Pop(false);
+		}
+		++Stats.BuffersAllocated;
+	}
+
+	TArray64<uint8> Buffer;
+	Buffer.SetNumUninitialized(Format.GetSizeBytes());
+	return Buffer;
+}
+
+void FDolbyIODebugFramePool::ReleaseBuffer(const FDolbyIODebugFrameFormat& Format, TArray64<uint8>&& Buffer)
+{
+	if (Buffer.Num() != Format.GetSizeBytes())
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(DolbyIODebug_Frames);
+	FScopeLock Lock(&CriticalSection);
+	Stats.PooledBytes += Format.GetSizeBytes();
+	FindOrAddBucket(Format).Buffers.Add(MoveTemp(Buffer));
+}
+
+FTextureRHIRef FDolbyIODebugFramePool::AcquireTexture(const FDolbyIODebugFrameFormat& Format)
+{
+	check(IsInRenderingThread());
+
+	{
+		FScopeLock Lock(&CriticalSection);
+		FBucket& Bucket = FindOrAddBucket(Format);
+		if (Bucket.Textures.Num() > 0)
+		{
+			++Stats.TexturesReused;
+			Stats.PooledBytes -= Format.GetSizeBytes();
+			return Bucket.Textures.Pop(false);
+		}
+		++Stats.TexturesAllocated;
+	}
+
+	const FRHITextureCreateDesc Desc =
+	    FRHITextureCreateDesc::Create2D(TEXT("DolbyIODebugFrame"), Format.Width, Format.Height, PF_B8G8R8A8)
+	        .SetFlags(ETextureCreateFlags::Dynamic | ETextureCreateFlags::ShaderResource | ETextureCreateFlags::SRGB);
+	return RHICreateTexture(Desc);
+}
+
+void FDolbyIODebugFramePool::ReleaseTexture(const FDolbyIODebugFrameFormat& Format, FTextureRHIRef&& Texture)
+{
+	check(IsInRenderingThread());
+
+	if (!Texture)
+	{
+		return;
+	}
+
+	LLM_SCOPE_BYTAG(DolbyIODebug_Frames);
+	FScopeLock Lock(&CriticalSection);
+	Stats.PooledBytes += Format.GetSizeBytes();
+	FindOrAddBucket(Format).Textures.Add(MoveTemp(Texture));
+}
+
+void FDolbyIODebugFramePool::Trim(double IdleLifetime, int32 MaxFormats)
+{
+	FScopeLock Lock(&CriticalSection);
+
+	const double Now = FPlatformTime::Seconds();
+	auto FreeBucket = [this](const FDolbyIODebugFrameFormat& Format, const FBucket& Bucket)
+	{
+		Stats.PooledBytes -= (Bucket.Buffers.Num() + Bucket.Textures.Num()) * Format.GetSizeBytes();
+	};
+
+	for (auto It = Buckets.CreateIterator(); It; ++It)
+	{
+		if (Now - It.Value().LastUsedTime > IdleLifetime)
+		{
+			FreeBucket(It.Key(), It.Value());
+			It.RemoveCurrent();
+		}
+	}
+
+	if (Buckets.Num() > MaxFormats)
+	{
+		Buckets.ValueSort([](const FBucket& Lhs, const FBucket& Rhs) { return Lhs.LastUsedTime > Rhs.LastUsedTime; });
+		int32 Index = 0;
+		for (auto It = Buckets.CreateIterator(); It; ++It, ++Index)
+		{
+			if (Index >= MaxFormats)
+			{
+				FreeBucket(It.Key(), It.Value());
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	Stats.PooledFormats = Buckets.Num();
+}
+
+void FDolbyIODebugFramePool::Empty()
+{
+	FScopeLock Lock(&CriticalSection);
+	Buckets.Empty();
+	Stats.PooledBytes = 0;
+	Stats.PooledFormats = 0;
+}
+
+FDolbyIODebugFramePool::FStats FDolbyIODebugFramePool::GetStats() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return Stats;
+}
+
+FDolbyIODebugFramePool::FBucket& FDolbyIODebugFramePool::FindOrAddBucket(const FDolbyIODebugFrameFormat& Format)
+{
+	FBucket& Bucket = Buckets.FindOrAdd(Format);
+	Bucket.LastUsedTime = FPlatformTime::Seconds();
+	Stats.PooledFormats = Buckets.Num();
+	return Bucket;
+}
+
+void FDolbyIODebugPooledFrame::CopyFrom(const FDolbyIODebugVideoFrame& Frame, FDolbyIODebugFramePool& Pool)
+{
+	Format = Frame.GetFormat();
+	CaptureTime = Frame.CaptureTime;
+	NativeTexture = Frame.NativeTexture;
+	if (!Frame.NativeTexture)
+	{
+		Buffer = Pool.AcquireBuffer(Format);
+		Frame.CopyPacked(Buffer.GetData());
+	}
+}
+
+FDolbyIODebugVideoFrame FDolbyIODebugPooledFrame::GetFrame() const
+{
+	FDolbyIODebugVideoFrame Frame;
+	if (NativeTexture)
+	{
+		Frame.Width = Format.Width;
+		Frame.Height = Format.Height;
+		Frame.Format = Format.PixelFormat;
+		Frame.NativeTexture = NativeTexture;
+	}
+	else
+	{
+		Frame = FDolbyIODebugVideoFrame::MakePacked(Format, Buffer.GetData());
+	}
+	Frame.CaptureTime = CaptureTime;
+	return Frame;
+}
+
+void FDolbyIODebugPooledFrame::Release(FDolbyIODebugFramePool& Pool)
+{
+	if (Buffer.Num() > 0)
+	{
+		Pool.ReleaseBuffer(Format, MoveTemp(Buffer));
+	}
+	NativeTexture.SafeRelease();
+}
@@ -0,0 +1,77 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIODebugVideoFrame.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Recycles frame buffers and RHI textures across device switches, keyed by resolution and pixel format.
+ *
+ * Cycling between devices of different resolutions keeps coming back to the same few formats, so memory released for
+ * one format is kept around for a while instead of being freed and allocated again on the next switch. Formats that
+ * have not been used for a while are trimmed, oldest first. Buffers can be acquired and released from any thread,
+ * textures only from the render thread.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugFramePool
+{
+public:
+	struct FStats
+	{
+		int64 BuffersAllocated = 0;
+		int64 BuffersReused = 0;
+		int64 TexturesAllocated = 0;
+		int64 TexturesReused = 0;
+		int64 PooledBytes = 0;
+		int32 PooledFormats = 0;
+	};
+
+	/** Returns a buffer sized for a tightly packed frame of the given format. */
+	TArray64<uint8> AcquireBuffer(const FDolbyIODebugFrameFormat& Format);
+	void ReleaseBuffer(const FDolbyIODebugFrameFormat& Format, TArray64<uint8>&& Buffer);
+
+	FTextureRHIRef AcquireTexture(const FDolbyIODebugFrameFormat& Format);
+	void ReleaseTexture(const FDolbyIODebugFrameFormat& Format, FTextureRHIRef&& Texture);
+
+	/** Frees the formats that have been idle for longer than IdleLifetime, and the oldest ones above MaxFormats. */
+	void Trim(double IdleLifetime, int32 MaxFormats);
+	void Empty();
+
+	FStats GetStats() const;
+
+private:
+	struct FBucket
+	{
+		TArray<TArray64<uint8>> Buffers;
+		TArray<FTextureRHIRef> Textures;
+		double LastUsedTime = 0.0;
+	};
+
+	FBucket& FindOrAddBucket(const FDolbyIODebugFrameFormat& Format);
+
+	mutable FCriticalSection CriticalSection;
+	TMap<FDolbyIODebugFrameFormat, FBucket> Buckets;
+	FStats Stats;
+};
+
+/**
+ * A submitted frame held past the call that submitted it: its planes copied into a buffer of the pool, or a reference
+ * to its native texture. Queues of frames that are presented later hold these.
+ */
+struct DOLBYIODEBUG_API FDolbyIODebugPooledFrame
+{
+	FDolbyIODebugFrameFormat Format;
+	TArray64<uint8> Buffer;
+	FTextureRHIRef NativeTexture;
+	double CaptureTime = 0.0;
+
+	/** Copies Frame, which only has to be valid for the duration of the call. */
+	void CopyFrom(const FDolbyIODebugVideoFrame& Frame, FDolbyIODebugFramePool& Pool);
+
+	/** A frame over the held copy, valid until Release. */
+	FDolbyIODebugVideoFrame GetFrame() const;
+
+	/** Returns the buffer to the pool and drops the texture reference. */
+	void Release(FDolbyIODebugFramePool& Pool);
+};
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugFrameScheduler.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Scheduled frame"), STAT_DolbyIOVideoScheduledFrame, STATGROUP_DolbyIOVideo);
+
+namespace DolbyIODebugFrameScheduler
+{
+	int32 MaxQueuedFrames = 2;
+	FAutoConsoleVariableRef CVarMaxQueuedFrames(TEXT("DolbyIODebug.FrameScheduler.MaxQueuedFrames"), MaxQueuedFrames,
+	                                            TEXT("Frames a track queues while its sink is busy before it drops the oldest."));
+}
+
+TSharedRef<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe> FDolbyIODebugFrameTrack::Open(const FString& Name, FSink Sink, int32 TelemetrySource)
+{
+	return MakeShareable(new FDolbyIODebugFrameTrack(Name, MoveTemp(Sink), TelemetrySource));
+}
+
+FDolbyIODebugFrameTrack::FDolbyIODebugFrameTrack(const FString& InName, FSink InSink, int32 InTelemetrySource)
+    : Name(InName)
+    , Sink(MoveTemp(InSink))
+    , TelemetrySource(InTelemetrySource)
+    , Pool(FDolbyIODebugModule::Get().GetFramePool())
+    , Pipe(*Name)
+{
+}
+
+FDolbyIODebugFrameTrack::~FDolbyIODebugFrameTrack()
+{
+	// Waiting for the pipe from one of its own tasks would never return
+	if (ensureMsgf(bClosed.load(std::memory_order_relaxed) || !Pipe.IsInContext(), TEXT("Frame track %s was released by its sink"),
+	               *Name))
+	{
+		Close();
+	}
+}
+
+void FDolbyIODebugFrameTrack::Submit(const FDolbyIODebugVideoFrame& Frame)
+{
+	if (bClosed.load(std::memory_order_relaxed) || !Frame.IsValid())
+	{
+		return;
+	}
+
+	FDolbyIODebugPooledFrame QueuedFrame;
+	QueuedFrame.CopyFrom(Frame, *Pool);
+
+	TOptional<FDolbyIODebugPooledFrame> DroppedFrame;
+	bool bLaunchDrain = false;
+	{
+		FScopeLock Lock(&CriticalSection);
+		if (Queue.Num() >= FMath::Max(DolbyIODebugFrameScheduler::MaxQueuedFrames, 1))
+		{
+			DroppedFrame.Emplace(MoveTemp(Queue[0]));
+			Queue.RemoveAt(0, 1, false);
+		}
+		Queue.Add(MoveTemp(QueuedFrame));
+		bLaunchDrain = !bDrainScheduled;
+		bDrainScheduled = true;
+	}
+
+	if (DroppedFrame)
+	{
+		DroppedFrame->Release(*Pool);
+		++FramesDropped;
+		FDolbyIODebugVideoTelemetry::Get().RecordDroppedFrame(TelemetrySource);
+	}
+
+	// One drain task at a time: it keeps running while frames keep coming, and the pipe orders it after the last one.
+	// Holding the track weakly lets the owner release it, Close having waited for the task.
+	if (bLaunchDrain)
+	{
+		Pipe.Launch(*Name,
+		            [WeakThis = TWeakPtr<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe>(AsShared())]
+		            {
+			            if (TSharedPtr<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			            {
+				            This->Drain();
+			            }
+		            });
+	}
+}
+
+void FDolbyIODebugFrameTrack::Close()
+{
+	bClosed = true;
+
+	TArray<FDolbyIODebugPooledFrame> DroppedFrames;
+	{
+		FScopeLock Lock(&CriticalSection);
+		DroppedFrames = MoveTemp(Queue);
+	}
+	for (FDolbyIODebugPooledFrame& DroppedFrame : DroppedFrames)
+	{
+		DroppedFrame.Release(*Pool);
+	}
+
+	Pipe.WaitUntilEmpty();
+}
+
+void FDolbyIODebugFrameTrack::Drain()
+{
+	for (;;)
+	{
+		FDolbyIODebugPooledFrame QueuedFrame;
+		{
+			FScopeLock Lock(&CriticalSection);
+			if (Queue.Num() == 0 || bClosed.load(std::memory_order_relaxed))
+			{
+				bDrainScheduled = false;
+				return;
+			}
+			QueuedFrame = MoveTemp(Queue[0]);
+			Queue.RemoveAt(0, 1, false);
+		}
+
+		{
+			SCOPE_CYCLE_COUNTER(STAT_DolbyIOVideoScheduledFrame);
+			Sink(QueuedFrame.GetFrame());
+		}
+		QueuedFrame.Release(*Pool);
+	}
+}
@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebugVideoFrame.h"
+#include "HAL/CriticalSection.h"
+#include "Tasks/Pipe.h"
+
+#include <atomic>
+
+/**
+ * Moves the conversion and upload work of one video track off the thread that delivers its frames.
+ *
+ * Submitted frames are copied into pooled memory and queued, and the sink is called with them on the UE::Tasks
+ * workers, which steal work from each other and are sized to the cores of the machine, so a busy track never holds
+ * up the others nor its delivering thread. The track's pipe runs its frames one at a time and in order. When the sink
+ * falls behind by more than DolbyIODebug.FrameScheduler.MaxQueuedFrames, the oldest queued frame is dropped: a late
+ * frame is worth less than the next one. UDolbyIODebugMediaRecording replays its streams through a track each.
+ *
+ * The tasks only hold the track weakly, so the owner must Close it, from outside the sink, before releasing it.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugFrameTrack : public TSharedFromThis<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe>
+{
+public:
+	using FSink = TFunction<void(const FDolbyIODebugVideoFrame&)>;
+
+	/** Frames dropped by the track are recorded under TelemetrySource, if given. */
+	static TSharedRef<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe> Open(const FString& Name, FSink Sink, int32 TelemetrySource = INDEX_NONE);
+
+	~FDolbyIODebugFrameTrack();
+
+	/** Queues a frame. Any thread; the frame only has to be valid for the duration of the call. */
+	void Submit(const FDolbyIODebugVideoFrame& Frame);
+
+	/**
+	 * Drops the queued frames and waits for the sink to return, after which it is never called again. Must not be
+	 * called from the sink.
+	 */
+	void Close();
+
+	int64 GetFramesDropped() const { return FramesDropped.load(std::memory_order_relaxed); }
+
+private:
+	FDolbyIODebugFrameTrack(const FString& InName, FSink InSink, int32 InTelemetrySource);
+
+	void Drain();
+
+	/** Declared before the pipe, which keeps a pointer to it. */
+	const FString Name;
+	const FSink Sink;
+	const int32 TelemetrySource;
+	TSharedRef<FDolbyIODebugFramePool, ESPMode::ThreadSafe> Pool;
+	UE::Tasks::FPipe Pipe;
+
+	FCriticalSection CriticalSection;
+	TArray<FDolbyIODebugPooledFrame> Queue;
+	bool bDrainScheduled = false;
+
+	std::atomic<bool> bClosed{false};
+	std::atomic<int64> FramesDropped{0};
+};
@@ -2,4 +2,49 @@
 
 
 #include "DolbyIODebugGameModeBase.h"
+#include "DolbyIODebugRenderProfile.h"
+#include "DolbyIODebugSpatialBatcherComponent.h"
 
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+ADolbyIODebugGameModeBase::ADolbyIODebugGameModeBase()
+{
+	SpatialBatcher = CreateDefaultSubobject<UDolbyIODebugSpatialBatcherComponent>(TEXT("SpatialBatcher"));
+}
+
+void ADolbyIODebugGameModeBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FString CommandLineProfile;
+	if (FParse::Value(FCommandLine::Get(), TEXT("DolbyIORenderProfile="), CommandLineProfile))
+	{
+		RenderProfile = CommandLineProfile == TEXT("None") ? FString() : CommandLineProfile;
+	}
+	SetRenderProfileApplied(true);
+}
+
+void ADolbyIODebugGameModeBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The next map's game mode applies its own
+	SetRenderProfileApplied(false);
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADolbyIODebugGameModeBase::SetRenderProfileApplied(bool bApplied)
+{
+	if (!bApplied)
+	{
+		FDolbyIODebugRenderProfile::Restore();
+	}
+	else if (!RenderProfile.IsEmpty() && !IsRenderProfileApplied())
+	{
+		FDolbyIODebugRenderProfile::Apply(RenderProfile);
+	}
+}
+
+bool ADolbyIODebugGameModeBase::IsRenderProfileApplied() const
+{
+	return !RenderProfile.IsEmpty() && FDolbyIODebugRenderProfile::GetActiveProfileName() == RenderProfile;
+}
@@ -6,12 +6,41 @@
 #include "GameFramework/GameModeBase.h"
 #include "DolbyIODebugGameModeBase.generated.h"
 
+class UDolbyIODebugSpatialBatcherComponent;
+
 /**
- * 
+ * Game mode of the test bed. Owns the services shared by every player of the world, such as the batching of their
+ * spatial audio updates, and applies the render profile media benchmarks run under for as long as it plays.
  */
 UCLASS()
 class DOLBYIODEBUG_API ADolbyIODebugGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	ADolbyIODebugGameModeBase();
+
+	/**
+	 * Render profile applied while the world plays, see FDolbyIODebugRenderProfile. Empty keeps the project's rendering.
+	 * -DolbyIORenderProfile=<Name> on the command line overrides it, and None keeps the project's rendering.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString RenderProfile = TEXT("MediaBenchmark");
+
+	/** Applies RenderProfile, or restores the project's rendering to measure the media pipeline under a real load. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void SetRenderProfileApplied(bool bApplied);
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsRenderProfileApplied() const;
+
+	UDolbyIODebugSpatialBatcherComponent* GetSpatialBatcher() const { return SpatialBatcher; }
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Dolby.io Debug")
+	TObjectPtr<UDolbyIODebugSpatialBatcherComponent> SpatialBatcher;
 };
@@ -0,0 +1,213 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugJitterBuffer.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Jitter buffer depth"), STAT_DolbyIOVideoJitterBufferDepth, STATGROUP_DolbyIOVideo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Jitter buffer late frames"), STAT_DolbyIOVideoJitterBufferLate, STATGROUP_DolbyIOVideo);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Jitter buffer dropped frames"), STAT_DolbyIOVideoJitterBufferDropped, STATGROUP_DolbyIOVideo);
+
+namespace DolbyIODebugJitterBuffer
+{
+	float TargetLatencyMs = 50.0f;
+	FAutoConsoleVariableRef CVarTargetLatency(TEXT("DolbyIODebug.JitterBuffer.TargetLatencyMs"), TargetLatencyMs,
+	                                          TEXT("Delay added to the shortest transit before the frames of a remote track are presented."));
+
+	float Smoothness = 3.0f;
+	FAutoConsoleVariableRef CVarSmoothness(TEXT("DolbyIODebug.JitterBuffer.Smoothness"), Smoothness,
+	                                       TEXT("Multiple of the measured jitter the playout delay grows to if it is over the target latency, "
+	                                            "0 to keep the target latency whatever the jitter."));
+
+	int32 MaxFrames = 8;
+	FAutoConsoleVariableRef CVarMaxFrames(TEXT("DolbyIODebug.JitterBuffer.MaxFrames"), MaxFrames,
+	                                      TEXT("Frames a jitter buffer holds at most before it drops the oldest."));
+
+	/** Weight of the last transit variation in the jitter, as in RFC 3550. */
+	constexpr double JitterSmoothing = 1.0 / 16.0;
+	/** Rate at which the shortest transit forgets old minimums, so that a route getting slower is followed. */
+	constexpr double MinTransitDrift = 0.002;
+
+	FCriticalSection OpenBuffersCriticalSection;
+	TArray<TWeakPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>> OpenBuffers;
+
+	TArray<TSharedPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>> GetOpenBuffers()
+	{
+		TArray<TSharedPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>> Buffers;
+		FScopeLock Lock(&OpenBuffersCriticalSection);
+		for (const TWeakPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>& OpenBuffer : OpenBuffers)
+		{
+			if (TSharedPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe> Buffer = OpenBuffer.Pin())
+			{
+				Buffers.Add(MoveTemp(Buffer));
+			}
+		}
+		return Buffers;
+	}
+
+	FAutoConsoleCommand CmdStats(TEXT("DolbyIODebug.JitterBuffer.Stats"), TEXT("Logs the counters of every open jitter buffer."),
+	                             FConsoleCommandDelegate::CreateLambda(
+	                                 []
+	                                 {
+		                                 for (const TSharedPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>& Buffer : GetOpenBuffers())
+		                                 {
+			                                 const FDolbyIODebugJitterStats Stats = Buffer->GetStats();
+			                                 UE_LOG(LogDolbyIODebug, Display,
+			                                        TEXT("%s: depth %d, jitter %.1f ms, delay %.1f ms, %lld presented, %lld late, %lld dropped"),
+			                                        *Buffer->GetName(), Stats.Depth, Stats.JitterMs, Stats.PlayoutDelayMs, Stats.FramesPresented,
+			                                        Stats.FramesLate, Stats.FramesDropped);
+		                                 }
+	                                 }));
+}
+
+TSharedRef<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe> FDolbyIODebugJitterBuffer::Open(const FString& Name, FSink Sink, int32 TelemetrySource)
+{
+	TSharedRef<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe> Buffer =
+	    MakeShareable(new FDolbyIODebugJitterBuffer(Name, MoveTemp(Sink), TelemetrySource));
+	FScopeLock Lock(&DolbyIODebugJitterBuffer::OpenBuffersCriticalSection);
+	DolbyIODebugJitterBuffer::OpenBuffers.Add(Buffer);
+	return Buffer;
+}
+
+FDolbyIODebugJitterBuffer::FDolbyIODebugJitterBuffer(const FString& InName, FSink InSink, int32 InTelemetrySource)
+    : Name(InName), Sink(MoveTemp(InSink)), TelemetrySource(InTelemetrySource), Pool(FDolbyIODebugModule::Get().GetFramePool())
+{
+}
+
+FDolbyIODebugJitterBuffer::~FDolbyIODebugJitterBuffer()
+{
+	{
+		FScopeLock Lock(&DolbyIODebugJitterBuffer::OpenBuffersCriticalSection);
+		DolbyIODebugJitterBuffer::OpenBuffers.RemoveAll([](const TWeakPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>& OpenBuffer)
+		                                                { return !OpenBuffer.IsValid(); });
+	}
+	for (FBufferedFrame& BufferedFrame : Frames)
+	{
+		BufferedFrame.Release(*Pool);
+	}
+}
+
+void FDolbyIODebugJitterBuffer::Submit(const FDolbyIODebugVideoFrame& Frame)
+{
+	using namespace DolbyIODebugJitterBuffer;
+
+	if (!Frame.IsValid())
+	{
+		return;
+	}
+
+	const double ArrivalTime = FPlatformTime::Seconds();
+	FBufferedFrame BufferedFrame;
+	BufferedFrame.CopyFrom(Frame, *Pool);
+	if (BufferedFrame.CaptureTime <= 0.0)
+	{
+		BufferedFrame.CaptureTime = ArrivalTime;
+	}
+
+	TOptional<FBufferedFrame> DroppedFrame;
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		// The capture and arrival clocks only need to tick at the same rate: the transit is relative to its minimum
+		const double Transit = ArrivalTime - BufferedFrame.CaptureTime;
+		MinTransit = Transit < MinTransit ? Transit : MinTransit + (Transit - MinTransit) * MinTransitDrift;
+		if (LastTransit >= 0.0)
+		{
+			Jitter += (FMath::Abs(Transit - LastTransit) - Jitter) * JitterSmoothing;
+		}
+		LastTransit = Transit;
+
+		const double PlayoutDelay = FMath::Max(TargetLatencyMs / 1000.0, Smoothness * Jitter);
+		// The playout delay and shortest transit move between frames, so a frame could otherwise be due before the one
+		// queued ahead of it and wait behind it, or be presented after a newer one
+		BufferedFrame.PresentationTime = FMath::Max(BufferedFrame.CaptureTime + MinTransit + PlayoutDelay, LastPresentationTime);
+		LastPresentationTime = BufferedFrame.PresentationTime;
+		Stats.JitterMs = static_cast<float>(Jitter * 1000.0);
+		Stats.PlayoutDelayMs = static_cast<float>(PlayoutDelay * 1000.0);
+		if (BufferedFrame.PresentationTime < ArrivalTime)
+		{
+			++Stats.FramesLate;
+			INC_DWORD_STAT(STAT_DolbyIOVideoJitterBufferLate);
+		}
+
+		if (Frames.Num() >= FMath::Max(MaxFrames, 1))
+		{
+			DroppedFrame.Emplace(MoveTemp(Frames[0]));
+			Frames.RemoveAt(0, 1, false);
+			++Stats.FramesDropped;
+		}
+		Frames.Add(MoveTemp(BufferedFrame));
+		Stats.Depth = Frames.Num();
+	}
+
+	if (DroppedFrame)
+	{
+		DroppedFrame->Release(*Pool);
+		INC_DWORD_STAT(STAT_DolbyIOVideoJitterBufferDropped);
+		FDolbyIODebugVideoTelemetry::Get().RecordDroppedFrame(TelemetrySource);
+	}
+}
+
+FDolbyIODebugJitterStats FDolbyIODebugJitterBuffer::GetStats() const
+{
+	FScopeLock Lock(&CriticalSection);
+	return Stats;
+}
+
+void FDolbyIODebugJitterBuffer::PresentAll(float DeltaTime)
+{
+	check(IsInGameThread());
+
+	// The frame being started is displayed about one frame from now, at the next vsync
+	const double DisplayTime = FPlatformTime::Seconds() + DeltaTime;
+	int32 TotalDepth = 0;
+	for (const TSharedPtr<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>& Buffer : DolbyIODebugJitterBuffer::GetOpenBuffers())
+	{
+		Buffer->Present(DisplayTime);
+		TotalDepth += Buffer->GetStats().Depth;
+	}
+	SET_DWORD_STAT(STAT_DolbyIOVideoJitterBufferDepth, TotalDepth);
+}
+
+void FDolbyIODebugJitterBuffer::Present(double DisplayTime)
+{
+	TArray<FBufferedFrame, TInlineAllocator<4>> DueFrames;
+	{
+		FScopeLock Lock(&CriticalSection);
+		int32 NumDue = 0;
+		while (NumDue < Frames.Num() && Frames[NumDue].PresentationTime <= DisplayTime)
+		{
+			++NumDue;
+		}
+		if (NumDue == 0)
+		{
+			return;
+		}
+
+		for (int32 Index = 0; Index < NumDue; ++Index)
+		{
+			DueFrames.Add(MoveTemp(Frames[Index]));
+		}
+		Frames.RemoveAt(0, NumDue, false);
+		Stats.FramesDropped += NumDue - 1;
+		++Stats.FramesPresented;
+		Stats.Depth = Frames.Num();
+	}
+
+	// Only the newest due frame is shown, the others would be replaced before reaching the screen
+	for (int32 Index = 0; Index < DueFrames.Num() - 1; ++Index)
+	{
+		DueFrames[Index].Release(*Pool);
+		INC_DWORD_STAT(STAT_DolbyIOVideoJitterBufferDropped);
+		FDolbyIODebugVideoTelemetry::Get().RecordDroppedFrame(TelemetrySource);
+	}
+
+	FBufferedFrame& BufferedFrame = DueFrames.Last();
+	Sink(BufferedFrame.GetFrame());
+	BufferedFrame.Release(*Pool);
+}
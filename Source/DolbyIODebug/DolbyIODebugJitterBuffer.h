@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebugVideoFrame.h"
+#include "HAL/CriticalSection.h"
+
+/** Counters of a jitter buffer, to tune the target latency and smoothness of a deployment. */
+struct FDolbyIODebugJitterStats
+{
+	/** Frames waiting for their presentation time. */
+	int32 Depth = 0;
+	/** Variation of the transit time between consecutive frames, smoothed. */
+	float JitterMs = 0.0f;
+	/** Delay added to the shortest transit before a frame is presented. */
+	float PlayoutDelayMs = 0.0f;
+	int64 FramesPresented = 0;
+	/** Arrived after their presentation time. They are still presented if nothing newer is due. */
+	int64 FramesLate = 0;
+	/** Replaced by a newer frame due on the same display frame, or pushed out of a full buffer. */
+	int64 FramesDropped = 0;
+};
+
+/**
+ * Evens out the arrival of the frames of one remote track and presents them at display frame boundaries.
+ *
+ * Arriving frames are copied into pooled memory and given a presentation time: their capture time plus the shortest
+ * transit seen recently plus a playout delay of DolbyIODebug.JitterBuffer.TargetLatencyMs or, if larger, Smoothness
+ * times the measured jitter, but never earlier than the frame before. Frames without a capture time use their arrival
+ * time. Once per game frame, which the display paces under vsync, the newest frame due by the time that frame is
+ * displayed is handed to the sink and the older due ones are dropped, so the texture is updated before the render
+ * thread starts the frame rather than in the middle of it. Raise the target latency for smoother motion, lower it for
+ * fresher frames.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugJitterBuffer : public TSharedFromThis<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>
+{
+public:
+	using FSink = TFunction<void(const FDolbyIODebugVideoFrame&)>;
+
+	/** The sink is called on the game thread. Frames dropped are recorded under TelemetrySource, if given. */
+	static TSharedRef<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe> Open(const FString& Name, FSink Sink, int32 TelemetrySource = INDEX_NONE);
+
+	~FDolbyIODebugJitterBuffer();
+
+	/** Queues a frame. Any thread; the frame only has to be valid for the duration of the call. */
+	void Submit(const FDolbyIODebugVideoFrame& Frame);
+
+	FDolbyIODebugJitterStats GetStats() const;
+	const FString& GetName() const { return Name; }
+
+	/** Game thread only, once per frame: presents the frames due in every open jitter buffer. */
+	static void PresentAll(float DeltaTime);
+
+private:
+	struct FBufferedFrame : FDolbyIODebugPooledFrame
+	{
+		double PresentationTime = 0.0;
+	};
+
+	FDolbyIODebugJitterBuffer(const FString& InName, FSink InSink, int32 InTelemetrySource);
+
+	void Present(double DisplayTime);
+
+	const FString Name;
+	const FSink Sink;
+	const int32 TelemetrySource;
+	TSharedRef<FDolbyIODebugFramePool, ESPMode::ThreadSafe> Pool;
+
+	mutable FCriticalSection CriticalSection;
+	/** In arrival order, and so by presentation time, which never goes back from one frame to the next. */
+	TArray<FBufferedFrame> Frames;
+	FDolbyIODebugJitterStats Stats;
+	double MinTransit = TNumericLimits<double>::Max();
+	double LastTransit = -1.0;
+	double Jitter = 0.0;
+	/** Presentation time of the last frame submitted, the earliest the next one can be given. */
+	double LastPresentationTime = 0.0;
+};
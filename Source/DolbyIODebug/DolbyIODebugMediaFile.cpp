@@ -0,0 +1,414 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugMediaFile.h"
+#include "DolbyIODebug.h"
+
+#include "Async/MappedFileHandle.h"
+#include "Containers/Queue.h"
+#include "DolbyIOSubsystem.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+namespace DolbyIODebugMediaFile
+{
+	struct FFileHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+	};
+
+	constexpr int64 Alignment = 8;
+
+	/** Counts the thread in NumQueueing while it queues a record, if the recording is open. */
+	class FScopedQueueing
+	{
+	public:
+		FScopedQueueing(std::atomic<int32>& InNumQueueing, const std::atomic<bool>& bOpen)
+		    : NumQueueing(InNumQueueing)
+		{
+			++NumQueueing;
+			bIsOpen = bOpen.load();
+		}
+
+		~FScopedQueueing() { --NumQueueing; }
+
+		bool IsOpen() const { return bIsOpen; }
+
+	private:
+		std::atomic<int32>& NumQueueing;
+		bool bIsOpen = false;
+	};
+
+	void AppendString(TArray64<uint8>& Buffer, const FString& String, bool bWithLength)
+	{
+		const FTCHARToUTF8 Utf8(*String);
+		if (bWithLength)
+		{
+			const uint32 Length = Utf8.Length();
+			Buffer.Append(reinterpret_cast<const uint8*>(&Length), sizeof(Length));
+		}
+		Buffer.Append(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+	}
+
+	/** Reads a length-prefixed string, returns false if it runs past End. */
+	bool ReadString(const uint8*& Cursor, const uint8* End, FString& OutString)
+	{
+		uint32 Length = 0;
+		if (End - Cursor < static_cast<int64>(sizeof(Length)))
+		{
+			return false;
+		}
+		FMemory::Memcpy(&Length, Cursor, sizeof(Length));
+		Cursor += sizeof(Length);
+		if (End - Cursor < static_cast<int64>(Length))
+		{
+			return false;
+		}
+		OutString = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Cursor), Length));
+		Cursor += Length;
+		return true;
+	}
+}
+
+/** Drains the queued records into the file, and flushes and closes it once stopped. */
+class FDolbyIODebugMediaWriteThread : public FRunnable
+{
+public:
+	FDolbyIODebugMediaWriteThread(TUniquePtr<IFileHandle> InFile, std::atomic<int64>& InBytesWritten)
+	    : File(MoveTemp(InFile))
+	    , BytesWritten(InBytesWritten)
+	{
+		Thread.Reset(FRunnableThread::Create(this, TEXT("DolbyIODebugMediaWrite"), 0, TPri_BelowNormal));
+	}
+
+	/** Writes what is still queued before returning. */
+	~FDolbyIODebugMediaWriteThread() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+		}
+	}
+
+	void Enqueue(TArray64<uint8>&& Record)
+	{
+		Records.Enqueue(MoveTemp(Record));
+		WakeUp->Trigger();
+	}
+
+	uint32 Run() override
+	{
+		while (!bStopping)
+		{
+			WakeUp->Wait();
+			WriteQueued();
+		}
+		WriteQueued();
+		File->Flush();
+		return 0;
+	}
+
+	void Stop() override
+	{
+		bStopping = true;
+		WakeUp->Trigger();
+	}
+
+private:
+	void WriteQueued()
+	{
+		TArray64<uint8> Record;
+		while (Records.Dequeue(Record))
+		{
+			File->Write(Record.GetData(), Record.Num());
+			BytesWritten += Record.Num();
+		}
+	}
+
+	TUniquePtr<IFileHandle> File;
+	std::atomic<int64>& BytesWritten;
+	TQueue<TArray64<uint8>, EQueueMode::Mpsc> Records;
+	FEventRef WakeUp;
+	std::atomic<bool> bStopping{false};
+	TUniquePtr<FRunnableThread> Thread;
+};
+
+FDolbyIODebugMediaWriter& FDolbyIODebugMediaWriter::Get()
+{
+	static FDolbyIODebugMediaWriter Instance;
+	return Instance;
+}
+
+bool FDolbyIODebugMediaWriter::Open(const FString& Path)
+{
+	using namespace DolbyIODebugMediaFile;
+
+	FScopeLock Lock(&CriticalSection);
+	if (WriteThread)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Already recording media, cannot record to %s as well"), *Path);
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+	TUniquePtr<IFileHandle> File(PlatformFile.OpenWrite(*Path));
+	if (!File)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to open %s to record media"), *Path);
+		return false;
+	}
+
+	const FFileHeader FileHeader{Magic, Version};
+	File->Write(reinterpret_cast<const uint8*>(&FileHeader), sizeof(FileHeader));
+	StartTime = FPlatformTime::Seconds();
+	BytesWritten = sizeof(FileHeader);
+	WriteThread = MakeUnique<FDolbyIODebugMediaWriteThread>(MoveTemp(File), BytesWritten);
+	bOpen = true;
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Recording media to %s"), *Path);
+	return true;
+}
+
+void FDolbyIODebugMediaWriter::Close()
+{
+	FScopeLock Lock(&CriticalSection);
+	if (!WriteThread)
+	{
+		return;
+	}
+
+	// Once no thread is past its check of bOpen, no record can be queued behind the back of the write thread
+	bOpen = false;
+	while (NumQueueing.load() > 0)
+	{
+		FPlatformProcess::Yield();
+	}
+	WriteThread.Reset();
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Recorded %.1f MB of media in %.1f s"), BytesWritten.load() / (1024.0 * 1024.0),
+	       FPlatformTime::Seconds() - StartTime);
+}
+
+void FDolbyIODebugMediaWriter::WriteVideoFrame(int32 Stream, const FDolbyIODebugVideoFrame& Frame)
+{
+	if (Frame.NativeTexture || !Frame.IsValid())
+	{
+		return;
+	}
+
+	const DolbyIODebugMediaFile::FScopedQueueing Queueing(NumQueueing, bOpen);
+	if (!Queueing.IsOpen())
+	{
+		return;
+	}
+
+	const FDolbyIODebugFrameFormat Format = Frame.GetFormat();
+	const FDolbyIODebugMediaVideoFrameHeader FrameHeader{Stream, Format.Width, Format.Height, static_cast<uint32>(Format.PixelFormat)};
+	TArray64<uint8> Record = BeginRecord(EDolbyIODebugMediaRecordType::VideoFrame, sizeof(FrameHeader) + Format.GetSizeBytes());
+	Record.Append(reinterpret_cast<const uint8*>(&FrameHeader), sizeof(FrameHeader));
+	const int64 PlanesOffset = Record.AddUninitialized(Format.GetSizeBytes());
+	Frame.CopyPacked(Record.GetData() + PlanesOffset);
+	QueueRecord(MoveTemp(Record));
+}
+
+void FDolbyIODebugMediaWriter::WriteAudioBuffer(const float* AudioData, int32 NumSamples, int32 NumChannels, int32 SampleRate)
+{
+	if (NumSamples <= 0)
+	{
+		return;
+	}
+
+	const DolbyIODebugMediaFile::FScopedQueueing Queueing(NumQueueing, bOpen);
+	if (!Queueing.IsOpen())
+	{
+		return;
+	}
+
+	const FDolbyIODebugMediaAudioBufferHeader BufferHeader{NumChannels, SampleRate, NumSamples, 0};
+	const int64 SamplesSize = static_cast<int64>(NumSamples) * sizeof(float);
+	TArray64<uint8> Record = BeginRecord(EDolbyIODebugMediaRecordType::AudioBuffer, sizeof(BufferHeader) + SamplesSize);
+	Record.Append(reinterpret_cast<const uint8*>(&BufferHeader), sizeof(BufferHeader));
+	Record.Append(reinterpret_cast<const uint8*>(AudioData), SamplesSize);
+	QueueRecord(MoveTemp(Record));
+}
+
+void FDolbyIODebugMediaWriter::WriteVideoEvent(EDolbyIODebugMediaRecordType Type, const FString& VideoTrackID)
+{
+	const DolbyIODebugMediaFile::FScopedQueueing Queueing(NumQueueing, bOpen);
+	if (!Queueing.IsOpen())
+	{
+		return;
+	}
+
+	TArray64<uint8> Record = BeginRecord(Type, VideoTrackID.Len());
+	DolbyIODebugMediaFile::AppendString(Record, VideoTrackID, false);
+	QueueRecord(MoveTemp(Record));
+}
+
+void FDolbyIODebugMediaWriter::WriteVideoDevices(const TArray<FDolbyIOVideoDevice>& VideoDevices)
+{
+	const DolbyIODebugMediaFile::FScopedQueueing Queueing(NumQueueing, bOpen);
+	if (!Queueing.IsOpen())
+	{
+		return;
+	}
+
+	TArray64<uint8> Record = BeginRecord(EDolbyIODebugMediaRecordType::VideoDevices, 0);
+	const uint32 NumDevices = VideoDevices.Num();
+	Record.Append(reinterpret_cast<const uint8*>(&NumDevices), sizeof(NumDevices));
+	for (const FDolbyIOVideoDevice& VideoDevice : VideoDevices)
+	{
+		DolbyIODebugMediaFile::AppendString(Record, VideoDevice.DisplayName, true);
+		DolbyIODebugMediaFile::AppendString(Record, VideoDevice.UniqueID, true);
+	}
+	QueueRecord(MoveTemp(Record));
+}
+
+TArray64<uint8> FDolbyIODebugMediaWriter::BeginRecord(EDolbyIODebugMediaRecordType Type, int64 ReserveSize) const
+{
+	using namespace DolbyIODebugMediaFile;
+
+	const FDolbyIODebugMediaRecordHeader RecordHeader{Type, 0, FPlatformTime::Seconds() - StartTime};
+	TArray64<uint8> Record;
+	Record.Reserve(sizeof(RecordHeader) + Align(ReserveSize, Alignment));
+	Record.Append(reinterpret_cast<const uint8*>(&RecordHeader), sizeof(RecordHeader));
+	return Record;
+}
+
+void FDolbyIODebugMediaWriter::QueueRecord(TArray64<uint8>&& Record)
+{
+	using namespace DolbyIODebugMediaFile;
+
+	const uint32 PayloadSize = static_cast<uint32>(Record.Num() - sizeof(FDolbyIODebugMediaRecordHeader));
+	FMemory::Memcpy(Record.GetData() + STRUCT_OFFSET(FDolbyIODebugMediaRecordHeader, PayloadSize), &PayloadSize, sizeof(PayloadSize));
+	Record.AddZeroed(Align(static_cast<int64>(PayloadSize), Alignment) - PayloadSize);
+	WriteThread->Enqueue(MoveTemp(Record));
+}
+
+FDolbyIODebugMediaReader::~FDolbyIODebugMediaReader()
+{
+	// The region must go before the file it maps
+	Records.Reset();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool FDolbyIODebugMediaReader::Open(const FString& Path)
+{
+	using namespace DolbyIODebugMediaFile;
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	MappedRegion.Reset(MappedFile ? MappedFile->MapRegion() : nullptr);
+	if (!MappedRegion || MappedRegion->GetMappedSize() < static_cast<int64>(sizeof(FFileHeader)))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to map the media recording %s"), *Path);
+		return false;
+	}
+
+	const uint8* Begin = MappedRegion->GetMappedPtr();
+	const uint8* End = Begin + MappedRegion->GetMappedSize();
+	FFileHeader FileHeader;
+	FMemory::Memcpy(&FileHeader, Begin, sizeof(FileHeader));
+	if (FileHeader.Magic != Magic || FileHeader.Version != Version)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("%s is not a media recording of version %u"), *Path, Version);
+		return false;
+	}
+
+	const uint8* Cursor = Begin + sizeof(FFileHeader);
+	while (End - Cursor >= static_cast<int64>(sizeof(FDolbyIODebugMediaRecordHeader)))
+	{
+		const FDolbyIODebugMediaRecordHeader* Header = reinterpret_cast<const FDolbyIODebugMediaRecordHeader*>(Cursor);
+		const uint8* Payload = Cursor + sizeof(FDolbyIODebugMediaRecordHeader);
+		if (End - Payload < Header->PayloadSize)
+		{
+			UE_LOG(LogDolbyIODebug, Warning, TEXT("%s ends with an incomplete record, replaying up to it"), *Path);
+			break;
+		}
+		Records.Add({Header, Payload});
+		Cursor = Payload + Align(static_cast<int64>(Header->PayloadSize), Alignment);
+	}
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Mapped %d records over %.1f s from %s"), Records.Num(), GetDuration(), *Path);
+	return true;
+}
+
+FDolbyIODebugVideoFrame FDolbyIODebugMediaReader::ReadVideoFrame(const FRecord& Record, int32& OutStream)
+{
+	check(Record.Header->Type == EDolbyIODebugMediaRecordType::VideoFrame);
+
+	FDolbyIODebugMediaVideoFrameHeader FrameHeader;
+	if (Record.Header->PayloadSize < sizeof(FrameHeader))
+	{
+		return {};
+	}
+	FMemory::Memcpy(&FrameHeader, Record.Payload, sizeof(FrameHeader));
+	if (FrameHeader.Width <= 0 || FrameHeader.Height <= 0 || FrameHeader.PixelFormat > static_cast<uint32>(EDolbyIODebugPixelFormat::I420))
+	{
+		return {};
+	}
+	const FDolbyIODebugFrameFormat Format{FrameHeader.Width, FrameHeader.Height, static_cast<EDolbyIODebugPixelFormat>(FrameHeader.PixelFormat)};
+	if (Record.Header->PayloadSize < sizeof(FrameHeader) + Format.GetSizeBytes())
+	{
+		return {};
+	}
+
+	OutStream = FrameHeader.Stream;
+	return FDolbyIODebugVideoFrame::MakePacked(Format, Record.Payload + sizeof(FrameHeader));
+}
+
+bool FDolbyIODebugMediaReader::ReadAudioBuffer(const FRecord& Record, FDolbyIODebugMediaAudioBufferHeader& OutHeader,
+                                               const float*& OutSamples)
+{
+	check(Record.Header->Type == EDolbyIODebugMediaRecordType::AudioBuffer);
+
+	if (Record.Header->PayloadSize < sizeof(OutHeader))
+	{
+		return false;
+	}
+	FMemory::Memcpy(&OutHeader, Record.Payload, sizeof(OutHeader));
+	if (OutHeader.NumChannels <= 0 || OutHeader.SampleRate <= 0 || OutHeader.NumSamples < 0 ||
+	    Record.Header->PayloadSize < sizeof(OutHeader) + static_cast<int64>(OutHeader.NumSamples) * sizeof(float))
+	{
+		return false;
+	}
+
+	OutSamples = reinterpret_cast<const float*>(Record.Payload + sizeof(OutHeader));
+	return true;
+}
+
+FString FDolbyIODebugMediaReader::ReadVideoEvent(const FRecord& Record)
+{
+	return FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Record.Payload), Record.Header->PayloadSize));
+}
+
+TArray<FDolbyIOVideoDevice> FDolbyIODebugMediaReader::ReadVideoDevices(const FRecord& Record)
+{
+	check(Record.Header->Type == EDolbyIODebugMediaRecordType::VideoDevices);
+
+	TArray<FDolbyIOVideoDevice> VideoDevices;
+	const uint8* Cursor = Record.Payload;
+	const uint8* End = Record.Payload + Record.Header->PayloadSize;
+	uint32 NumDevices = 0;
+	if (End - Cursor < static_cast<int64>(sizeof(NumDevices)))
+	{
+		return VideoDevices;
+	}
+	FMemory::Memcpy(&NumDevices, Cursor, sizeof(NumDevices));
+	Cursor += sizeof(NumDevices);
+
+	for (uint32 Index = 0; Index < NumDevices; ++Index)
+	{
+		FDolbyIOVideoDevice VideoDevice;
+		if (!DolbyIODebugMediaFile::ReadString(Cursor, End, VideoDevice.DisplayName) ||
+		    !DolbyIODebugMediaFile::ReadString(Cursor, End, VideoDevice.UniqueID))
+		{
+			break;
+		}
+		VideoDevices.Add(MoveTemp(VideoDevice));
+	}
+	return VideoDevices;
+}
@@ -0,0 +1,136 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIODebugVideoFrame.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+struct FDolbyIOVideoDevice;
+
+enum class EDolbyIODebugMediaRecordType : uint32
+{
+	VideoFrame,
+	AudioBuffer,
+	VideoEnabled,
+	VideoDisabled,
+	VideoDevices,
+};
+
+/**
+ * Header of every record of a media recording, followed by PayloadSize bytes and padding up to the next multiple of
+ * eight, so that the payloads can be read in place from the mapped file.
+ *
+ * A recording starts with DolbyIODebugMediaFile::Magic and Version, and is only ever appended to: a recording that
+ * was cut short, by a crash for instance, is read up to its last complete record.
+ */
+struct FDolbyIODebugMediaRecordHeader
+{
+	EDolbyIODebugMediaRecordType Type;
+	uint32 PayloadSize;
+	/** Seconds since the recording started. */
+	double Time;
+};
+
+/** Payload of a VideoFrame record, followed by the tightly packed planes of the frame. */
+struct FDolbyIODebugMediaVideoFrameHeader
+{
+	int32 Stream;
+	int32 Width;
+	int32 Height;
+	uint32 PixelFormat;
+};
+
+/** Payload of an AudioBuffer record, followed by NumSamples interleaved float samples. */
+struct FDolbyIODebugMediaAudioBufferHeader
+{
+	int32 NumChannels;
+	int32 SampleRate;
+	int32 NumSamples;
+	uint32 Padding;
+};
+
+namespace DolbyIODebugMediaFile
+{
+	constexpr uint32 Magic = 0x52494444; // "DDIR"
+	constexpr uint32 Version = 1;
+}
+
+/**
+ * Appends records to a media recording. Any thread.
+ *
+ * Every record is assembled in a buffer of its own, header and padding included, and queued on a lock-free queue that
+ * a write thread drains into the file with a single write per record. The recording threads, the audio render thread
+ * among them, never take a lock nor wait on the disk. The writes go through a plain file handle: the platform layer
+ * only maps files for reading.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugMediaWriter
+{
+public:
+	static FDolbyIODebugMediaWriter& Get();
+
+	bool Open(const FString& Path);
+	void Close();
+	bool IsOpen() const { return bOpen.load(std::memory_order_relaxed); }
+
+	/** Frames that carry a native texture are not recorded: their pixels never reach the CPU. */
+	void WriteVideoFrame(int32 Stream, const FDolbyIODebugVideoFrame& Frame);
+	void WriteAudioBuffer(const float* AudioData, int32 NumSamples, int32 NumChannels, int32 SampleRate);
+	void WriteVideoEvent(EDolbyIODebugMediaRecordType Type, const FString& VideoTrackID);
+	void WriteVideoDevices(const TArray<FDolbyIOVideoDevice>& VideoDevices);
+
+	int64 GetBytesWritten() const { return BytesWritten.load(std::memory_order_relaxed); }
+
+private:
+	/** Starts a record in a buffer of its own, with room for a payload of up to ReserveSize bytes. */
+	TArray64<uint8> BeginRecord(EDolbyIODebugMediaRecordType Type, int64 ReserveSize) const;
+	/** Sets the size of the payload appended since BeginRecord, pads the record and queues it for the write thread. */
+	void QueueRecord(TArray64<uint8>&& Record);
+
+	/** Serializes Open and Close, which the game thread calls; the records are queued without it. */
+	FCriticalSection CriticalSection;
+	TUniquePtr<class FDolbyIODebugMediaWriteThread> WriteThread;
+	double StartTime = 0.0;
+	std::atomic<bool> bOpen{false};
+	/** Threads between their check of bOpen and the queueing of their record, which Close waits for. */
+	std::atomic<int32> NumQueueing{0};
+	std::atomic<int64> BytesWritten{0};
+};
+
+/** Reads a media recording in place from a mapped file. */
+class DOLBYIODEBUG_API FDolbyIODebugMediaReader
+{
+public:
+	struct FRecord
+	{
+		const FDolbyIODebugMediaRecordHeader* Header;
+		const uint8* Payload;
+	};
+
+	~FDolbyIODebugMediaReader();
+
+	bool Open(const FString& Path);
+
+	/** Every complete record, in the order they were written. */
+	const TArray<FRecord>& GetRecords() const { return Records; }
+
+	/** Duration from the first to the last record. */
+	double GetDuration() const { return Records.Num() > 0 ? Records.Last().Header->Time - Records[0].Header->Time : 0.0; }
+
+	/** The frame of a VideoFrame record, an invalid frame if the record is malformed. */
+	static FDolbyIODebugVideoFrame ReadVideoFrame(const FRecord& Record, int32& OutStream);
+	/** The samples of an AudioBuffer record, false if the record is malformed. */
+	static bool ReadAudioBuffer(const FRecord& Record, FDolbyIODebugMediaAudioBufferHeader& OutHeader, const float*& OutSamples);
+	static FString ReadVideoEvent(const FRecord& Record);
+	static TArray<FDolbyIOVideoDevice> ReadVideoDevices(const FRecord& Record);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<FRecord> Records;
+};
@@ -0,0 +1,484 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugMediaRecording.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugFrameScheduler.h"
+#include "DolbyIODebugJitterBuffer.h"
+#include "DolbyIODebugMediaFile.h"
+#include "DolbyIODebugPreviewTexture.h"
+#include "DolbyIODebugSyntheticVideo.h"
+#include "DolbyIODebugVideoEvents.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "Async/Async.h"
+#include "AudioDevice.h"
+#include "Components/AudioComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Sound/SoundWaveProcedural.h"
+#include "UObject/UObjectGlobals.h"
+
+#include <atomic>
+
+namespace DolbyIODebugMediaRecording
+{
+	/** Records the output of the main submix. Kept for the lifetime of the process, like the listeners of the audio load. */
+	class FAudioRecorder : public ISubmixBufferListener
+	{
+	public:
+		void OnNewSubmixBuffer(const USoundSubmix* OwningSubmix, float* AudioData, int32 NumSamples, int32 NumChannels, const int32 SampleRate,
+		                       double AudioClock) override
+		{
+			FDolbyIODebugMediaWriter::Get().WriteAudioBuffer(AudioData, NumSamples, NumChannels, SampleRate);
+		}
+	};
+
+	FAudioRecorder AudioRecorder;
+
+	FAudioDevice* GetMainAudioDevice()
+	{
+		return GEngine ? GEngine->GetMainAudioDeviceRaw() : nullptr;
+	}
+}
+
+/** Feeds the records of a recording back on its own thread, at the pace they were recorded or as fast as possible. */
+class FDolbyIODebugMediaReplayer : public FRunnable
+{
+public:
+	using FOnRecord = TFunction<void(const FDolbyIODebugMediaReader::FRecord&)>;
+	using FFrameSink = TFunction<void(const FDolbyIODebugVideoFrame&)>;
+
+	FDolbyIODebugMediaReplayer(TUniquePtr<FDolbyIODebugMediaReader> InReader, TMap<int32, FFrameSink> InFrameSinks,
+	                           USoundWaveProcedural* InSound, bool bInMaxSpeed, FOnRecord InOnEvent, TFunction<void()> InOnFinished)
+	    : Reader(MoveTemp(InReader))
+	    , FrameSinks(MoveTemp(InFrameSinks))
+	    , Sound(InSound)
+	    , bMaxSpeed(bInMaxSpeed)
+	    , OnEvent(MoveTemp(InOnEvent))
+	    , OnFinished(MoveTemp(InOnFinished))
+	{
+		Thread.Reset(FRunnableThread::Create(this, TEXT("DolbyIODebugMediaReplay"), 0, TPri_Normal));
+	}
+
+	~FDolbyIODebugMediaReplayer() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+		}
+	}
+
+	uint32 Run() override
+	{
+		const TArray<FDolbyIODebugMediaReader::FRecord>& Records = Reader->GetRecords();
+		const double StartTime = FPlatformTime::Seconds();
+		const double FirstRecordTime = Records.Num() > 0 ? Records[0].Header->Time : 0.0;
+		int64 NumFrames = 0;
+		int64 NumBytes = 0;
+		TArray<int16> Pcm;
+
+		for (const FDolbyIODebugMediaReader::FRecord& Record : Records)
+		{
+			if (bStopping)
+			{
+				break;
+			}
+
+			if (!bMaxSpeed)
+			{
+				const double SleepTime = StartTime + (Record.Header->Time - FirstRecordTime) - FPlatformTime::Seconds();
+				if (SleepTime > 0.0)
+				{
+					FPlatformProcess::SleepNoStats(static_cast<float>(SleepTime));
+				}
+			}
+
+			NumBytes += Record.Header->PayloadSize;
+			switch (Record.Header->Type)
+			{
+				case EDolbyIODebugMediaRecordType::VideoFrame:
+				{
+					int32 Stream = INDEX_NONE;
+					FDolbyIODebugVideoFrame Frame = FDolbyIODebugMediaReader::ReadVideoFrame(Record, Stream);
+					if (const FFrameSink* FrameSink = FrameSinks.Find(Stream))
+					{
+						// The recording holds the arrival times, so the jitter of the live session is replayed as is
+						Frame.CaptureTime = StartTime + (Record.Header->Time - FirstRecordTime);
+						(*FrameSink)(Frame);
+						++NumFrames;
+					}
+					break;
+				}
+				case EDolbyIODebugMediaRecordType::AudioBuffer:
+				{
+					// Audio cannot play faster than the device consumes it, so it is only replayed in real time
+					FDolbyIODebugMediaAudioBufferHeader BufferHeader;
+					const float* Samples = nullptr;
+					if (!bMaxSpeed && Sound && FDolbyIODebugMediaReader::ReadAudioBuffer(Record, BufferHeader, Samples) &&
+					    BufferHeader.NumChannels == Sound->NumChannels)
+					{
+						Pcm.SetNumUninitialized(BufferHeader.NumSamples, false);
+						for (int32 Index = 0; Index < BufferHeader.NumSamples; ++Index)
+						{
+							Pcm[Index] = static_cast<int16>(FMath::Clamp(Samples[Index], -1.0f, 1.0f) * 32767.0f);
+						}
+						Sound->QueueAudio(reinterpret_cast<const uint8*>(Pcm.GetData()), Pcm.Num() * sizeof(int16));
+					}
+					break;
+				}
+				case EDolbyIODebugMediaRecordType::VideoEnabled:
+				case EDolbyIODebugMediaRecordType::VideoDisabled:
+				case EDolbyIODebugMediaRecordType::VideoDevices:
+					OnEvent(Record);
+					break;
+				default:
+					// A record of a later version of the format
+					break;
+			}
+		}
+
+		const double ElapsedTime = FPlatformTime::Seconds() - StartTime;
+		UE_LOG(LogDolbyIODebug, Log, TEXT("Replayed %d records, %lld frames, %.1f MB in %.2f s (recorded over %.2f s): %.1f fps, %.1f MB/s"),
+		       Records.Num(), NumFrames, NumBytes / (1024.0 * 1024.0), ElapsedTime, Reader->GetDuration(),
+		       ElapsedTime > 0.0 ? NumFrames / ElapsedTime : 0.0, ElapsedTime > 0.0 ? NumBytes / (1024.0 * 1024.0) / ElapsedTime : 0.0);
+
+		if (!bStopping)
+		{
+			OnFinished();
+		}
+		return 0;
+	}
+
+	void Stop() override { bStopping = true; }
+
+private:
+	TUniquePtr<FDolbyIODebugMediaReader> Reader;
+	const TMap<int32, FFrameSink> FrameSinks;
+	USoundWaveProcedural* const Sound;
+	const bool bMaxSpeed;
+	const FOnRecord OnEvent;
+	const TFunction<void()> OnFinished;
+	TUniquePtr<FRunnableThread> Thread;
+	std::atomic<bool> bStopping{false};
+};
+
+void UDolbyIODebugMediaRecording::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugSyntheticVideo>();
+	Collection.InitializeDependency<UDolbyIODebugVideoEvents>();
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugMediaRecording::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugMediaRecording::HandleVideoDisabled);
+		VideoEvents->OnVideoDevicesReceivedNative.AddUObject(this, &UDolbyIODebugMediaRecording::HandleVideoDevicesReceived);
+	}
+	if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		SyntheticVideo->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugMediaRecording::HandleVideoEnabled);
+		SyntheticVideo->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugMediaRecording::HandleVideoDisabled);
+	}
+
+	FString FileName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("DolbyIORecord="), FileName))
+	{
+		StartRecording(FileName);
+	}
+
+	// The replay waits for the first map, so that its frames and sound do not compete with the load
+	if (FParse::Value(FCommandLine::Get(), TEXT("DolbyIOReplay="), PendingReplayFileName))
+	{
+		bPendingReplayMaxSpeed = FParse::Param(FCommandLine::Get(), TEXT("DolbyIOReplayMaxSpeed"));
+		PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UDolbyIODebugMediaRecording::HandlePostLoadMap);
+	}
+}
+
+void UDolbyIODebugMediaRecording::Deinitialize()
+{
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	StopReplay();
+	StopRecording();
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDevicesReceivedNative.RemoveAll(this);
+	}
+	if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		SyntheticVideo->OnVideoEnabledNative.RemoveAll(this);
+		SyntheticVideo->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	Super::Deinitialize();
+}
+
+bool UDolbyIODebugMediaRecording::StartRecording(const FString& FileName)
+{
+	if (!FDolbyIODebugMediaWriter::Get().Open(GetRecordingPath(FileName)))
+	{
+		return false;
+	}
+
+	if (FAudioDevice* AudioDevice = DolbyIODebugMediaRecording::GetMainAudioDevice())
+	{
+		AudioDevice->RegisterSubmixBufferListener(&DolbyIODebugMediaRecording::AudioRecorder);
+	}
+	return true;
+}
+
+void UDolbyIODebugMediaRecording::StopRecording()
+{
+	if (!IsRecording())
+	{
+		return;
+	}
+
+	if (FAudioDevice* AudioDevice = DolbyIODebugMediaRecording::GetMainAudioDevice())
+	{
+		AudioDevice->UnregisterSubmixBufferListener(&DolbyIODebugMediaRecording::AudioRecorder);
+	}
+	FDolbyIODebugMediaWriter::Get().Close();
+}
+
+bool UDolbyIODebugMediaRecording::IsRecording() const
+{
+	return FDolbyIODebugMediaWriter::Get().IsOpen();
+}
+
+bool UDolbyIODebugMediaRecording::StartReplay(const FString& FileName, bool bMaxSpeed)
+{
+	StopReplay();
+
+	TUniquePtr<FDolbyIODebugMediaReader> Reader = MakeUnique<FDolbyIODebugMediaReader>();
+	if (!Reader->Open(GetRecordingPath(FileName)))
+	{
+		return false;
+	}
+
+	// Every sink the replay thread uses is created up front, from the streams and the audio format of the recording
+	TMap<int32, FDolbyIODebugMediaReplayer::FFrameSink> FrameSinks;
+	for (const FDolbyIODebugMediaReader::FRecord& Record : Reader->GetRecords())
+	{
+		if (Record.Header->Type == EDolbyIODebugMediaRecordType::VideoFrame)
+		{
+			int32 Stream = INDEX_NONE;
+			if (FDolbyIODebugMediaReader::ReadVideoFrame(Record, Stream).IsValid() && !ReplayTextures.Contains(Stream))
+			{
+				UDolbyIODebugPreviewTexture* Texture = NewObject<UDolbyIODebugPreviewTexture>(this);
+				Texture->UpdateResource();
+				const int32 TelemetrySource = FDolbyIODebugVideoTelemetry::Get().RegisterSource(FString::Printf(TEXT("Replay %d"), Stream));
+				Texture->SetTelemetrySource(TelemetrySource);
+				ReplayTelemetrySources.Add(TelemetrySource);
+				ReplayTextures.Add(Stream, Texture);
+
+				// The conversion and staging of the frames run on the task workers, off the replay thread at max speed and
+				// off the game thread in real time, where the frames are paced by a jitter buffer like those of a remote
+				// track would be
+				const FString Name = FString::Printf(TEXT("Replay %d"), Stream);
+				TSharedRef<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe> FrameTrack = FDolbyIODebugFrameTrack::Open(
+				    Name, [Texture](const FDolbyIODebugVideoFrame& Frame) { Texture->SubmitFrame(Frame); }, TelemetrySource);
+				ReplayFrameTracks.Add(FrameTrack);
+				if (bMaxSpeed)
+				{
+					FrameSinks.Add(Stream, [FrameTrack](const FDolbyIODebugVideoFrame& Frame) { FrameTrack->Submit(Frame); });
+				}
+				else
+				{
+					TSharedRef<FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe> JitterBuffer = FDolbyIODebugJitterBuffer::Open(
+					    Name, [FrameTrack](const FDolbyIODebugVideoFrame& Frame) { FrameTrack->Submit(Frame); }, TelemetrySource);
+					ReplayJitterBuffers.Add(JitterBuffer);
+					FrameSinks.Add(Stream, [JitterBuffer](const FDolbyIODebugVideoFrame& Frame) { JitterBuffer->Submit(Frame); });
+				}
+			}
+		}
+		else if (Record.Header->Type == EDolbyIODebugMediaRecordType::AudioBuffer && !ReplaySound && !bMaxSpeed)
+		{
+			FDolbyIODebugMediaAudioBufferHeader BufferHeader;
+			const float* Samples = nullptr;
+			if (!FDolbyIODebugMediaReader::ReadAudioBuffer(Record, BufferHeader, Samples))
+			{
+				continue;
+			}
+			ReplaySound = NewObject<USoundWaveProcedural>(this);
+			ReplaySound->SetSampleRate(BufferHeader.SampleRate);
+			ReplaySound->NumChannels = BufferHeader.NumChannels;
+			ReplaySound->Duration = INDEFINITELY_LOOPING_DURATION;
+			ReplaySound->SoundGroup = SOUNDGROUP_Voice;
+			ReplaySound->bLooping = false;
+		}
+	}
+
+	FAudioDevice* AudioDevice = DolbyIODebugMediaRecording::GetMainAudioDevice();
+	if (ReplaySound && AudioDevice)
+	{
+		ReplayAudioComponent = FAudioDevice::CreateComponent(ReplaySound, FAudioDevice::FCreateComponentParams(AudioDevice));
+		if (ReplayAudioComponent)
+		{
+			ReplayAudioComponent->bIsUISound = true;
+			ReplayAudioComponent->bAutoDestroy = false;
+			ReplayAudioComponent->Play();
+		}
+	}
+
+	// The events go to the listeners of the live ones, the event processor among them, as if the SDK had sent them
+	TWeakObjectPtr<UDolbyIODebugVideoEvents> WeakVideoEvents(DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this));
+	auto OnEvent = [WeakVideoEvents](const FDolbyIODebugMediaReader::FRecord& Record)
+	{
+		// Decoded on the replay thread, while the mapped record is valid, and broadcast on the game thread
+		const EDolbyIODebugMediaRecordType Type = Record.Header->Type;
+		TArray<FDolbyIOVideoDevice> VideoDevices;
+		FString VideoTrackID;
+		if (Type == EDolbyIODebugMediaRecordType::VideoDevices)
+		{
+			VideoDevices = FDolbyIODebugMediaReader::ReadVideoDevices(Record);
+		}
+		else
+		{
+			VideoTrackID = FDolbyIODebugMediaReader::ReadVideoEvent(Record);
+		}
+
+		AsyncTask(ENamedThreads::GameThread,
+		          [WeakVideoEvents, Type, VideoDevices = MoveTemp(VideoDevices), VideoTrackID = MoveTemp(VideoTrackID)]
+		          {
+			          UDolbyIODebugVideoEvents* VideoEvents = WeakVideoEvents.Get();
+			          if (!VideoEvents)
+			          {
+				          return;
+			          }
+			          switch (Type)
+			          {
+				          case EDolbyIODebugMediaRecordType::VideoEnabled:
+					          VideoEvents->InjectVideoEnabled(VideoTrackID);
+					          break;
+				          case EDolbyIODebugMediaRecordType::VideoDisabled:
+					          VideoEvents->InjectVideoDisabled(VideoTrackID);
+					          break;
+				          case EDolbyIODebugMediaRecordType::VideoDevices:
+					          VideoEvents->InjectVideoDevicesReceived(VideoDevices);
+					          break;
+				          default:
+					          break;
+			          }
+		          });
+	};
+
+	// A replay stopped and started again before the end of the last one was broadcast must not be finished by it
+	TWeakObjectPtr<UDolbyIODebugMediaRecording> WeakThis(this);
+	const uint32 ReplayID = ++LastReplayID;
+	auto OnFinished = [WeakThis, ReplayID]
+	{
+		AsyncTask(ENamedThreads::GameThread,
+		          [WeakThis, ReplayID]
+		          {
+			          if (WeakThis.IsValid() && WeakThis->LastReplayID == ReplayID)
+			          {
+				          WeakThis->HandleReplayFinished();
+			          }
+		          });
+	};
+
+	Replayer = MakeShared<FDolbyIODebugMediaReplayer>(MoveTemp(Reader), MoveTemp(FrameSinks), ReplaySound.Get(), bMaxSpeed, MoveTemp(OnEvent),
+	                                                  MoveTemp(OnFinished));
+	return true;
+}
+
+void UDolbyIODebugMediaRecording::StopReplay()
+{
+	// Joins the replay thread, so none of the sinks below is used after this
+	Replayer.Reset();
+
+	if (ReplayAudioComponent)
+	{
+		ReplayAudioComponent->Stop();
+		ReplayAudioComponent = nullptr;
+	}
+	ReplaySound = nullptr;
+	ReplayJitterBuffers.Reset();
+	for (const TSharedRef<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe>& FrameTrack : ReplayFrameTracks)
+	{
+		FrameTrack->Close();
+	}
+	ReplayFrameTracks.Reset();
+	ReplayTextures.Reset();
+	for (int32 TelemetrySource : ReplayTelemetrySources)
+	{
+		FDolbyIODebugVideoTelemetry::Get().UnregisterSource(TelemetrySource);
+	}
+	ReplayTelemetrySources.Reset();
+}
+
+UTexture* UDolbyIODebugMediaRecording::GetReplayTexture(int32 Stream) const
+{
+	const TObjectPtr<UDolbyIODebugPreviewTexture>* Texture = ReplayTextures.Find(Stream);
+	return Texture ? Texture->Get() : nullptr;
+}
+
+void UDolbyIODebugMediaRecording::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	// The events of a replay come back through the video events, and are already in its recording
+	if (IsReplaying())
+	{
+		return;
+	}
+	FDolbyIODebugMediaWriter::Get().WriteVideoEvent(EDolbyIODebugMediaRecordType::VideoEnabled, VideoTrackID);
+}
+
+void UDolbyIODebugMediaRecording::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	if (IsReplaying())
+	{
+		return;
+	}
+	FDolbyIODebugMediaWriter::Get().WriteVideoEvent(EDolbyIODebugMediaRecordType::VideoDisabled, VideoTrackID);
+}
+
+void UDolbyIODebugMediaRecording::HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices, TConstArrayView<FName>)
+{
+	if (IsReplaying())
+	{
+		return;
+	}
+	FDolbyIODebugMediaWriter::Get().WriteVideoDevices(VideoDevices);
+}
+
+void UDolbyIODebugMediaRecording::HandlePostLoadMap(UWorld* World)
+{
+	if (!World || World->GetGameInstance() != GetGameInstance())
+	{
+		return;
+	}
+
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	PostLoadMapHandle.Reset();
+	StartReplay(PendingReplayFileName, bPendingReplayMaxSpeed);
+	PendingReplayFileName.Reset();
+}
+
+void UDolbyIODebugMediaRecording::HandleReplayFinished()
+{
+	// The textures keep their last frame until the next replay
+	Replayer.Reset();
+	if (ReplayAudioComponent)
+	{
+		ReplayAudioComponent->Stop();
+	}
+	OnReplayFinishedNative.Broadcast();
+	OnReplayFinished.Broadcast();
+}
+
+FString UDolbyIODebugMediaRecording::GetRecordingPath(const FString& FileName)
+{
+	return FPaths::IsRelative(FileName) ? FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Recordings"), FileName) : FileName;
+}
@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugMediaRecording.generated.h"
+
+class UAudioComponent;
+class UDolbyIODebugPreviewTexture;
+class USoundWaveProcedural;
+
+DECLARE_MULTICAST_DELEGATE(FDolbyIODebugOnReplayFinishedNative);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDolbyIODebugOnReplayFinished);
+
+/**
+ * Records the media of a session to disk and replays it, so that throughput can be benchmarked without devices, a
+ * token or a conference.
+ *
+ * A recording holds the frames submitted to every preview texture, the output of the main submix, and the video events
+ * and device lists of the SDK and of UDolbyIODebugSyntheticVideo, in the format of FDolbyIODebugMediaWriter. Replaying
+ * maps the file and feeds the records back from their own thread: the frames to a preview texture per recorded stream
+ * through an FDolbyIODebugFrameTrack, paced by a jitter buffer and through the same conversion, budget and telemetry
+ * as live frames, the audio to a procedural sound, and the events to the listeners of UDolbyIODebugVideoEvents on the
+ * game thread, as if the SDK had sent them. At max speed the records are fed as fast as the sinks take them, without
+ * jitter buffers nor audio, and the throughput is logged once the replay finishes. Events are not recorded while a
+ * replay runs, since those of the replay would be recorded again.
+ *
+ * -DolbyIORecord=<file> records from startup, and -DolbyIOReplay=<file> [-DolbyIOReplayMaxSpeed] replays once the
+ * first map is loaded. Relative files are under Saved/Recordings.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugMediaRecording : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	bool StartRecording(const FString& FileName);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StopRecording();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsRecording() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	bool StartReplay(const FString& FileName, bool bMaxSpeed = false);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StopReplay();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsReplaying() const { return Replayer.IsValid(); }
+
+	/** Shows the replayed frames of a recorded stream, nullptr if the recording has none. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	UTexture* GetReplayTexture(int32 Stream) const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnReplayFinished OnReplayFinished;
+	FDolbyIODebugOnReplayFinishedNative OnReplayFinishedNative;
+
+private:
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+	void HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices, TConstArrayView<FName> DeviceIDs);
+	void HandlePostLoadMap(UWorld* World);
+
+	void HandleReplayFinished();
+	static FString GetRecordingPath(const FString& FileName);
+
+	UPROPERTY(Transient)
+	TMap<int32, TObjectPtr<UDolbyIODebugPreviewTexture>> ReplayTextures;
+
+	UPROPERTY(Transient)
+	TObjectPtr<USoundWaveProcedural> ReplaySound;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UAudioComponent> ReplayAudioComponent;
+
+	TSharedPtr<class FDolbyIODebugMediaReplayer> Replayer;
+	/** Pace the replayed frames in real time. Released before the textures they present to. */
+	TArray<TSharedRef<class FDolbyIODebugJitterBuffer, ESPMode::ThreadSafe>> ReplayJitterBuffers;
+	/** Convert and stage the replayed frames of each stream on the task workers. Closed before the textures are released. */
+	TArray<TSharedRef<class FDolbyIODebugFrameTrack, ESPMode::ThreadSafe>> ReplayFrameTracks;
+	TArray<int32> ReplayTelemetrySources;
+	uint32 LastReplayID = 0;
+	FString PendingReplayFileName;
+	bool bPendingReplayMaxSpeed = false;
+	FDelegateHandle PostLoadMapHandle;
+};
@@ -0,0 +1,184 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugMultiPreviewComponent.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugStartupProfiler.h"
+
+#include "Engine/Canvas.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "IMediaTextureSample.h"
+#include "Kismet/KismetRenderingLibrary.h"
+#include "MediaCaptureSupport.h"
+#include "MediaPlayer.h"
+#include "MediaPlayerFacade.h"
+#include "MediaTexture.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+UDolbyIODebugMultiPreviewComponent::UDolbyIODebugMultiPreviewComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UDolbyIODebugMultiPreviewComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (bAutoStart)
+	{
+		StartPreview();
+	}
+}
+
+void UDolbyIODebugMultiPreviewComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopPreview();
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDolbyIODebugMultiPreviewComponent::StartPreview()
+{
+	if (IsPreviewing())
+	{
+		return;
+	}
+
+	TArray<FMediaCaptureDeviceInfo> DeviceInfos;
+	MediaCaptureSupport::EnumerateVideoCaptureDevices(DeviceInfos);
+	if (DeviceInfos.Num() == 0)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Cannot start the multi-device preview: no video capture devices found"));
+		return;
+	}
+
+	AtlasColumns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(DeviceInfos.Num())));
+	const int32 AtlasRows = FMath::DivideAndRoundUp(DeviceInfos.Num(), AtlasColumns);
+	Atlas = UKismetRenderingLibrary::CreateRenderTarget2D(this, TileSize.X * AtlasColumns, TileSize.Y * AtlasRows, RTF_RGBA8);
+
+	for (const FMediaCaptureDeviceInfo& DeviceInfo : DeviceInfos)
+	{
+		UMediaPlayer* MediaPlayer = NewObject<UMediaPlayer>(this);
+		MediaPlayer->PlayOnOpen = true;
+
+		UMediaTexture* MediaTexture = NewObject<UMediaTexture>(this);
+		MediaTexture->SetMediaPlayer(MediaPlayer);
+		MediaTexture->UpdateResource();
+
+		FDevice& Device = Devices.AddDefaulted_GetRef();
+		Device.Stats.DisplayName = DeviceInfo.DisplayName.ToString();
+		Device.SampleCounter = MakeShared<FMediaTextureSampleQueue, ESPMode::ThreadSafe>();
+		MediaPlayer->GetPlayerFacade()->AddVideoSampleSink(Device.SampleCounter.ToSharedRef());
+
+		if (!MediaPlayer->OpenUrl(DeviceInfo.Url))
+		{
+			UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to open video capture device %s"), *Device.Stats.DisplayName);
+		}
+		MediaPlayers.Add(MediaPlayer);
+		MediaTextures.Add(MediaTexture);
+	}
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Previewing %d video capture devices at once on %d cores"), Devices.Num(),
+	       FPlatformMisc::NumberOfCores());
+	LastReportTime = FPlatformTime::Seconds();
+	SetComponentTickEnabled(true);
+}
+
+void UDolbyIODebugMultiPreviewComponent::StopPreview()
+{
+	SetComponentTickEnabled(false);
+	for (UMediaPlayer* MediaPlayer : MediaPlayers)
+	{
+		MediaPlayer->Close();
+	}
+	MediaPlayers.Reset();
+	MediaTextures.Reset();
+	Devices.Reset();
+}
+
+TArray<FDolbyIODebugCaptureDeviceStats> UDolbyIODebugMultiPreviewComponent::GetDeviceStats() const
+{
+	TArray<FDolbyIODebugCaptureDeviceStats> DeviceStats;
+	DeviceStats.Reserve(Devices.Num());
+	for (const FDevice& Device : Devices)
+	{
+		DeviceStats.Add(Device.Stats);
+	}
+	return DeviceStats;
+}
+
+void UDolbyIODebugMultiPreviewComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	CountDeliveredFrames();
+	CompositeAtlas();
+
+	if (FPlatformTime::Seconds() - LastReportTime >= ReportInterval)
+	{
+		Report();
+	}
+}
+
+void UDolbyIODebugMultiPreviewComponent::CountDeliveredFrames()
+{
+	TSharedPtr<IMediaTextureSample, ESPMode::ThreadSafe> Sample;
+	for (FDevice& Device : Devices)
+	{
+		while (Device.SampleCounter->Dequeue(Sample))
+		{
+			++Device.Stats.FramesDelivered;
+		}
+	}
+}
+
+void UDolbyIODebugMultiPreviewComponent::CompositeAtlas()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DolbyIODebugCompositeAtlas, DolbyIODebugChannel);
+
+	UCanvas* Canvas = nullptr;
+	FVector2D CanvasSize;
+	FDrawToRenderTargetContext Context;
+	UKismetRenderingLibrary::BeginDrawCanvasToRenderTarget(this, Atlas, Canvas, CanvasSize, Context);
+	if (!Canvas)
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < MediaTextures.Num(); ++Index)
+	{
+		const FVector2D TilePosition((Index % AtlasColumns) * TileSize.X, (Index / AtlasColumns) * TileSize.Y);
+		Canvas->K2_DrawTexture(MediaTextures[Index], TilePosition, FVector2D(TileSize), FVector2D::ZeroVector, FVector2D::UnitVector,
+		                       FLinearColor::White, BLEND_Opaque);
+	}
+
+	UKismetRenderingLibrary::EndDrawCanvasToRenderTarget(this, Context);
+}
+
+void UDolbyIODebugMultiPreviewComponent::Report()
+{
+	const double Now = FPlatformTime::Seconds();
+	const double Elapsed = Now - LastReportTime;
+	LastReportTime = Now;
+
+	float TotalFrameRate = 0.0f;
+	for (int32 Index = 0; Index < Devices.Num(); ++Index)
+	{
+		FDevice& Device = Devices[Index];
+		const UMediaPlayer* MediaPlayer = MediaPlayers[Index];
+		Device.Stats.bOpened = MediaPlayer->IsPlaying();
+		Device.Stats.NominalFrameRate = MediaPlayer->GetVideoTrackFrameRate(INDEX_NONE, INDEX_NONE);
+		Device.Stats.DeliveredFrameRate = (Device.Stats.FramesDelivered - Device.FramesAtLastReport) / Elapsed;
+		Device.FramesAtLastReport = Device.Stats.FramesDelivered;
+		TotalFrameRate += Device.Stats.DeliveredFrameRate;
+
+		UE_LOG(LogDolbyIODebug, Log, TEXT("  %-32s %s %5.1f / %5.1f fps"), *Device.Stats.DisplayName,
+		       Device.Stats.bOpened ? TEXT("capturing") : TEXT("closed   "), Device.Stats.DeliveredFrameRate,
+		       Device.Stats.NominalFrameRate);
+	}
+	UE_LOG(LogDolbyIODebug, Log, TEXT("%d devices delivered %.1f fps in total on %d cores"), Devices.Num(), TotalFrameRate,
+	       FPlatformMisc::NumberOfCores());
+
+	OnCaptureStats.Broadcast(GetDeviceStats());
+}
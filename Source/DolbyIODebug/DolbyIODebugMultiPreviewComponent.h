@@ -0,0 +1,121 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MediaSampleQueue.h"
+#include "DolbyIODebugMultiPreviewComponent.generated.h"
+
+class UMediaPlayer;
+class UMediaTexture;
+class UTextureRenderTarget2D;
+
+/** Capture statistics of one device over the last report interval. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugCaptureDeviceStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString DisplayName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	bool bOpened = false;
+
+	/** Frame rate the device was opened with. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	float NominalFrameRate = 0.0f;
+
+	/** Frames actually delivered per second. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	float DeliveredFrameRate = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 FramesDelivered = 0;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnCaptureStatsDelegate, const TArray<FDolbyIODebugCaptureDeviceStats>&, DeviceStats);
+
+/**
+ * Previews every video capture device at once, composited into a single atlas render target.
+ *
+ * This is the concurrent counterpart of UDolbyIODebugDeviceCyclerComponent, for validating multi-camera rigs in one
+ * pass. The Dolby.io SDK only captures one local video device at a time, so the devices are opened through the Media
+ * Framework instead, each with its own media player; the platform media player runs the capture of each device on
+ * its own thread. The frames delivered by every device are counted and reported every ReportInterval seconds along
+ * with the number of CPU cores, which shows how capture throughput scales with the device count.
+ *
+ * Bind Atlas to a material to show the devices in L_Dolby_Debug.
+ */
+UCLASS(ClassGroup = (DolbyIO), Meta = (BlueprintSpawnableComponent))
+class DOLBYIODEBUG_API UDolbyIODebugMultiPreviewComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UDolbyIODebugMultiPreviewComponent();
+
+	/** Size of each device's tile in the atlas. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "16"))
+	FIntPoint TileSize = FIntPoint(640, 360);
+
+	/** Open all devices on BeginPlay. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug")
+	bool bAutoStart = true;
+
+	/** Seconds between capture statistics reports. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.1", Units = "s"))
+	float ReportInterval = 5.0f;
+
+	/** The devices side by side, row by row in enumeration order. Created when the preview starts. */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Dolby.io Debug")
+	TObjectPtr<UTextureRenderTarget2D> Atlas;
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StartPreview();
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void StopPreview();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsPreviewing() const { return Devices.Num() > 0; }
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	TArray<FDolbyIODebugCaptureDeviceStats> GetDeviceStats() const;
+
+	/** Broadcast every ReportInterval seconds while previewing. */
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnCaptureStatsDelegate OnCaptureStats;
+
+	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	struct FDevice
+	{
+		FDolbyIODebugCaptureDeviceStats Stats;
+		/** Second sink of the player, only used to count the delivered frames. */
+		TSharedPtr<FMediaTextureSampleQueue, ESPMode::ThreadSafe> SampleCounter;
+		int64 FramesAtLastReport = 0;
+	};
+
+	void CountDeliveredFrames();
+	void CompositeAtlas();
+	void Report();
+
+	/** One entry per device, in the same order as MediaPlayers and MediaTextures. */
+	TArray<FDevice> Devices;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMediaPlayer>> MediaPlayers;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UMediaTexture>> MediaTextures;
+
+	int32 AtlasColumns = 1;
+	double LastReportTime = 0.0;
+};
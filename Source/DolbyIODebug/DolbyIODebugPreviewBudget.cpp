@@ -0,0 +1,135 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugPreviewBudget.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "RenderCore.h"
+#include "RHI.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Preview budget level"), STAT_DolbyIOVideoPreviewBudgetLevel, STATGROUP_DolbyIOVideo);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Preview budget frame time (ms)"), STAT_DolbyIOVideoPreviewBudgetFrameTime, STATGROUP_DolbyIOVideo);
+
+namespace DolbyIODebugPreviewBudget
+{
+	bool bEnabled = true;
+	FAutoConsoleVariableRef CVarEnabled(TEXT("DolbyIODebug.PreviewBudget.Enabled"), bEnabled,
+	                                    TEXT("Lower the preview rate and resolution when the frame time exceeds the budget."));
+
+	float FrameTimeBudgetMs = 16.6f;
+	FAutoConsoleVariableRef CVarFrameTimeBudget(TEXT("DolbyIODebug.PreviewBudget.FrameTimeMs"), FrameTimeBudgetMs,
+	                                            TEXT("Frame time the previews must stay within, in milliseconds."));
+
+	float DownscaleDelay = 0.5f;
+	FAutoConsoleVariableRef CVarDownscaleDelay(TEXT("DolbyIODebug.PreviewBudget.DownscaleDelay"), DownscaleDelay,
+	                                           TEXT("Seconds over budget before the previews step down."));
+
+	float RestoreDelay = 3.0f;
+	FAutoConsoleVariableRef CVarRestoreDelay(TEXT("DolbyIODebug.PreviewBudget.RestoreDelay"), RestoreDelay,
+	                                         TEXT("Seconds with headroom before the previews step back up."));
+
+	/** The previews step back up only below this fraction of the budget. */
+	constexpr float HeadroomFraction = 0.75f;
+
+	/**
+	 * A step down this soon after a restore doubles the next restore delay, up to MaxRestoreDelay. A restore that lasts
+	 * longer halves it again, and clears it once back at full quality.
+	 */
+	constexpr float FailedRestoreWindow = 2.0f;
+	constexpr float MaxRestoreDelay = 60.0f;
+
+	/** Weight of the last frame in the smoothed frame time. */
+	constexpr float SmoothingFactor = 0.1f;
+
+	struct FLevel
+	{
+		int32 Downscale;
+		float MaxFrameRate;
+	};
+
+	constexpr FLevel Levels[] = {{1, 0.0f}, {1, 30.0f}, {2, 30.0f}, {2, 15.0f}, {4, 15.0f}};
+	constexpr int32 NumLevels = UE_ARRAY_COUNT(Levels);
+}
+
+FDolbyIODebugPreviewBudget& FDolbyIODebugPreviewBudget::Get()
+{
+	static FDolbyIODebugPreviewBudget Instance;
+	return Instance;
+}
+
+void FDolbyIODebugPreviewBudget::Update(float DeltaTime)
+{
+	using namespace DolbyIODebugPreviewBudget;
+	check(IsInGameThread());
+
+	if (!bEnabled)
+	{
+		BackoffRestoreDelay = 0.0f;
+		SetLevel(0);
+		return;
+	}
+
+	// The thread times are those of the previous frame, which is the best there is without waiting for this one
+	const float FrameTimeMs = FMath::Max3(FPlatformTime::ToMilliseconds(GGameThreadTime), FPlatformTime::ToMilliseconds(GRenderThreadTime),
+	                                      FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles()));
+	SmoothedFrameTimeMs = SmoothedFrameTimeMs > 0.0f ? FMath::Lerp(SmoothedFrameTimeMs, FrameTimeMs, SmoothingFactor) : FrameTimeMs;
+	SET_FLOAT_STAT(STAT_DolbyIOVideoPreviewBudgetFrameTime, SmoothedFrameTimeMs);
+
+	TimeSinceRestore += DeltaTime;
+	if (BackoffRestoreDelay > 0.0f && SmoothedFrameTimeMs <= FrameTimeBudgetMs && TimeSinceRestore >= FailedRestoreWindow &&
+	    TimeSinceRestore - DeltaTime < FailedRestoreWindow)
+	{
+		// The restore held, so the frame times have recovered and the next restore can come sooner
+		BackoffRestoreDelay = Level > 0 && BackoffRestoreDelay * 0.5f > RestoreDelay ? BackoffRestoreDelay * 0.5f : 0.0f;
+	}
+	if (SmoothedFrameTimeMs > FrameTimeBudgetMs)
+	{
+		TimeUnderBudget = 0.0f;
+		TimeOverBudget += DeltaTime;
+		if (TimeOverBudget >= DownscaleDelay && Level < NumLevels - 1)
+		{
+			if (TimeSinceRestore < FailedRestoreWindow)
+			{
+				BackoffRestoreDelay = FMath::Min(FMath::Max(BackoffRestoreDelay, RestoreDelay) * 2.0f, MaxRestoreDelay);
+			}
+			TimeOverBudget = 0.0f;
+			SetLevel(Level + 1);
+		}
+	}
+	else if (SmoothedFrameTimeMs < FrameTimeBudgetMs * HeadroomFraction)
+	{
+		TimeOverBudget = 0.0f;
+		TimeUnderBudget += DeltaTime;
+		if (TimeUnderBudget >= FMath::Max(BackoffRestoreDelay, RestoreDelay) && Level > 0)
+		{
+			TimeUnderBudget = 0.0f;
+			TimeSinceRestore = 0.0f;
+			SetLevel(Level - 1);
+		}
+	}
+	else
+	{
+		TimeOverBudget = 0.0f;
+		TimeUnderBudget = 0.0f;
+	}
+}
+
+void FDolbyIODebugPreviewBudget::SetLevel(int32 NewLevel)
+{
+	using namespace DolbyIODebugPreviewBudget;
+
+	SET_DWORD_STAT(STAT_DolbyIOVideoPreviewBudgetLevel, NewLevel);
+	if (NewLevel == Level)
+	{
+		return;
+	}
+
+	Level = NewLevel;
+	Downscale = Levels[Level].Downscale;
+	MinFrameInterval = Levels[Level].MaxFrameRate > 0.0f ? 1.0 / Levels[Level].MaxFrameRate : 0.0;
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Preview budget level %d at %.1f ms: 1/%d resolution, %s"), Level, SmoothedFrameTimeMs,
+	       Levels[Level].Downscale,
+	       Levels[Level].MaxFrameRate > 0.0f ? *FString::Printf(TEXT("%.0f fps"), Levels[Level].MaxFrameRate) : TEXT("unlimited rate"));
+}
@@ -0,0 +1,54 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+/**
+ * Keeps the module's video previews within the frame-time budget.
+ *
+ * Once per frame the game thread reads the time the last frame spent on the game thread, the render thread and the
+ * GPU, and smooths the slowest of the three. While it stays over DolbyIODebug.PreviewBudget.FrameTimeMs the previews
+ * step down a ladder of lower upload rates and resolutions; once it stays well under the budget they step back up,
+ * waiting longer after each restore that had to be undone so that the previews do not oscillate around the budget,
+ * and less again after each restore that held. Frame sinks read the current limits from any thread. The SDK captures
+ * and sends at a resolution of its own choosing, so what is scaled is the module-side cost of the previews:
+ * conversion, upload and sampling.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugPreviewBudget
+{
+public:
+	static FDolbyIODebugPreviewBudget& Get();
+
+	/** Game thread only, once per frame. */
+	void Update(float DeltaTime);
+
+	/** Factor the preview resolution is divided by, 1 at full resolution. Any thread. */
+	int32 GetDownscale() const { return Downscale.load(std::memory_order_relaxed); }
+
+	/** Minimum seconds between two presented preview frames, 0 for no limit. Any thread. */
+	double GetMinFrameInterval() const { return MinFrameInterval.load(std::memory_order_relaxed); }
+
+	/** Index in the ladder, 0 being full quality. */
+	int32 GetLevel() const { return Level; }
+
+	/** Smoothed slowest of the game thread, render thread and GPU time, in milliseconds. */
+	float GetFrameTimeMs() const { return SmoothedFrameTimeMs; }
+
+private:
+	void SetLevel(int32 NewLevel);
+
+	std::atomic<int32> Downscale{1};
+	std::atomic<double> MinFrameInterval{0.0};
+
+	/** Game thread only. */
+	int32 Level = 0;
+	float SmoothedFrameTimeMs = 0.0f;
+	float TimeOverBudget = 0.0f;
+	float TimeUnderBudget = 0.0f;
+	/** Grows when restores are undone right away, and shrinks when they hold. */
+	float BackoffRestoreDelay = 0.0f;
+	float TimeSinceRestore = TNumericLimits<float>::Max();
+};
@@ -0,0 +1,458 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugPreviewTexture.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugColorConversion.h"
+#include "DolbyIODebugFramePool.h"
+#include "DolbyIODebugMediaFile.h"
+#include "DolbyIODebugPreviewBudget.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "HAL/PlatformTime.h"
+
+#include "RenderingThread.h"
+#include "RHICommandList.h"
+#include "RHIStaticStates.h"
+#include "TextureResource.h"
+
+#include <atomic>
+
+DECLARE_CYCLE_STAT(TEXT("Submit frame"), STAT_DolbyIOVideoSubmitFrame, STATGROUP_DolbyIOVideo);
+
+class FDolbyIODebugPreviewTextureResource;
+
+/** State shared between the producers of frames, the game thread and the render thread. */
+class FDolbyIODebugFrameStaging
+{
+public:
+	static constexpr int32 NumSlots = 3;
+
+	explicit FDolbyIODebugFrameStaging(TSharedRef<FDolbyIODebugFramePool, ESPMode::ThreadSafe> InPool) : Pool(MoveTemp(InPool)) {}
+
+	/**
+	 * Owned by whoever set bInFlight: the producer while it stages a frame, then the render thread until it presented
+	 * it. The locked texture is only locked, unlocked and released by the render thread, which hands it to the next
+	 * producer of the slot through bInFlight.
+	 */
+	struct FSlot
+	{
+		/** Ring texture locked for the next frame to be written into, at LockedFormat. */
+		FTextureRHIRef LockedTexture;
+		uint8* LockedData = nullptr;
+		uint32 LockedStride = 0;
+		FDolbyIODebugFrameFormat LockedFormat;
+		/** Whether the frame in the slot was written into the locked texture rather than into Buffer. */
+		bool bWroteLocked = false;
+
+		/** Staging for a frame whose format no texture was locked at, at BufferFormat. */
+		TArray64<uint8> Buffer;
+		FDolbyIODebugFrameFormat BufferFormat;
+		/** Full resolution BGRA of a YUV frame that is downscaled. */
+		TArray64<uint8> ConversionBuffer;
+		FTextureRHIRef NativeTexture;
+		FDolbyIODebugFrameFormat Format;
+		std::atomic<bool> bInFlight{false};
+	};
+
+	~FDolbyIODebugFrameStaging()
+	{
+		for (FSlot& Slot : Slots)
+		{
+			ensureMsgf(!Slot.LockedTexture, TEXT("Preview frame slot still locked when its staging is released"));
+			Pool->ReleaseBuffer(Slot.BufferFormat, MoveTemp(Slot.Buffer));
+		}
+	}
+
+	/** Unlocks the texture of a slot and returns it to the pool. Render thread only. */
+	void UnlockSlot(FSlot& Slot)
+	{
+		if (Slot.LockedTexture)
+		{
+			RHIUnlockTexture2D(Slot.LockedTexture->GetTexture2D(), 0, false);
+			Pool->ReleaseTexture(Slot.LockedFormat, MoveTemp(Slot.LockedTexture));
+		}
+		Slot.LockedData = nullptr;
+		Slot.LockedStride = 0;
+	}
+
+	FSlot Slots[NumSlots];
+	std::atomic<uint32> NextSlot{0};
+
+	TSharedRef<FDolbyIODebugFramePool, ESPMode::ThreadSafe> Pool;
+
+	/** Only touched on the render thread. */
+	FDolbyIODebugPreviewTextureResource* Resource = nullptr;
+
+	std::atomic<int32> Width{0};
+	std::atomic<int32> Height{0};
+
+	std::atomic<int64> BytesCopiedLastFrame{0};
+	std::atomic<int64> BytesCopiedTotal{0};
+	std::atomic<int64> FramesPresented{0};
+	std::atomic<int64> FramesShared{0};
+	std::atomic<int64> FramesDropped{0};
+	std::atomic<int64> FramesThrottled{0};
+
+	std::atomic<double> LastAcceptTime{0.0};
+
+	std::atomic<int32> TelemetrySource{INDEX_NONE};
+
+	int32 GetQueueDepth() const
+	{
+		int32 QueueDepth = 0;
+		for (const FSlot& Slot : Slots)
+		{
+			QueueDepth += Slot.bInFlight.load(std::memory_order_relaxed) ? 1 : 0;
+		}
+		return QueueDepth;
+	}
+};
+
+class FDolbyIODebugPreviewTextureResource : public FTextureResource
+{
+public:
+	static constexpr int32 NumRetiredTextures = 1;
+
+	FDolbyIODebugPreviewTextureResource(FTextureReference& InTextureReference,
+	                                    TSharedRef<FDolbyIODebugFrameStaging, ESPMode::ThreadSafe> InStaging)
+	    : TextureReference(InTextureReference), Staging(MoveTemp(InStaging))
+	{
+	}
+
+	void InitRHI() override
+	{
+		FSamplerStateInitializerRHI SamplerStateInitializer(SF_Bilinear, AM_Clamp, AM_Clamp, AM_Clamp);
+		SamplerStateRHI = GetOrCreateSamplerState(SamplerStateInitializer);
+
+		const uint32 BlackPixel = 0xFF000000;
+		CurrentFormat = {1, 1, EDolbyIODebugPixelFormat::BGRA8};
+		CurrentTexture = Staging->Pool->AcquireTexture(CurrentFormat);
+		RHIUpdateTexture2D(CurrentTexture->GetTexture2D(), 0, FUpdateTextureRegion2D(0, 0, 0, 0, 1, 1), sizeof(BlackPixel),
+		                   reinterpret_cast<const uint8*>(&BlackPixel));
+		SetCurrentTexture(CurrentTexture);
+
+		Staging->Resource = this;
+	}
+
+	void ReleaseRHI() override
+	{
+		Staging->Resource = nullptr;
+		if (TextureReference.TextureReferenceRHI)
+		{
+			RHIUpdateTextureReference(TextureReference.TextureReferenceRHI, nullptr);
+		}
+
+		// A producer may be writing into the texture of a slot it holds, whose present command unlocks it instead
+		for (FDolbyIODebugFrameStaging::FSlot& Slot : Staging->Slots)
+		{
+			bool bExpected = false;
+			if (Slot.bInFlight.compare_exchange_strong(bExpected, true))
+			{
+				Staging->UnlockSlot(Slot);
+				Slot.bInFlight = false;
+			}
+		}
+
+		RetireCurrentTexture();
+		for (TPair<FDolbyIODebugFrameFormat, FTextureRHIRef>& Retired : RetiredTextures)
+		{
+			Staging->Pool->ReleaseTexture(Retired.Key, MoveTemp(Retired.Value));
+		}
+		RetiredTextures.Reset();
+		FTextureResource::ReleaseRHI();
+	}
+
+	uint32 GetSizeX() const override { return CurrentWidth; }
+	uint32 GetSizeY() const override { return CurrentHeight; }
+
+	void Present(FDolbyIODebugFrameStaging::FSlot& Slot)
+	{
+		if (Slot.NativeTexture)
+		{
+			RetireCurrentTexture();
+			SetCurrentTexture(Slot.NativeTexture);
+			return;
+		}
+
+		FTextureRHIRef Texture;
+		if (Slot.bWroteLocked)
+		{
+			RHIUnlockTexture2D(Slot.LockedTexture->GetTexture2D(), 0, false);
+			Texture = MoveTemp(Slot.LockedTexture);
+			Slot.LockedData = nullptr;
+			Slot.LockedStride = 0;
+		}
+		else
+		{
+			// The first frame of a slot or of a resolution, staged because no texture was locked at its format yet
+			Staging->UnlockSlot(Slot);
+			Texture = Staging->Pool->AcquireTexture(Slot.Format);
+			RHIUpdateTexture2D(Texture->GetTexture2D(), 0, FUpdateTextureRegion2D(0, 0, 0, 0, Slot.Format.Width, Slot.Format.Height),
+			                   Slot.Format.Width * 4, Slot.Buffer.GetData());
+		}
+		RetireCurrentTexture();
+		CurrentTexture = Texture;
+		CurrentFormat = Slot.Format;
+		SetCurrentTexture(Texture);
+
+		// The next frame of the slot is written straight into the texture, at the resolution frames come at now
+		LockSlot(Slot, Slot.Format);
+	}
+
+private:
+	void LockSlot(FDolbyIODebugFrameStaging::FSlot& Slot, const FDolbyIODebugFrameFormat& Format)
+	{
+		Slot.LockedTexture = Staging->Pool->AcquireTexture(Format);
+		Slot.LockedFormat = Format;
+		Slot.LockedData =
+		    static_cast<uint8*>(RHILockTexture2D(Slot.LockedTexture->GetTexture2D(), 0, RLM_WriteOnly, Slot.LockedStride, false));
+		if (!Slot.LockedData)
+		{
+			Staging->Pool->ReleaseTexture(Format, MoveTemp(Slot.LockedTexture));
+			Slot.LockedStride = 0;
+		}
+	}
+
+	/** Keeps the texture shown until now out of the pool for NumRetiredTextures frames, as the GPU may still sample it. */
+	void RetireCurrentTexture()
+	{
+		if (!CurrentTexture)
+		{
+			return;
+		}
+		RetiredTextures.Emplace(CurrentFormat, MoveTemp(CurrentTexture));
+		if (RetiredTextures.Num() > NumRetiredTextures)
+		{
+			Staging->Pool->ReleaseTexture(RetiredTextures[0].Key, MoveTemp(RetiredTextures[0].Value));
+			RetiredTextures.RemoveAt(0, 1, false);
+		}
+	}
+
+	void SetCurrentTexture(FRHITexture* Texture)
+	{
+		TextureRHI = Texture;
+		CurrentWidth = Texture->GetSizeXYZ().X;
+		CurrentHeight = Texture->GetSizeXYZ().Y;
+		if (TextureReference.TextureReferenceRHI)
+		{
+			RHIUpdateTextureReference(TextureReference.TextureReferenceRHI, Texture);
+		}
+	}
+
+	FTextureReference& TextureReference;
+	TSharedRef<FDolbyIODebugFrameStaging, ESPMode::ThreadSafe> Staging;
+	/** The pooled texture shown, unset while a native texture is. */
+	FTextureRHIRef CurrentTexture;
+	FDolbyIODebugFrameFormat CurrentFormat;
+	TArray<TPair<FDolbyIODebugFrameFormat, FTextureRHIRef>, TInlineAllocator<NumRetiredTextures + 1>> RetiredTextures;
+	uint32 CurrentWidth = 1;
+	uint32 CurrentHeight = 1;
+};
+
+UDolbyIODebugPreviewTexture::UDolbyIODebugPreviewTexture()
+{
+	NeverStream = true;
+	SRGB = true;
+}
+
+void UDolbyIODebugPreviewTexture::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		Staging = MakeShared<FDolbyIODebugFrameStaging, ESPMode::ThreadSafe>(FDolbyIODebugModule::Get().GetFramePool());
+	}
+}
+
+void UDolbyIODebugPreviewTexture::SubmitFrame(const FDolbyIODebugVideoFrame& Frame)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DolbyIOVideoSubmitFrame);
+	if (!Staging || !Frame.IsValid())
+	{
+		return;
+	}
+
+	// Recorded before the budget applies, so that a replay gets every frame the live sink was given
+	FDolbyIODebugMediaWriter::Get().WriteVideoFrame(Staging->TelemetrySource.load(std::memory_order_relaxed), Frame);
+
+	// Frames over the rate the preview budget allows are skipped before they cost anything
+	const FDolbyIODebugPreviewBudget& Budget = FDolbyIODebugPreviewBudget::Get();
+	const double MinFrameInterval = Budget.GetMinFrameInterval();
+	if (MinFrameInterval > 0.0)
+	{
+		// Accept frames slightly early, or a source at exactly the limited rate would lose every other frame to jitter
+		const double Now = FPlatformTime::Seconds();
+		if (Now - Staging->LastAcceptTime.load(std::memory_order_relaxed) < MinFrameInterval * 0.9)
+		{
+			++Staging->FramesThrottled;
+			return;
+		}
+		Staging->LastAcceptTime.store(Now, std::memory_order_relaxed);
+	}
+
+	FDolbyIODebugVideoTelemetry& Telemetry = FDolbyIODebugVideoTelemetry::Get();
+	const int32 TelemetrySource = Staging->TelemetrySource.load(std::memory_order_relaxed);
+	const bool bSampled = Telemetry.ShouldSample(TelemetrySource);
+	const double SubmitTime = bSampled ? FPlatformTime::Seconds() : 0.0;
+
+	const uint32 SlotIndex = Staging->NextSlot.fetch_add(1) % FDolbyIODebugFrameStaging::NumSlots;
+	FDolbyIODebugFrameStaging::FSlot& Slot = Staging->Slots[SlotIndex];
+	bool bExpected = false;
+	if (!Slot.bInFlight.compare_exchange_strong(bExpected, true))
+	{
+		++Staging->FramesDropped;
+		Telemetry.RecordDroppedFrame(TelemetrySource);
+		return;
+	}
+
+	// Frames are always staged as BGRA8, which is what the ring textures hold
+	const int32 Downscale = Frame.NativeTexture ? 1 : FMath::Min3(Budget.GetDownscale(), Frame.Width, Frame.Height);
+	const FDolbyIODebugFrameFormat Format{Frame.Width / Downscale, Frame.Height / Downscale, EDolbyIODebugPixelFormat::BGRA8};
+	Slot.NativeTexture = Frame.NativeTexture;
+
+	int64 BytesCopied = 0;
+	Slot.Format = Format;
+	if (!Frame.NativeTexture)
+	{
+		// Straight into the texture the render thread locked for the slot, or staged if it was locked at another format
+		Slot.bWroteLocked = Slot.LockedData && Slot.LockedFormat == Format;
+		const int64 RowBytes = static_cast<int64>(Format.Width) * 4;
+		uint8* Destination = nullptr;
+		int64 DestinationStride = RowBytes;
+		if (Slot.bWroteLocked)
+		{
+			Destination = Slot.LockedData;
+			DestinationStride = Slot.LockedStride;
+			if (Slot.Buffer.Num() > 0)
+			{
+				Staging->Pool->ReleaseBuffer(Slot.BufferFormat, MoveTemp(Slot.Buffer));
+				Slot.Buffer.Empty();
+			}
+		}
+		else
+		{
+			if (!(Slot.BufferFormat == Format) || Slot.Buffer.Num() == 0)
+			{
+				Staging->Pool->ReleaseBuffer(Slot.BufferFormat, MoveTemp(Slot.Buffer));
+				Slot.Buffer = Staging->Pool->AcquireBuffer(Format);
+				Slot.BufferFormat = Format;
+			}
+			Destination = Slot.Buffer.GetData();
+		}
+
+		if (Downscale > 1)
+		{
+			const uint8* Source = Frame.Data;
+			int64 SourceStride = Frame.Stride;
+			if (Frame.Format != EDolbyIODebugPixelFormat::BGRA8)
+			{
+				SourceStride = static_cast<int64>(Frame.Width) * 4;
+				Slot.ConversionBuffer.SetNumUninitialized(SourceStride * Frame.Height, false);
+				FDolbyIODebugColorConversion::ConvertToBGRA(Frame, Slot.ConversionBuffer.GetData(), static_cast<int32>(SourceStride));
+				Source = Slot.ConversionBuffer.GetData();
+			}
+
+			// Point sampling is enough for a preview, and keeps the downscale cheaper than the upload it saves
+			for (int32 Row = 0; Row < Format.Height; ++Row)
+			{
+				const uint32* SourceRow = reinterpret_cast<const uint32*>(Source + static_cast<int64>(Row) * Downscale * SourceStride);
+				uint32* DestinationRow = reinterpret_cast<uint32*>(Destination + Row * DestinationStride);
+				for (int32 Column = 0; Column < Format.Width; ++Column)
+				{
+					DestinationRow[Column] = SourceRow[Column * Downscale];
+				}
+			}
+		}
+		else if (Frame.Format != EDolbyIODebugPixelFormat::BGRA8)
+		{
+			FDolbyIODebugColorConversion::ConvertToBGRA(Frame, Destination, static_cast<int32>(DestinationStride));
+		}
+		else if (Frame.Stride == RowBytes && DestinationStride == RowBytes)
+		{
+			FMemory::Memcpy(Destination, Frame.Data, RowBytes * Frame.Height);
+		}
+		else
+		{
+			for (int32 Row = 0; Row < Frame.Height; ++Row)
+			{
+				FMemory::Memcpy(Destination + Row * DestinationStride, Frame.Data + static_cast<int64>(Row) * Frame.Stride, RowBytes);
+			}
+		}
+		// A staged frame is copied once more by RHIUpdateTexture2D on the render thread
+		BytesCopied = (Slot.bWroteLocked ? 1 : 2) * RowBytes * Format.Height;
+	}
+	else
+	{
+		++Staging->FramesShared;
+	}
+
+	Staging->BytesCopiedLastFrame = BytesCopied;
+	Staging->BytesCopiedTotal += BytesCopied;
+	Staging->Width = Format.Width;
+	Staging->Height = Format.Height;
+
+	Telemetry.RecordFrame(TelemetrySource, Staging->GetQueueDepth());
+	if (bSampled)
+	{
+		Telemetry.RecordTimings(TelemetrySource, Frame.CaptureTime > 0.0 ? SubmitTime - Frame.CaptureTime : -1.0,
+		                        FPlatformTime::Seconds() - SubmitTime);
+	}
+
+	ENQUEUE_RENDER_COMMAND(DolbyIODebugPresentFrame)
+	([Staging = Staging, SlotIndex](FRHICommandListImmediate& RHICmdList)
+	 {
+		 FDolbyIODebugFrameStaging::FSlot& Slot = Staging->Slots[SlotIndex];
+		 if (Staging->Resource)
+		 {
+			 Staging->Resource->Present(Slot);
+			 ++Staging->FramesPresented;
+		 }
+		 else
+		 {
+			 Staging->UnlockSlot(Slot);
+		 }
+		 Slot.NativeTexture.SafeRelease();
+		 Slot.bInFlight = false;
+	 });
+}
+
+void UDolbyIODebugPreviewTexture::SetTelemetrySource(int32 Source)
+{
+	if (Staging)
+	{
+		Staging->TelemetrySource = Source;
+	}
+}
+
+FDolbyIODebugFrameSinkStats UDolbyIODebugPreviewTexture::GetStats() const
+{
+	FDolbyIODebugFrameSinkStats Stats;
+	if (!Staging)
+	{
+		return Stats;
+	}
+
+	Stats.BytesCopiedLastFrame = Staging->BytesCopiedLastFrame;
+	Stats.BytesCopiedTotal = Staging->BytesCopiedTotal;
+	Stats.FramesPresented = Staging->FramesPresented;
+	Stats.FramesShared = Staging->FramesShared;
+	Stats.FramesDropped = Staging->FramesDropped;
+	Stats.FramesThrottled = Staging->FramesThrottled;
+	return Stats;
+}
+
+FTextureResource* UDolbyIODebugPreviewTexture::CreateResource()
+{
+	return Staging ? new FDolbyIODebugPreviewTextureResource(TextureReference, Staging.ToSharedRef()) : nullptr;
+}
+
+float UDolbyIODebugPreviewTexture::GetSurfaceWidth() const
+{
+	return Staging ? FMath::Max(Staging->Width.load(), 1) : 1.0f;
+}
+
+float UDolbyIODebugPreviewTexture::GetSurfaceHeight() const
+{
+	return Staging ? FMath::Max(Staging->Height.load(), 1) : 1.0f;
+}
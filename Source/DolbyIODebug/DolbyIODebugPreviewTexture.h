@@ -0,0 +1,82 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIODebugVideoFrame.h"
+#include "Engine/Texture.h"
+#include "DolbyIODebugPreviewTexture.generated.h"
+
+/** Upload counters of a preview texture, used to verify how much memory every frame costs. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugFrameSinkStats
+{
+	GENERATED_BODY()
+
+	/**
+	 * Bytes the last frame was copied by the CPU: its size when it was written straight into a locked texture, twice
+	 * its size when it had to be staged and uploaded from there. Zero for a frame that shared its native texture.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 BytesCopiedLastFrame = 0;
+
+	/** Sum of BytesCopiedLastFrame over every frame. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 BytesCopiedTotal = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 FramesPresented = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 FramesShared = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 FramesDropped = 0;
+
+	/** Frames skipped to stay within the rate FDolbyIODebugPreviewBudget allows. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 FramesThrottled = 0;
+};
+
+/**
+ * Texture presenting the frames submitted to it, meant to be sampled by the preview material in L_Dolby_Debug.
+ *
+ * Each frame is copied once, straight into an RHI texture: the submitter only lends its pixels for the duration of
+ * SubmitFrame, so the render thread keeps a texture locked for each of a few slots, which the submitter converts or
+ * copies the frame into, and unlocks and presents it before locking another one for the next frame of the slot. The
+ * first frame of a slot, or of a new resolution, finds no texture locked at its format and is staged in a buffer and
+ * uploaded from there instead. The texture reference is then pointed at the new texture, so the UTexture itself is
+ * never reallocated. Staging buffers and RHI textures come from the module's frame pool, so switching back to a
+ * resolution reuses the memory from the last time it was shown. Frames that carry a native texture are shared without
+ * any copy. Frames are dropped if the render thread falls behind by more than the number of slots, and skipped or
+ * downscaled as FDolbyIODebugPreviewBudget requires.
+ */
+UCLASS(ClassGroup = (DolbyIO), HideCategories = (Adjustments, Compression, LevelOfDetail, Object))
+class DOLBYIODEBUG_API UDolbyIODebugPreviewTexture : public UTexture
+{
+	GENERATED_BODY()
+
+public:
+	UDolbyIODebugPreviewTexture();
+
+	/** Presents a frame. Can be called from any thread. */
+	void SubmitFrame(const FDolbyIODebugVideoFrame& Frame);
+
+	/** Source under which FDolbyIODebugVideoTelemetry records the submitted frames, INDEX_NONE for none. */
+	void SetTelemetrySource(int32 Source);
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	FDolbyIODebugFrameSinkStats GetStats() const;
+
+	void PostInitProperties() override;
+	FTextureResource* CreateResource() override;
+	EMaterialValueType GetMaterialType() const override { return MCT_Texture2D; }
+	ETextureClass GetTextureClass() const override { return ETextureClass::TwoDDynamic; }
+	float GetSurfaceWidth() const override;
+	float GetSurfaceHeight() const override;
+	float GetSurfaceDepth() const override { return 0.0f; }
+	uint32 GetSurfaceArraySize() const override { return 0; }
+
+private:
+	TSharedPtr<class FDolbyIODebugFrameStaging, ESPMode::ThreadSafe> Staging;
+};
@@ -0,0 +1,147 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugRenderProfile.h"
+#include "DolbyIODebug.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+namespace DolbyIODebugRenderProfile
+{
+	FString ActiveProfileName;
+	FString LastProfileName;
+	struct FRestoreValue
+	{
+		FString Name;
+		FString Value;
+		/** ECVF_SetBy* the value was set with. */
+		EConsoleVariableFlags SetBy;
+	};
+
+	/** Values the variables of the active profile had before it was applied. */
+	TArray<FRestoreValue> RestoreValues;
+
+	EConsoleVariableFlags GetSetBy(const IConsoleVariable* Variable)
+	{
+		return static_cast<EConsoleVariableFlags>(Variable->GetFlags() & ECVF_SetByMask);
+	}
+
+	FAutoConsoleCommand CmdToggle(TEXT("DolbyIODebug.RenderProfile.Toggle"),
+	                              TEXT("Restores the project's rendering, or applies the last render profile again."),
+	                              FConsoleCommandDelegate::CreateStatic(&FDolbyIODebugRenderProfile::Toggle));
+
+	FAutoConsoleCommand CmdApply(TEXT("DolbyIODebug.RenderProfile.Apply"), TEXT("Applies the render profile <Name>."),
+	                             FConsoleCommandWithArgsDelegate::CreateLambda(
+	                                 [](const TArray<FString>& Args)
+	                                 {
+		                                 if (Args.Num() > 0)
+		                                 {
+			                                 FDolbyIODebugRenderProfile::Apply(Args[0]);
+		                                 }
+	                                 }));
+}
+
+bool FDolbyIODebugRenderProfile::Apply(const FString& ProfileName)
+{
+	using namespace DolbyIODebugRenderProfile;
+
+	const FString ProfileSection = TEXT("DolbyIODebug.RenderProfile.") + ProfileName;
+	TArray<FString> Settings;
+	if (!GConfig->GetSection(*ProfileSection, Settings, GEngineIni))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Render profile %s not found, expected a [%s] section"), *ProfileName, *ProfileSection);
+		return false;
+	}
+
+	Restore();
+	for (const FString& Setting : Settings)
+	{
+		FString Key;
+		FString Value;
+		if (!Setting.Split(TEXT("="), &Key, &Value))
+		{
+			continue;
+		}
+
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(*Key);
+		if (!Variable)
+		{
+			UE_LOG(LogDolbyIODebug, Warning, TEXT("Render profile %s: unknown console variable %s"), *ProfileName, *Key);
+			continue;
+		}
+		if (Variable->TestFlags(ECVF_ReadOnly))
+		{
+			UE_LOG(LogDolbyIODebug, Warning, TEXT("Render profile %s: %s is read-only, set it in the config instead"), *ProfileName, *Key);
+			continue;
+		}
+
+		// What was set on the command line or the console is a deliberate choice, and the console would reject code anyway
+		const EConsoleVariableFlags SetBy = GetSetBy(Variable);
+		if (SetBy == ECVF_SetByCommandline || SetBy > ECVF_SetByCode)
+		{
+			UE_LOG(LogDolbyIODebug, Log, TEXT("Render profile %s: %s is set from the command line or console, kept at %s"), *ProfileName,
+			       *Key, *Variable->GetString());
+			continue;
+		}
+
+		RestoreValues.Add({Key, Variable->GetString(), SetBy});
+		Variable->Set(*Value, ECVF_SetByCode);
+		UE_LOG(LogDolbyIODebug, Log, TEXT("Render profile %s: %s=%s"), *ProfileName, *Key, *Value);
+	}
+
+	ActiveProfileName = ProfileName;
+	LastProfileName = ProfileName;
+	TRACE_BOOKMARK(TEXT("DolbyIODebug render profile %s"), *ProfileName);
+	return true;
+}
+
+void FDolbyIODebugRenderProfile::Restore()
+{
+	using namespace DolbyIODebugRenderProfile;
+
+	if (ActiveProfileName.IsEmpty())
+	{
+		return;
+	}
+
+	// In reverse, so that a variable listed twice ends up with the value it had first
+	for (int32 Index = RestoreValues.Num() - 1; Index >= 0; --Index)
+	{
+		const FRestoreValue& RestoreValue = RestoreValues[Index];
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(*RestoreValue.Name);
+		// Left alone if it was set from the console since, which is the newer choice
+		if (!Variable || GetSetBy(Variable) > ECVF_SetByCode)
+		{
+			continue;
+		}
+
+		// A lower priority would be rejected over the profile's code priority, so the original one is put back afterwards
+		Variable->Set(*RestoreValue.Value, ECVF_SetByCode);
+		Variable->SetFlags(static_cast<EConsoleVariableFlags>((Variable->GetFlags() & ~ECVF_SetByMask) | RestoreValue.SetBy));
+	}
+	RestoreValues.Reset();
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Render profile %s restored"), *ActiveProfileName);
+	ActiveProfileName.Reset();
+	TRACE_BOOKMARK(TEXT("DolbyIODebug render profile restored"));
+}
+
+void FDolbyIODebugRenderProfile::Toggle()
+{
+	using namespace DolbyIODebugRenderProfile;
+
+	if (!ActiveProfileName.IsEmpty())
+	{
+		Restore();
+	}
+	else if (!LastProfileName.IsEmpty())
+	{
+		Apply(LastProfileName);
+	}
+}
+
+const FString& FDolbyIODebugRenderProfile::GetActiveProfileName()
+{
+	return DolbyIODebugRenderProfile::ActiveProfileName;
+}
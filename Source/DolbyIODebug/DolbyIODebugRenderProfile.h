@@ -0,0 +1,30 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Renderer settings profiles, applied at runtime on top of the project's renderer settings.
+ *
+ * A profile is the [DolbyIODebug.RenderProfile.<Name>] section of the engine config, whose keys are console variables
+ * set with code priority. The values they had are kept, so that Restore puts the project's rendering back and a
+ * profile can be toggled while running to compare the cost of the media pipeline with and without a realistic
+ * rendering load. Restoring also puts back the priority each value was set with. Read-only variables, which only take
+ * effect from the config at startup, are skipped, and so are variables set from the command line or the console.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugRenderProfile
+{
+public:
+	/** Applies a profile, replacing the one applied before. Returns false if the profile does not exist. */
+	static bool Apply(const FString& ProfileName);
+
+	/** Restores the values the variables of the active profile had before it was applied. */
+	static void Restore();
+
+	/** Restores the active profile, or applies the last one again if none is active. */
+	static void Toggle();
+
+	/** Name of the profile that is applied, empty if none. */
+	static const FString& GetActiveProfileName();
+};
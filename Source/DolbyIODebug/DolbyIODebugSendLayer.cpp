@@ -0,0 +1,188 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugSendLayer.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugDeviceRegistry.h"
+#include "DolbyIODebugSession.h"
+#include "DolbyIODebugVideoSwitcher.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "Engine/GameInstance.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Send layer"), STAT_DolbyIOVideoSendLayer, STATGROUP_DolbyIOVideo);
+
+namespace DolbyIODebugSendLayer
+{
+	/** A step down this soon after a restore doubles the next restore delay, up to MaxRestoreDelay. */
+	constexpr float FailedRestoreWindow = 5.0f;
+	constexpr float MaxRestoreDelay = 120.0f;
+
+	/** Weight of the last sample in the smoothed CPU use. */
+	constexpr float CpuSmoothingFactor = 0.3f;
+}
+
+void UDolbyIODebugSendLayerController::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIODebugSession>();
+	Collection.InitializeDependency<UDolbyIODebugDeviceRegistry>();
+	Collection.InitializeDependency<UDolbyIODebugVideoSwitcher>();
+
+	EvaluateHandle = FTSTicker::GetCoreTicker().AddTicker(
+	    FTickerDelegate::CreateUObject(this, &UDolbyIODebugSendLayerController::Evaluate), EvaluationInterval);
+}
+
+void UDolbyIODebugSendLayerController::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(EvaluateHandle);
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugSendLayerController::SubmitSendStats(const FDolbyIODebugSendStats& Stats)
+{
+	LastStats = Stats;
+	LastStatsTime = FPlatformTime::Seconds();
+}
+
+bool UDolbyIODebugSendLayerController::GetRecentSendStats(FDolbyIODebugSendStats& OutStats) const
+{
+	if (FPlatformTime::Seconds() - LastStatsTime > StatsTimeout)
+	{
+		return false;
+	}
+	OutStats = LastStats;
+	return true;
+}
+
+float UDolbyIODebugSendLayerController::GetLayerBitrateKbps(EDolbyIODebugSendLayer SendLayer) const
+{
+	switch (SendLayer)
+	{
+		case EDolbyIODebugSendLayer::High:
+			return HighBitrateKbps;
+		case EDolbyIODebugSendLayer::Medium:
+			return MediumBitrateKbps;
+		case EDolbyIODebugSendLayer::Low:
+			return LowBitrateKbps;
+		default:
+			return 0.0f;
+	}
+}
+
+bool UDolbyIODebugSendLayerController::Evaluate(float DeltaTime)
+{
+	using namespace DolbyIODebugSendLayer;
+
+	if (!bEnabled)
+	{
+		SetLayer(EDolbyIODebugSendLayer::High);
+		return true;
+	}
+
+	const float SampleCpuPercent = FPlatformTime::GetCPUTime().CPUTimePct;
+	CpuPercent = CpuPercent > 0.0f ? FMath::Lerp(CpuPercent, SampleCpuPercent, CpuSmoothingFactor) : SampleCpuPercent;
+
+	// Stepping up needs the headroom at the layer above, so that it is not undone by the next evaluation
+	const int32 LayerIndex = static_cast<int32>(Layer);
+	const int32 LastLayerIndex = static_cast<int32>(EDolbyIODebugSendLayer::Off);
+	TimeSinceRestore += DeltaTime;
+	if (LayerIndex < LastLayerIndex && !IsWithinBudget(Layer, 1.0f))
+	{
+		TimeUnderBudget = 0.0f;
+		TimeOverBudget += DeltaTime;
+		if (TimeOverBudget >= DegradeDelay)
+		{
+			if (TimeSinceRestore < FailedRestoreWindow)
+			{
+				BackoffRestoreDelay = FMath::Min(FMath::Max(BackoffRestoreDelay, RestoreDelay) * 2.0f, MaxRestoreDelay);
+			}
+			TimeOverBudget = 0.0f;
+			SetLayer(static_cast<EDolbyIODebugSendLayer>(LayerIndex + 1));
+		}
+	}
+	else if (LayerIndex > 0 && IsWithinBudget(static_cast<EDolbyIODebugSendLayer>(LayerIndex - 1), 1.0f - Hysteresis))
+	{
+		TimeOverBudget = 0.0f;
+		TimeUnderBudget += DeltaTime;
+		if (TimeUnderBudget >= FMath::Max(BackoffRestoreDelay, RestoreDelay))
+		{
+			TimeUnderBudget = 0.0f;
+			TimeSinceRestore = 0.0f;
+			SetLayer(static_cast<EDolbyIODebugSendLayer>(LayerIndex - 1));
+		}
+	}
+	else
+	{
+		TimeOverBudget = 0.0f;
+		TimeUnderBudget = 0.0f;
+	}
+	return true;
+}
+
+bool UDolbyIODebugSendLayerController::IsWithinBudget(EDolbyIODebugSendLayer SendLayer, float Margin) const
+{
+	// Off is for a link that cannot carry Low: below it the CPU has nothing left to gain, and above it only if a sender
+	// actually encodes the layer it is told
+	if (SendLayer != EDolbyIODebugSendLayer::Low && AreLayersApplied() && CpuPercent > MaxCpuPercent * Margin)
+	{
+		return false;
+	}
+
+	FDolbyIODebugSendStats Stats;
+	if (!GetRecentSendStats(Stats))
+	{
+		return true;
+	}
+	return Stats.AvailableBitrateKbps * Margin >= GetLayerBitrateKbps(SendLayer) && Stats.RttMs <= MaxRttMs * Margin &&
+	       Stats.PacketLoss <= MaxPacketLoss * Margin && Stats.EncodeMs <= MaxEncodeMs * Margin;
+}
+
+bool UDolbyIODebugSendLayerController::AreLayersApplied() const
+{
+	return OnSendLayerChangedNative.IsBound() || OnSendLayerChanged.IsBound();
+}
+
+void UDolbyIODebugSendLayerController::SetLayer(EDolbyIODebugSendLayer NewLayer)
+{
+	SET_DWORD_STAT(STAT_DolbyIOVideoSendLayer, static_cast<uint32>(NewLayer));
+	if (NewLayer == Layer)
+	{
+		return;
+	}
+
+	const EDolbyIODebugSendLayer OldLayer = Layer;
+	Layer = NewLayer;
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Send layer %s at %.0f%% CPU, %.0f kbps available, %.0f ms RTT, %.1f%% loss"),
+	       *StaticEnum<EDolbyIODebugSendLayer>()->GetNameStringByValue(static_cast<int64>(Layer)), CpuPercent,
+	       LastStats.AvailableBitrateKbps, LastStats.RttMs, LastStats.PacketLoss * 100.0f);
+
+	UDolbyIODebugVideoSwitcher* VideoSwitcher = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoSwitcher>(this);
+	const UDolbyIODebugSession* Session = DolbyIODebug::GetSubsystem<UDolbyIODebugSession>(this);
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (VideoSwitcher && Layer == EDolbyIODebugSendLayer::Off)
+	{
+		// The session follows every enable, the switcher only its own, so it knows best which device is live
+		if (Session && DeviceRegistry && !Session->GetLiveVideoTrackID().IsEmpty() &&
+		    DeviceRegistry->IsValidIndex(Session->GetLiveVideoDeviceIndex()))
+		{
+			SwitchedOffDevice = DeviceRegistry->GetDevice(Session->GetLiveVideoDeviceIndex());
+		}
+		else
+		{
+			SwitchedOffDevice = VideoSwitcher->GetCurrentDevice();
+		}
+		if (SwitchedOffDevice)
+		{
+			VideoSwitcher->SwitchOff();
+		}
+	}
+	else if (VideoSwitcher && OldLayer == EDolbyIODebugSendLayer::Off && SwitchedOffDevice)
+	{
+		VideoSwitcher->SwitchTo(*SwitchedOffDevice);
+		SwitchedOffDevice.Reset();
+	}
+
+	OnSendLayerChangedNative.Broadcast(Layer);
+	OnSendLayerChanged.Broadcast(Layer);
+}
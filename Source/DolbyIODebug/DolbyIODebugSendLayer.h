@@ -0,0 +1,150 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugSendLayer.generated.h"
+
+UENUM(BlueprintType)
+enum class EDolbyIODebugSendLayer : uint8
+{
+	High,
+	Medium,
+	Low,
+	/** Not even the lowest layer fits, the local video is better off than frozen. */
+	Off,
+};
+
+/** Send-side statistics of the local video, as reported by whatever can read them from the connection. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugSendStats
+{
+	GENERATED_BODY()
+
+	/** Estimated bandwidth available for sending, not the bitrate currently sent. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug")
+	float AvailableBitrateKbps = 0.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (Units = "ms"))
+	float RttMs = 0.0f;
+
+	/** Fraction of the packets sent that were lost. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float PacketLoss = 0.0f;
+
+	/** Average time the encoder spent on a frame. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (Units = "ms"))
+	float EncodeMs = 0.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnSendLayerChangedNative, EDolbyIODebugSendLayer);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnSendLayerChanged, EDolbyIODebugSendLayer, Layer);
+
+/**
+ * Picks the simulcast layer the local video can afford from the uplink and the local CPU.
+ *
+ * Every EvaluationInterval the last send statistics and the CPU use of the process are checked against the budget of
+ * the current layer: a bandwidth estimate below its bitrate, or a round trip, a packet loss, an encode time or a CPU
+ * use above their maximum. While over budget for DegradeDelay the layer steps down; it steps back up only once every
+ * signal has Hysteresis of headroom, the bandwidth against the bitrate of the layer above, for RestoreDelay, which
+ * doubles whenever a restore has to be undone right away, so the layer does not oscillate on a fluctuating link.
+ *
+ * The SDK reports neither send statistics nor lets the simulcast layers be picked, so the statistics come from
+ * SubmitSendStats and the layer is broadcast for whatever sends the video. The CPU only counts while something listens
+ * to OnSendLayerChanged, since stepping down lowers the encode load only if a sender applies the layer, and never
+ * takes the video from Low to Off. What the controller acts on itself is Off, reached on the statistics alone, where
+ * the local video is switched off through UDolbyIODebugVideoSwitcher and back on to the same device once Low fits again.
+ * UDolbyIODebugDeviceCyclerComponent holds its cycle while the layer is Off, and resumes it from that device.
+ */
+UCLASS(Config = Game)
+class DOLBYIODEBUG_API UDolbyIODebugSendLayerController : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug")
+	bool bEnabled = true;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Layers", Meta = (ClampMin = "0.0"))
+	float HighBitrateKbps = 2500.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Layers", Meta = (ClampMin = "0.0"))
+	float MediumBitrateKbps = 800.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Layers", Meta = (ClampMin = "0.0"))
+	float LowBitrateKbps = 150.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Budget", Meta = (ClampMin = "0.0", Units = "ms"))
+	float MaxRttMs = 400.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Budget", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MaxPacketLoss = 0.05f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Budget", Meta = (ClampMin = "0.0", Units = "ms"))
+	float MaxEncodeMs = 20.0f;
+
+	/** CPU use of the process, as a percentage of the whole machine. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug|Budget", Meta = (ClampMin = "0.0", ClampMax = "100.0"))
+	float MaxCpuPercent = 85.0f;
+
+	/** Headroom every signal needs before stepping up, as a fraction of its budget. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Hysteresis = 0.2f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "s"))
+	float DegradeDelay = 2.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "s"))
+	float RestoreDelay = 10.0f;
+
+	/** Statistics older than this are ignored, as if none had been reported. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.1", Units = "s"))
+	float StatsTimeout = 5.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.05", Units = "s"))
+	float EvaluationInterval = 0.5f;
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void SubmitSendStats(const FDolbyIODebugSendStats& Stats);
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	EDolbyIODebugSendLayer GetLayer() const { return Layer; }
+
+	/** Returns false if no statistics were reported within StatsTimeout. */
+	bool GetRecentSendStats(FDolbyIODebugSendStats& OutStats) const;
+
+	/** Bitrate the layer is sent at, 0 for Off. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	float GetLayerBitrateKbps(EDolbyIODebugSendLayer SendLayer) const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnSendLayerChanged OnSendLayerChanged;
+	FDolbyIODebugOnSendLayerChangedNative OnSendLayerChangedNative;
+
+private:
+	bool Evaluate(float DeltaTime);
+	/** Whether the signals are within Margin of their budget at the layer. */
+	bool IsWithinBudget(EDolbyIODebugSendLayer SendLayer, float Margin) const;
+	/** Whether anything listens for the layer, and so changes the encode load along with it. */
+	bool AreLayersApplied() const;
+	void SetLayer(EDolbyIODebugSendLayer NewLayer);
+
+	FDolbyIODebugSendStats LastStats;
+	double LastStatsTime = 0.0;
+	float CpuPercent = 0.0f;
+	EDolbyIODebugSendLayer Layer = EDolbyIODebugSendLayer::High;
+	float TimeOverBudget = 0.0f;
+	float TimeUnderBudget = 0.0f;
+	/** Grows when restores are undone right away. */
+	float BackoffRestoreDelay = 0.0f;
+	float TimeSinceRestore = TNumericLimits<float>::Max();
+	/** Device the video was switched off from at Off, to switch back on to. */
+	TOptional<FDolbyIOVideoDevice> SwitchedOffDevice;
+	FTSTicker::FDelegateHandle EvaluateHandle;
+};
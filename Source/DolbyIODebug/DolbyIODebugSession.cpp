@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugSession.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugVideoEvents.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UObjectGlobals.h"
+
+void UDolbyIODebugSession::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugVideoEvents>();
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnConnected.AddDynamic(this, &UDolbyIODebugSession::HandleConnected);
+		DolbyIOSubsystem->OnDisconnected.AddDynamic(this, &UDolbyIODebugSession::HandleDisconnected);
+	}
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugSession::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugSession::HandleVideoDisabled);
+	}
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddUObject(this, &UDolbyIODebugSession::HandlePreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UDolbyIODebugSession::HandlePostLoadMap);
+}
+
+void UDolbyIODebugSession::Deinitialize()
+{
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnConnected.RemoveDynamic(this, &UDolbyIODebugSession::HandleConnected);
+		DolbyIOSubsystem->OnDisconnected.RemoveDynamic(this, &UDolbyIODebugSession::HandleDisconnected);
+	}
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugSession::Connect(const FString& InConferenceName, const FString& UserName)
+{
+	if ((bConnecting || bConnected) && ConferenceName == InConferenceName)
+	{
+		UE_LOG(LogDolbyIODebug, Log, TEXT("Reusing the session of conference %s"), *ConferenceName);
+		return;
+	}
+
+	UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+	if (!DolbyIOSubsystem)
+	{
+		return;
+	}
+
+	ConferenceName = InConferenceName;
+	bConnecting = true;
+	DolbyIOSubsystem->Connect(ConferenceName, UserName);
+}
+
+void UDolbyIODebugSession::HandleConnected(const FString& InLocalParticipantID, const FString& InConferenceID)
+{
+	bConnecting = false;
+	bConnected = true;
+	LocalParticipantID = InLocalParticipantID;
+	ConferenceID = InConferenceID;
+	BroadcastSessionReady();
+}
+
+void UDolbyIODebugSession::HandleDisconnected()
+{
+	bConnecting = false;
+	bConnected = false;
+	ConferenceName.Reset();
+	ConferenceID.Reset();
+	LocalParticipantID.Reset();
+}
+
+void UDolbyIODebugSession::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	UDolbyIODebugVideoEvents::AssignID(LiveVideoTrackID, VideoTrackID);
+}
+
+void UDolbyIODebugSession::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	LiveVideoTrackID.Reset();
+	LiveVideoDeviceIndex = INDEX_NONE;
+}
+
+void UDolbyIODebugSession::HandlePreLoadMap(const FString& MapName)
+{
+	MapLoadStartTime = FPlatformTime::Seconds();
+}
+
+void UDolbyIODebugSession::HandlePostLoadMap(UWorld* World)
+{
+	if (!World || World->GetGameInstance() != GetGameInstance() || !bConnected)
+	{
+		return;
+	}
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Conference %s kept through the load of %s (%.0f ms), video %s"), *ConferenceID, *World->GetMapName(),
+	       MapLoadStartTime > 0.0 ? (FPlatformTime::Seconds() - MapLoadStartTime) * 1000.0 : 0.0,
+	       LiveVideoTrackID.IsEmpty() ? TEXT("disabled") : *LiveVideoTrackID);
+	BroadcastSessionReady();
+}
+
+void UDolbyIODebugSession::BroadcastSessionReady()
+{
+	OnSessionReadyNative.Broadcast();
+	OnSessionReady.Broadcast();
+}
@@ -0,0 +1,84 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugSession.generated.h"
+
+DECLARE_MULTICAST_DELEGATE(FDolbyIODebugOnSessionReady);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDolbyIODebugOnSessionReadyDelegate);
+
+/**
+ * Owns the conference session for the lifetime of the game instance, so that it survives map travel.
+ *
+ * Connecting to the conference that is already connected or connecting does nothing, so a level that connects on
+ * BeginPlay reuses the session instead of building it again every time it is loaded. The live local video device is
+ * remembered as well, and UDolbyIODebugDeviceCyclerComponent leaves the video enabled through a level transition and
+ * resumes from that device. OnSessionReady is broadcast when the connection is established and again after every map
+ * load while connected, so actors of the new map that bound to it on BeginPlay are handed the session they missed.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugSession : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	/** Connects to a conference, unless already connected or connecting to it. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void Connect(const FString& ConferenceName, const FString& UserName);
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsConnected() const { return bConnected; }
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	FString GetConferenceID() const { return ConferenceID; }
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	FString GetLocalParticipantID() const { return LocalParticipantID; }
+
+	/** Track of the local video, empty while it is disabled. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	FString GetLiveVideoTrackID() const { return LiveVideoTrackID; }
+
+	/** UDolbyIODebugDeviceRegistry index of the device of the local video, INDEX_NONE unless whoever enabled it told the session. */
+	int32 GetLiveVideoDeviceIndex() const { return LiveVideoDeviceIndex; }
+
+	/**
+	 * The SDK events only carry the track, so whoever enables a device tells the session which one it was. By its
+	 * registry index, so that cycling through devices does not copy them.
+	 */
+	void SetLiveVideoDeviceIndex(int32 DeviceIndex) { LiveVideoDeviceIndex = DeviceIndex; }
+
+	FDolbyIODebugOnSessionReady OnSessionReadyNative;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnSessionReadyDelegate OnSessionReady;
+
+private:
+	UFUNCTION()
+	void HandleConnected(const FString& InLocalParticipantID, const FString& InConferenceID);
+	UFUNCTION()
+	void HandleDisconnected();
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+
+	void HandlePreLoadMap(const FString& MapName);
+	void HandlePostLoadMap(UWorld* World);
+	void BroadcastSessionReady();
+
+	FString ConferenceName;
+	FString ConferenceID;
+	FString LocalParticipantID;
+	FString LiveVideoTrackID;
+	int32 LiveVideoDeviceIndex = INDEX_NONE;
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	double MapLoadStartTime = 0.0;
+	bool bConnecting = false;
+	bool bConnected = false;
+};
@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugSpatialBatcherComponent.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugGameModeBase.h"
+#include "DolbyIODebugStartupProfiler.h"
+
+#include "DolbyIOSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "TimerManager.h"
+
+namespace DolbyIODebugSpatialBatcher
+{
+	constexpr float DefaultFlushRate = 30.0f;
+}
+
+UDolbyIODebugSpatialBatcherComponent* UDolbyIODebugSpatialBatcherComponent::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const ADolbyIODebugGameModeBase* GameMode = World ? World->GetAuthGameMode<ADolbyIODebugGameModeBase>() : nullptr;
+	return GameMode ? GameMode->GetSpatialBatcher() : nullptr;
+}
+
+void UDolbyIODebugSpatialBatcherComponent::SetLocalPlayerLocation(const FVector& Location)
+{
+	Queue(LocalLocation, Location);
+}
+
+void UDolbyIODebugSpatialBatcherComponent::SetLocalPlayerRotation(const FRotator& Rotation)
+{
+	Queue(LocalRotation, Rotation);
+}
+
+void UDolbyIODebugSpatialBatcherComponent::SetRemotePlayerLocation(const FString& ParticipantID, const FVector& Location)
+{
+	TBatchedValue<FVector>& RemoteLocation = RemoteLocations.FindOrAdd(ParticipantID);
+	NumPendingRemoteLocations += RemoteLocation.bPending ? 0 : 1;
+	Queue(RemoteLocation, Location);
+}
+
+void UDolbyIODebugSpatialBatcherComponent::RemoveRemotePlayer(const FString& ParticipantID)
+{
+	TBatchedValue<FVector> RemoteLocation;
+	if (RemoteLocations.RemoveAndCopyValue(ParticipantID, RemoteLocation) && RemoteLocation.bPending)
+	{
+		--NumPendingRemoteLocations;
+	}
+}
+
+template <typename ValueType>
+void UDolbyIODebugSpatialBatcherComponent::Queue(TBatchedValue<ValueType>& Value, const ValueType& NewValue)
+{
+	++Stats.UpdatesRequested;
+	Stats.UpdatesCoalesced += Value.bPending ? 1 : 0;
+	Value.Pending = NewValue;
+	Value.bPending = true;
+}
+
+void UDolbyIODebugSpatialBatcherComponent::Flush()
+{
+	if (!LocalLocation.bPending && !LocalRotation.bPending && NumPendingRemoteLocations == 0)
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DolbyIODebugSpatialFlush, DolbyIODebugChannel);
+	UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+	if (!DolbyIOSubsystem)
+	{
+		return;
+	}
+	++Stats.Flushes;
+
+	const auto ShouldSend = [this](auto& Value, bool bMoved)
+	{
+		Value.bPending = false;
+		if (Value.bSent && !bMoved)
+		{
+			++Stats.UpdatesBelowThreshold;
+			return false;
+		}
+		Value.Sent = Value.Pending;
+		Value.bSent = true;
+		++Stats.UpdatesSent;
+		return true;
+	};
+
+	if (LocalLocation.bPending &&
+	    ShouldSend(LocalLocation, FVector::DistSquared(LocalLocation.Pending, LocalLocation.Sent) > FMath::Square(LocationThreshold)))
+	{
+		DolbyIOSubsystem->SetLocalPlayerLocation(LocalLocation.Sent);
+	}
+
+	if (LocalRotation.bPending &&
+	    ShouldSend(LocalRotation, !LocalRotation.Pending.Equals(LocalRotation.Sent, RotationThreshold)))
+	{
+		DolbyIOSubsystem->SetLocalPlayerRotation(LocalRotation.Sent);
+	}
+
+	if (NumPendingRemoteLocations > 0)
+	{
+		for (TPair<FString, TBatchedValue<FVector>>& RemoteLocation : RemoteLocations)
+		{
+			TBatchedValue<FVector>& Value = RemoteLocation.Value;
+			if (Value.bPending &&
+			    ShouldSend(Value, FVector::DistSquared(Value.Pending, Value.Sent) > FMath::Square(LocationThreshold)))
+			{
+				DolbyIOSubsystem->SetRemotePlayerLocation(RemoteLocation.Key, Value.Sent);
+			}
+		}
+		NumPendingRemoteLocations = 0;
+	}
+}
+
+void UDolbyIODebugSpatialBatcherComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const float Interval = GetEffectiveFlushInterval();
+	GetWorld()->GetTimerManager().SetTimer(FlushTimerHandle, this, &UDolbyIODebugSpatialBatcherComponent::Flush, Interval, true);
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Flushing spatial updates every %.1f ms"), Interval * 1000.0f);
+}
+
+void UDolbyIODebugSpatialBatcherComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	GetWorld()->GetTimerManager().ClearTimer(FlushTimerHandle);
+	Flush();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float UDolbyIODebugSpatialBatcherComponent::GetEffectiveFlushInterval() const
+{
+	if (FlushInterval > 0.0f)
+	{
+		return FlushInterval;
+	}
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const float TickRate = NetDriver ? static_cast<float>(NetDriver->GetNetServerMaxTickRate()) : 0.0f;
+	return 1.0f / (TickRate > 0.0f ? TickRate : DolbyIODebugSpatialBatcher::DefaultFlushRate);
+}
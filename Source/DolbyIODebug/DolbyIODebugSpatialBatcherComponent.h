@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "DolbyIODebugSpatialBatcherComponent.generated.h"
+
+/** Counters of a spatial batcher, to compare the updates requested with those that reached the SDK. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugSpatialBatchStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 UpdatesRequested = 0;
+
+	/** Replaced by a later update of the same value before the flush. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 UpdatesCoalesced = 0;
+
+	/** Dropped at the flush for being within the thresholds of the last value sent. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 UpdatesBelowThreshold = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 UpdatesSent = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int64 Flushes = 0;
+};
+
+/**
+ * Batches the spatial audio updates of every player into one flush per network tick.
+ *
+ * Actors queue their positions here instead of calling the SDK every tick. Each value (the local location, the local
+ * rotation and the location of every remote participant) keeps only its latest update, and at the flush it is sent
+ * only if it moved further than the thresholds from the last value sent, so the SDK never lags by more than one
+ * threshold. Owned by ADolbyIODebugGameModeBase; Get finds the one of a world.
+ */
+UCLASS(ClassGroup = (DolbyIO), Meta = (BlueprintSpawnableComponent))
+class DOLBYIODEBUG_API UDolbyIODebugSpatialBatcherComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** Seconds between flushes, 0 to flush at the net driver's tick rate, or 30 times per second without one. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "s"))
+	float FlushInterval = 0.0f;
+
+	/** Locations closer than this to the last one sent are not sent. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "cm"))
+	float LocationThreshold = 10.0f;
+
+	/** Rotations closer than this to the last one sent are not sent. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "deg"))
+	float RotationThreshold = 2.0f;
+
+	/** The batcher of the world's game mode, if it has one. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug", Meta = (WorldContext = "WorldContextObject"))
+	static UDolbyIODebugSpatialBatcherComponent* Get(const UObject* WorldContextObject);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void SetLocalPlayerLocation(const FVector& Location);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void SetLocalPlayerRotation(const FRotator& Rotation);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void SetRemotePlayerLocation(const FString& ParticipantID, const FVector& Location);
+
+	/** Forgets a participant that left, so that its next location is sent whatever it is. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void RemoveRemotePlayer(const FString& ParticipantID);
+
+	/** Sends the pending updates now. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void Flush();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	FDolbyIODebugSpatialBatchStats GetStats() const { return Stats; }
+
+protected:
+	void BeginPlay() override;
+	void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	template <typename ValueType>
+	struct TBatchedValue
+	{
+		ValueType Pending;
+		ValueType Sent;
+		bool bPending = false;
+		bool bSent = false;
+	};
+
+	template <typename ValueType>
+	void Queue(TBatchedValue<ValueType>& Value, const ValueType& NewValue);
+
+	float GetEffectiveFlushInterval() const;
+
+	TBatchedValue<FVector> LocalLocation;
+	TBatchedValue<FRotator> LocalRotation;
+	TMap<FString, TBatchedValue<FVector>> RemoteLocations;
+	int32 NumPendingRemoteLocations = 0;
+	FDolbyIODebugSpatialBatchStats Stats;
+	FTimerHandle FlushTimerHandle;
+};
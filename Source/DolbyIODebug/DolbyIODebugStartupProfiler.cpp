@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugStartupProfiler.h"
+#include "DolbyIODebug.h"
+
+#include "Algo/StableSort.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(DolbyIODebugChannel);
+
+FDolbyIODebugStartupProfiler& FDolbyIODebugStartupProfiler::Get()
+{
+	static FDolbyIODebugStartupProfiler Instance;
+	return Instance;
+}
+
+FDolbyIODebugStartupProfiler::FDolbyIODebugStartupProfiler()
+{
+	for (double& PhaseTime : PhaseTimes)
+	{
+		PhaseTime = -1.0;
+	}
+}
+
+void FDolbyIODebugStartupProfiler::MarkPhase(EDolbyIODebugStartupPhase Phase)
+{
+	check(IsInGameThread());
+
+	if (bSummaryWritten || HasPhase(Phase))
+	{
+		return;
+	}
+
+	PhaseTimes[static_cast<int32>(Phase)] = FPlatformTime::Seconds() - GStartTime;
+	TRACE_BOOKMARK(TEXT("DolbyIODebug startup: %s"), GetPhaseName(Phase));
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Startup phase %s reached %.1f ms after launch"), GetPhaseName(Phase),
+	       PhaseTimes[static_cast<int32>(Phase)] * 1000.0);
+
+	if (Phase == EDolbyIODebugStartupPhase::FirstVideoFrame)
+	{
+		WriteSummary();
+	}
+}
+
+void FDolbyIODebugStartupProfiler::WriteSummary()
+{
+	if (bSummaryWritten)
+	{
+		return;
+	}
+	bSummaryWritten = true;
+
+	// Phases are listed in the order they were reached, which is not always the order of the enum: the SDK subsystem is
+	// initialized with the game instance, before the map is loaded.
+	TArray<EDolbyIODebugStartupPhase, TInlineAllocator<static_cast<int32>(EDolbyIODebugStartupPhase::Count)>> ReachedPhases;
+	TArray<EDolbyIODebugStartupPhase, TInlineAllocator<static_cast<int32>(EDolbyIODebugStartupPhase::Count)>> MissedPhases;
+	for (int32 Index = 0; Index < static_cast<int32>(EDolbyIODebugStartupPhase::Count); ++Index)
+	{
+		const EDolbyIODebugStartupPhase Phase = static_cast<EDolbyIODebugStartupPhase>(Index);
+		(HasPhase(Phase) ? ReachedPhases : MissedPhases).Add(Phase);
+	}
+	Algo::StableSortBy(ReachedPhases, [this](EDolbyIODebugStartupPhase Phase) { return PhaseTimes[static_cast<int32>(Phase)]; });
+
+	FString Csv = TEXT("Phase,SinceLaunchMs,SincePreviousMs") LINE_TERMINATOR;
+	double PreviousTime = 0.0;
+	UE_LOG(LogDolbyIODebug, Display, TEXT("Startup summary:"));
+	for (const EDolbyIODebugStartupPhase Phase : ReachedPhases)
+	{
+		const double PhaseTime = PhaseTimes[static_cast<int32>(Phase)];
+		const double SinceLaunchMs = PhaseTime * 1000.0;
+		const double SincePreviousMs = (PhaseTime - PreviousTime) * 1000.0;
+		PreviousTime = PhaseTime;
+		UE_LOG(LogDolbyIODebug, Display, TEXT("  %-24s %10.1f ms  (+%.1f ms)"), GetPhaseName(Phase), SinceLaunchMs, SincePreviousMs);
+		Csv += FString::Printf(TEXT("%s,%.3f,%.3f") LINE_TERMINATOR, GetPhaseName(Phase), SinceLaunchMs, SincePreviousMs);
+	}
+	for (const EDolbyIODebugStartupPhase Phase : MissedPhases)
+	{
+		UE_LOG(LogDolbyIODebug, Display, TEXT("  %-24s not reached"), GetPhaseName(Phase));
+		Csv += FString::Printf(TEXT("%s,,") LINE_TERMINATOR, GetPhaseName(Phase));
+	}
+
+	const FString Path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Profiling"),
+	                                     FString::Printf(TEXT("DolbyIODebugStartup-%s.csv"), *FDateTime::Now().ToString()));
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to write the startup summary to %s"), *Path);
+	}
+}
+
+const TCHAR* FDolbyIODebugStartupProfiler::GetPhaseName(EDolbyIODebugStartupPhase Phase)
+{
+	switch (Phase)
+	{
+		case EDolbyIODebugStartupPhase::ModuleStartup:
+			return TEXT("ModuleStartup");
+		case EDolbyIODebugStartupPhase::MapLoaded:
+			return TEXT("MapLoaded");
+		case EDolbyIODebugStartupPhase::SdkSubsystemInitialized:
+			return TEXT("SdkSubsystemInitialized");
+		case EDolbyIODebugStartupPhase::TokenRequested:
+			return TEXT("TokenRequested");
+		case EDolbyIODebugStartupPhase::TokenSet:
+			return TEXT("TokenSet");
+		case EDolbyIODebugStartupPhase::DevicesEnumerated:
+			return TEXT("DevicesEnumerated");
+		case EDolbyIODebugStartupPhase::VideoEnabled:
+			return TEXT("VideoEnabled");
+		case EDolbyIODebugStartupPhase::FirstVideoFrame:
+			return TEXT("FirstVideoFrame");
+		default:
+			return TEXT("Unknown");
+	}
+}
@@ -0,0 +1,55 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+
+/** Trace channel of the module, enabled with -trace=DolbyIODebug (add cpu for the scopes). */
+UE_TRACE_CHANNEL_EXTERN(DolbyIODebugChannel, DOLBYIODEBUG_API);
+
+/**
+ * The milestones between process launch and the first video frame, roughly in the order they are expected. The summary
+ * lists them in the order they were actually reached.
+ */
+enum class EDolbyIODebugStartupPhase : uint8
+{
+	ModuleStartup,
+	MapLoaded,
+	SdkSubsystemInitialized,
+	TokenRequested,
+	TokenSet,
+	DevicesEnumerated,
+	VideoEnabled,
+	FirstVideoFrame,
+
+	Count
+};
+
+/**
+ * Measures the cold start of the game, from process launch to the first video frame.
+ *
+ * Each phase is recorded the first time it is reached, as an Insights bookmark and as a timestamp relative to process
+ * launch. Reaching FirstVideoFrame ends startup: the summary is logged and written to Saved/Profiling. Game thread only.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugStartupProfiler
+{
+public:
+	static FDolbyIODebugStartupProfiler& Get();
+
+	void MarkPhase(EDolbyIODebugStartupPhase Phase);
+	bool HasPhase(EDolbyIODebugStartupPhase Phase) const { return PhaseTimes[static_cast<int32>(Phase)] >= 0.0; }
+	bool IsComplete() const { return bSummaryWritten; }
+
+	/** Logs and writes the summary of the phases reached so far. Does nothing if it was already written. */
+	void WriteSummary();
+
+	static const TCHAR* GetPhaseName(EDolbyIODebugStartupPhase Phase);
+
+private:
+	FDolbyIODebugStartupProfiler();
+
+	/** Seconds since process launch at which each phase was reached, negative if it was not. */
+	double PhaseTimes[static_cast<int32>(EDolbyIODebugStartupPhase::Count)];
+	bool bSummaryWritten = false;
+};
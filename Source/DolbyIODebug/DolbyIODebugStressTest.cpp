@@ -0,0 +1,574 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugStressTest.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugDeviceRegistry.h"
+#include "DolbyIODebugEventProcessor.h"
+#include "DolbyIODebugGameModeBase.h"
+#include "DolbyIODebugPreviewTexture.h"
+#include "DolbyIODebugSendLayer.h"
+#include "DolbyIODebugSession.h"
+#include "DolbyIODebugSpatialBatcherComponent.h"
+#include "DolbyIODebugStartupProfiler.h"
+#include "DolbyIODebugSwitchBenchmark.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+namespace DolbyIODebugStressTest
+{
+	constexpr float SampleInterval = 1.0f;
+	constexpr float MoveInterval = 0.1f;
+
+	/** The walk of the local player: its speed, how often it turns on average, and how far it goes from the origin. */
+	constexpr float WalkSpeed = 300.0f;
+	constexpr float WalkTurnInterval = 2.0f;
+	constexpr float WalkRadius = 3000.0f;
+
+	/** Chance for a toggle to switch the video off rather than to another device. */
+	constexpr float SwitchOffChance = 0.2f;
+
+	/** How long past their deadline the other participants are waited for, to start up, write their report and exit. */
+	constexpr float ParticipantExitGrace = 60.0f;
+
+	int64 GetFramesDelivered()
+	{
+		int64 FramesDelivered = 0;
+		for (TObjectIterator<UDolbyIODebugPreviewTexture> It; It; ++It)
+		{
+			FramesDelivered += It->GetStats().FramesPresented;
+		}
+		return FramesDelivered;
+	}
+}
+
+bool UDolbyIODebugStressTest::ShouldCreateSubsystem(UObject* Outer) const
+{
+	FString Conference;
+	return FParse::Value(FCommandLine::Get(), TEXT("DolbyIOStress="), Conference) && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UDolbyIODebugStressTest::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugEventProcessor>();
+	Collection.InitializeDependency<UDolbyIODebugSession>();
+	Collection.InitializeDependency<UDolbyIODebugDeviceRegistry>();
+	Collection.InitializeDependency<UDolbyIODebugVideoSwitcher>();
+	Collection.InitializeDependency<UDolbyIODebugSendLayerController>();
+
+	const TCHAR* CommandLine = FCommandLine::Get();
+	FParse::Value(CommandLine, TEXT("DolbyIOStress="), ConferenceName);
+	FParse::Value(CommandLine, TEXT("DolbyIOStressParticipants="), NumParticipants);
+	FParse::Value(CommandLine, TEXT("DolbyIOStressIndex="), ParticipantIndex);
+	FParse::Value(CommandLine, TEXT("DolbyIOStressDuration="), Duration);
+	FParse::Value(CommandLine, TEXT("DolbyIOStressDwell="), DwellTime);
+	FParse::Value(CommandLine, TEXT("DolbyIOStressConnectTimeout="), ConnectTimeout);
+	FParse::Value(CommandLine, TEXT("DolbyIOStressRun="), RunID);
+	int32 Seed = 0;
+	FParse::Value(CommandLine, TEXT("DolbyIOStressSeed="), Seed);
+	Random.Initialize(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(ParticipantIndex))));
+	if (RunID.IsEmpty())
+	{
+		RunID = FDateTime::Now().ToString();
+	}
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnConnected.AddDynamic(this, &UDolbyIODebugStressTest::HandleConnected);
+	}
+
+	if (ParticipantIndex == 0)
+	{
+		LaunchParticipants();
+	}
+
+	InitializeTime = FPlatformTime::Seconds();
+	UE_LOG(LogDolbyIODebug, Display, TEXT("Stress test %s participant %d of %d, conference %s, %.0f s with a %.1f s dwell"), *RunID,
+	       ParticipantIndex, NumParticipants, *ConferenceName, Duration, DwellTime);
+	SampleTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UDolbyIODebugStressTest::TakeSample),
+	                                                          DolbyIODebugStressTest::SampleInterval);
+}
+
+void UDolbyIODebugStressTest::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(SampleTickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(MoveTickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(ToggleTickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(WaitTickerHandle);
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnConnected.RemoveDynamic(this, &UDolbyIODebugStressTest::HandleConnected);
+	}
+
+	if (UDolbyIODebugVideoSwitcher* VideoSwitcher = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoSwitcher>(this))
+	{
+		VideoSwitcher->OnSwitchCompleted.RemoveDynamic(this, &UDolbyIODebugStressTest::HandleSwitchCompleted);
+	}
+
+	for (FParticipantProcess& ParticipantProcess : ParticipantProcesses)
+	{
+		if (FPlatformProcess::IsProcRunning(ParticipantProcess.Handle))
+		{
+			FPlatformProcess::TerminateProc(ParticipantProcess.Handle, true);
+		}
+		FPlatformProcess::CloseProc(ParticipantProcess.Handle);
+	}
+	ParticipantProcesses.Reset();
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugStressTest::LaunchParticipants()
+{
+	const FString ExecutablePath = FPlatformProcess::ExecutablePath();
+	for (int32 Index = 1; Index < NumParticipants; ++Index)
+	{
+		const FString Params =
+		    FString::Printf(TEXT("%s -DolbyIOStressIndex=%d -DolbyIOStressRun=%s"), FCommandLine::GetOriginal(), Index, *RunID);
+		FProcHandle ParticipantProcess = FPlatformProcess::CreateProc(*ExecutablePath, *Params, false, true, true, nullptr, 0, nullptr, nullptr);
+		if (!ParticipantProcess.IsValid())
+		{
+			UE_LOG(LogDolbyIODebug, Error, TEXT("Failed to launch stress test participant %d"), Index);
+			continue;
+		}
+		ParticipantProcesses.Add({Index, ParticipantProcess});
+	}
+}
+
+bool UDolbyIODebugStressTest::TakeSample(float DeltaTime)
+{
+	// Connecting needs a token, which the token provider or the level sets whenever it gets one
+	if (!bConnectRequested && FDolbyIODebugStartupProfiler::Get().HasPhase(EDolbyIODebugStartupPhase::TokenSet))
+	{
+		if (UDolbyIODebugSession* Session = DolbyIODebug::GetSubsystem<UDolbyIODebugSession>(this))
+		{
+			bConnectRequested = true;
+			Session->Connect(ConferenceName, FString::Printf(TEXT("stress-%d"), ParticipantIndex));
+		}
+	}
+
+	if (ConnectedTime < 0.0)
+	{
+		if (FPlatformTime::Seconds() - InitializeTime < ConnectTimeout)
+		{
+			return true;
+		}
+
+		UE_LOG(LogDolbyIODebug, Error, TEXT("Stress test failed: participant %d did not join conference %s within %.0f s, %s"),
+		       ParticipantIndex, *ConferenceName, ConnectTimeout,
+		       bConnectRequested ? TEXT("the SDK did not answer the join") : TEXT("no token was set"));
+		bFinished = true;
+		bPassed = false;
+		// The report of a participant that never joined, for the summary of the run to say so
+		const TCHAR* const Report = TEXT("Metric,Value") LINE_TERMINATOR TEXT("Connected,0.000") LINE_TERMINATOR TEXT("Passed,0.000") LINE_TERMINATOR;
+		FFileHelper::SaveStringToFile(Report, *GetReportPath(ParticipantIndex));
+		Conclude();
+		return false;
+	}
+
+	FSample& Sample = Samples.AddDefaulted_GetRef();
+	Sample.Time = FPlatformTime::Seconds();
+	Sample.CpuPercent = FPlatformTime::GetCPUTime().CPUTimePctRelative;
+	Sample.UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	Sample.FrameCounter = GFrameCounter;
+	Sample.FramesDelivered = DolbyIODebugStressTest::GetFramesDelivered();
+	FDolbyIODebugSendStats SendStats;
+	const UDolbyIODebugSendLayerController* SendLayerController = DolbyIODebug::GetSubsystem<UDolbyIODebugSendLayerController>(this);
+	if (SendLayerController && SendLayerController->GetRecentSendStats(SendStats))
+	{
+		Sample.UplinkKbps = SendStats.AvailableBitrateKbps;
+		Sample.RttMs = SendStats.RttMs;
+	}
+
+	if (Samples.Num() >= 2 && Sample.Time - ConnectedTime >= Duration)
+	{
+		Finish();
+		return false;
+	}
+	return true;
+}
+
+void UDolbyIODebugStressTest::HandleConnected(const FString& LocalParticipantID, const FString& ConferenceID)
+{
+	if (ConnectedTime >= 0.0)
+	{
+		return;
+	}
+
+	ConnectedTime = FPlatformTime::Seconds();
+	UE_LOG(LogDolbyIODebug, Display, TEXT("Stress test participant %d joined conference %s as %s"), ParticipantIndex, *ConferenceID,
+	       *LocalParticipantID);
+
+	if (UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this))
+	{
+		if (!DeviceRegistry->HasEnumerated())
+		{
+			DeviceRegistry->Refresh();
+		}
+	}
+	if (UDolbyIODebugVideoSwitcher* VideoSwitcher = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoSwitcher>(this))
+	{
+		VideoSwitcher->OnSwitchCompleted.AddDynamic(this, &UDolbyIODebugStressTest::HandleSwitchCompleted);
+	}
+
+	Velocity = Random.GetUnitVector().GetSafeNormal2D() * DolbyIODebugStressTest::WalkSpeed;
+	MoveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UDolbyIODebugStressTest::Move),
+	                                                        DolbyIODebugStressTest::MoveInterval);
+	ScheduleToggle();
+}
+
+bool UDolbyIODebugStressTest::Move(float DeltaTime)
+{
+	using namespace DolbyIODebugStressTest;
+
+	if (Random.FRand() < DeltaTime / WalkTurnInterval)
+	{
+		Velocity = Random.GetUnitVector().GetSafeNormal2D() * WalkSpeed;
+	}
+	if (Location.Size2D() > WalkRadius)
+	{
+		Velocity = -Location.GetSafeNormal2D() * WalkSpeed;
+	}
+	Location += Velocity * DeltaTime;
+
+	// Through the batcher of the game mode when there is one, as a player would
+	const UWorld* World = GetGameInstance()->GetWorld();
+	const ADolbyIODebugGameModeBase* GameMode = World ? World->GetAuthGameMode<ADolbyIODebugGameModeBase>() : nullptr;
+	if (UDolbyIODebugSpatialBatcherComponent* SpatialBatcher = GameMode ? GameMode->GetSpatialBatcher() : nullptr)
+	{
+		SpatialBatcher->SetLocalPlayerLocation(Location);
+		SpatialBatcher->SetLocalPlayerRotation(Velocity.Rotation());
+	}
+	else if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->SetLocalPlayerLocation(Location);
+		DolbyIOSubsystem->SetLocalPlayerRotation(Velocity.Rotation());
+	}
+	return true;
+}
+
+void UDolbyIODebugStressTest::ScheduleToggle()
+{
+	ToggleTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UDolbyIODebugStressTest::Toggle),
+	                                                          DwellTime * Random.FRandRange(0.5f, 1.5f));
+}
+
+bool UDolbyIODebugStressTest::Toggle(float DeltaTime)
+{
+	ToggleTickerHandle.Reset();
+	UDolbyIODebugVideoSwitcher* VideoSwitcher = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoSwitcher>(this);
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	if (!VideoSwitcher || !DeviceRegistry)
+	{
+		return false;
+	}
+
+	TArray<int32> PresentIndices;
+	for (int32 Index = DeviceRegistry->GetNextPresentIndex(INDEX_NONE); Index != INDEX_NONE; Index = DeviceRegistry->GetNextPresentIndex(Index))
+	{
+		PresentIndices.Add(Index);
+	}
+
+	if (VideoSwitcher->GetCurrentDevice() && Random.FRand() < DolbyIODebugStressTest::SwitchOffChance)
+	{
+		VideoSwitcher->SwitchOff();
+	}
+	else if (PresentIndices.Num() > 0)
+	{
+		VideoSwitcher->SwitchTo(DeviceRegistry->GetDevice(PresentIndices[Random.RandHelper(PresentIndices.Num())]));
+	}
+
+	ScheduleToggle();
+	return false;
+}
+
+void UDolbyIODebugStressTest::HandleSwitchCompleted(const FDolbyIODebugSwitchResult& Result)
+{
+	if (Result.Outcome == EDolbyIODebugSwitchOutcome::TimedOut)
+	{
+		++NumSwitchesFailed;
+	}
+	else if (Result.Outcome == EDolbyIODebugSwitchOutcome::Succeeded && !Result.VideoTrackID.IsEmpty())
+	{
+		++NumDeviceActivations;
+		SwitchLatencies.Add(Result.Duration * 1000.0);
+	}
+}
+
+void UDolbyIODebugStressTest::Finish()
+{
+	if (bFinished)
+	{
+		return;
+	}
+	bFinished = true;
+
+	FTSTicker::GetCoreTicker().RemoveTicker(MoveTickerHandle);
+	FTSTicker::GetCoreTicker().RemoveTicker(ToggleTickerHandle);
+	MoveTickerHandle.Reset();
+	ToggleTickerHandle.Reset();
+
+	const FSample& First = Samples[0];
+	const FSample& Last = Samples.Last();
+	const double Elapsed = Last.Time - First.Time;
+
+	float CpuPercentSum = 0.0f;
+	float CpuPercentPeak = 0.0f;
+	uint64 UsedPhysicalPeak = 0;
+	double UplinkKbpsSum = 0.0;
+	double RttMsSum = 0.0;
+	int32 NumSendStats = 0;
+	for (const FSample& Sample : Samples)
+	{
+		CpuPercentSum += Sample.CpuPercent;
+		CpuPercentPeak = FMath::Max(CpuPercentPeak, Sample.CpuPercent);
+		UsedPhysicalPeak = FMath::Max(UsedPhysicalPeak, Sample.UsedPhysical);
+		if (Sample.UplinkKbps >= 0.0f)
+		{
+			UplinkKbpsSum += Sample.UplinkKbps;
+			RttMsSum += Sample.RttMs;
+			++NumSendStats;
+		}
+	}
+
+	SwitchLatencies.Sort();
+	// Nothing was observed without the event processor, as when the game instance is already gone
+	const UDolbyIODebugEventProcessor* EventProcessor = DolbyIODebug::GetSubsystem<UDolbyIODebugEventProcessor>(this);
+	const FDolbyIODebugObserverSnapshot Snapshot = EventProcessor ? EventProcessor->GetLatestSnapshot() : FDolbyIODebugObserverSnapshot{};
+	bPassed = Snapshot.NumVideoEnabled > 0;
+
+	struct FMetric
+	{
+		const TCHAR* Name;
+		double Value;
+	};
+	// -1 when the send statistics were never reported
+	const FMetric Report[] = {
+	    {TEXT("Connected"), 1.0},
+	    {TEXT("Passed"), bPassed ? 1.0 : 0.0},
+	    {TEXT("DurationSeconds"), Elapsed},
+	    {TEXT("CpuPercentAverage"), CpuPercentSum / Samples.Num()},
+	    {TEXT("CpuPercentPeak"), CpuPercentPeak},
+	    {TEXT("UsedPhysicalMBStart"), First.UsedPhysical / (1024.0 * 1024.0)},
+	    {TEXT("UsedPhysicalMBEnd"), Last.UsedPhysical / (1024.0 * 1024.0)},
+	    {TEXT("UsedPhysicalMBPeak"), UsedPhysicalPeak / (1024.0 * 1024.0)},
+	    {TEXT("GameFramesPerSecond"), (Last.FrameCounter - First.FrameCounter) / Elapsed},
+	    {TEXT("VideoFramesPerSecond"), (Last.FramesDelivered - First.FramesDelivered) / Elapsed},
+	    {TEXT("VideoEnabled"), static_cast<double>(Snapshot.NumVideoEnabled)},
+	    {TEXT("VideoDisabled"), static_cast<double>(Snapshot.NumVideoDisabled)},
+	    {TEXT("DeviceActivations"), static_cast<double>(NumDeviceActivations)},
+	    {TEXT("SwitchesTimedOut"), static_cast<double>(NumSwitchesFailed)},
+	    {TEXT("SwitchLatencyMsP50"), FDolbyIODebugSwitchBenchmark::Percentile(SwitchLatencies, 50.0)},
+	    {TEXT("SwitchLatencyMsP95"), FDolbyIODebugSwitchBenchmark::Percentile(SwitchLatencies, 95.0)},
+	    {TEXT("UplinkKbpsAverage"), NumSendStats > 0 ? UplinkKbpsSum / NumSendStats : -1.0},
+	    {TEXT("RttMsAverage"), NumSendStats > 0 ? RttMsSum / NumSendStats : -1.0},
+	};
+
+	FString Csv = TEXT("Metric,Value") LINE_TERMINATOR;
+	UE_LOG(LogDolbyIODebug, Display, TEXT("Stress test report of participant %d:"), ParticipantIndex);
+	for (const FMetric& Metric : Report)
+	{
+		UE_LOG(LogDolbyIODebug, Display, TEXT("  %-24s %12.2f"), Metric.Name, Metric.Value);
+		Csv += FString::Printf(TEXT("%s,%.3f") LINE_TERMINATOR, Metric.Name, Metric.Value);
+	}
+
+	const FString Path = GetReportPath(ParticipantIndex);
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to write the stress test report to %s"), *Path);
+	}
+
+	if (!bPassed)
+	{
+		UE_LOG(LogDolbyIODebug, Error, TEXT("Stress test failed: the video was never enabled"));
+	}
+	Conclude();
+}
+
+void UDolbyIODebugStressTest::Conclude()
+{
+	if (ParticipantProcesses.Num() == 0)
+	{
+		Exit();
+		return;
+	}
+
+	WaitTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+	    FTickerDelegate::CreateUObject(this, &UDolbyIODebugStressTest::WaitForParticipants), DolbyIODebugStressTest::SampleInterval);
+}
+
+bool UDolbyIODebugStressTest::WaitForParticipants(float DeltaTime)
+{
+	// Every participant gives up joining after ConnectTimeout, and runs for Duration once joined
+	const double Deadline = InitializeTime + ConnectTimeout + Duration + DolbyIODebugStressTest::ParticipantExitGrace;
+	const bool bTimedOut = FPlatformTime::Seconds() > Deadline;
+	for (FParticipantProcess& Process : ParticipantProcesses)
+	{
+		if (!FPlatformProcess::IsProcRunning(Process.Handle))
+		{
+			continue;
+		}
+		if (!bTimedOut)
+		{
+			return true;
+		}
+
+		UE_LOG(LogDolbyIODebug, Error, TEXT("Stress test participant %d still running past its deadline, terminating it"), Process.Index);
+		FPlatformProcess::TerminateProc(Process.Handle, true);
+		Process.bTerminated = true;
+	}
+
+	WaitTickerHandle.Reset();
+	WriteSummary();
+	Exit();
+	return false;
+}
+
+void UDolbyIODebugStressTest::WriteSummary()
+{
+	// One row per participant with the metrics of its report, the first report that could be read setting the columns
+	TArray<FString> MetricNames;
+	TArray<TMap<FString, double>> Reports;
+	Reports.SetNum(NumParticipants);
+	for (int32 Index = 0; Index < NumParticipants; ++Index)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *GetReportPath(Index)))
+		{
+			UE_LOG(LogDolbyIODebug, Warning, TEXT("No stress test report from participant %d"), Index);
+			continue;
+		}
+
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			FString Name;
+			FString Value;
+			if (Lines[LineIndex].Split(TEXT(","), &Name, &Value))
+			{
+				Reports[Index].Add(Name, FCString::Atod(*Value));
+				if (!MetricNames.Contains(Name))
+				{
+					MetricNames.Add(Name);
+				}
+			}
+		}
+	}
+
+	FString Csv = TEXT("Participant,Status");
+	for (const FString& Name : MetricNames)
+	{
+		Csv += TEXT(",") + Name;
+	}
+	Csv += LINE_TERMINATOR;
+
+	TArray<double> Sums;
+	TArray<double> Maxima;
+	Sums.SetNumZeroed(MetricNames.Num());
+	Maxima.Init(-TNumericLimits<double>::Max(), MetricNames.Num());
+	int32 NumReports = 0;
+	int32 NumWithVideo = 0;
+	int32 NumPassed = 0;
+	for (int32 Index = 0; Index < NumParticipants; ++Index)
+	{
+		const TMap<FString, double>& Report = Reports[Index];
+		const FString Status = GetParticipantStatus(Index, Report);
+		NumPassed += Status == TEXT("PASSED") ? 1 : 0;
+		if (Status != TEXT("PASSED"))
+		{
+			UE_LOG(LogDolbyIODebug, Error, TEXT("Stress test participant %d: %s"), Index, *Status);
+		}
+		Csv += FString::Printf(TEXT("%d,%s"), Index, *Status);
+		for (int32 MetricIndex = 0; MetricIndex < MetricNames.Num(); ++MetricIndex)
+		{
+			const double* Value = Report.Find(MetricNames[MetricIndex]);
+			Csv += Value ? FString::Printf(TEXT(",%.3f"), *Value) : FString(TEXT(","));
+			if (Value)
+			{
+				Sums[MetricIndex] += *Value;
+				Maxima[MetricIndex] = FMath::Max(Maxima[MetricIndex], *Value);
+			}
+		}
+		Csv += LINE_TERMINATOR;
+
+		NumReports += Report.Num() > 0 ? 1 : 0;
+		const double* VideoEnabled = Report.Find(TEXT("VideoEnabled"));
+		NumWithVideo += VideoEnabled && *VideoEnabled > 0.0 ? 1 : 0;
+	}
+
+	FString MeanRow = TEXT("Mean,");
+	FString MaxRow = TEXT("Max,");
+	for (int32 MetricIndex = 0; MetricIndex < MetricNames.Num(); ++MetricIndex)
+	{
+		MeanRow += FString::Printf(TEXT(",%.3f"), Sums[MetricIndex] / FMath::Max(NumReports, 1));
+		MaxRow += FString::Printf(TEXT(",%.3f"), Maxima[MetricIndex]);
+	}
+	Csv += MeanRow + LINE_TERMINATOR + MaxRow + LINE_TERMINATOR;
+
+	const FString Path = GetReportPath(INDEX_NONE);
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to write the stress test summary to %s"), *Path);
+	}
+
+	// The capacity is how many participants got their video up; the others reached the limit of the machine or the conference
+	UE_LOG(LogDolbyIODebug, Display, TEXT("Stress test %s: %d of %d participants passed, %d got their video up, summary in %s"), *RunID,
+	       NumPassed, NumParticipants, NumWithVideo, *Path);
+	bPassed &= NumPassed == NumParticipants;
+}
+
+FString UDolbyIODebugStressTest::GetParticipantStatus(int32 Index, const TMap<FString, double>& Report)
+{
+	if (Index == ParticipantIndex)
+	{
+		return bPassed ? TEXT("PASSED") : TEXT("FAILED");
+	}
+
+	FParticipantProcess* Process =
+	    ParticipantProcesses.FindByPredicate([Index](const FParticipantProcess& Candidate) { return Candidate.Index == Index; });
+	int32 ReturnCode = 0;
+	if (!Process)
+	{
+		return TEXT("FAILED (not launched)");
+	}
+	if (Process->bTerminated)
+	{
+		return TEXT("FAILED (terminated)");
+	}
+	if (Report.Num() == 0)
+	{
+		return TEXT("FAILED (no report)");
+	}
+	if (Report.FindRef(TEXT("Connected")) == 0.0)
+	{
+		return TEXT("FAILED (not connected)");
+	}
+	if (FPlatformProcess::GetProcReturnCode(Process->Handle, &ReturnCode) && ReturnCode != 0)
+	{
+		return FString::Printf(TEXT("FAILED (exit code %d)"), ReturnCode);
+	}
+	return Report.FindRef(TEXT("Passed")) > 0.0 ? TEXT("PASSED") : TEXT("FAILED");
+}
+
+void UDolbyIODebugStressTest::Exit()
+{
+	FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+}
+
+FString UDolbyIODebugStressTest::GetReportPath(int32 Index) const
+{
+	const FString Suffix = Index == INDEX_NONE ? FString(TEXT("Summary")) : FString::FromInt(Index);
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"),
+	                       FString::Printf(TEXT("DolbyIOStress-%s-%s-%s.csv"), *ConferenceName, *RunID, *Suffix));
+}
@@ -0,0 +1,111 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "DolbyIODebugVideoSwitcher.h"
+#include "DolbyIOSubsystem.h"
+#include "HAL/PlatformProcess.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugStressTest.generated.h"
+
+/**
+ * Command-line driven scale test, meant for the headless target on CI agents.
+ *
+ * Enabled with -DolbyIOStress=<conference>. Once the token is set, the test joins the conference, switches the local
+ * video to a random device, or off, every -DolbyIOStressDwell=<s> seconds (2 by default, give or take half) through
+ * UDolbyIODebugVideoSwitcher, walks the local player around at random, and samples CPU time, memory, frame delivery
+ * and, when UDolbyIODebugSendLayerController has them, the uplink statistics every second. After
+ * -DolbyIOStressDuration=<s> seconds (60 by default) the report, with the percentiles of the switch latency, is logged
+ * and written to Saved/Benchmarks and the process exits, with a non-zero code if the video was never enabled. A
+ * process that has not joined the conference -DolbyIOStressConnectTimeout=<s> seconds (120 by default) after it
+ * started, for lack of a token or because the join failed, logs why and exits with a non-zero code too. The
+ * randomness is seeded from -DolbyIOStressSeed=<n> and the participant index, so runs can be repeated.
+ *
+ * The SDK runs one participant per process, so -DolbyIOStressParticipants=<n> makes the first process orchestrate
+ * the run: it launches n - 1 copies of itself that join the same conference, each with its own -DolbyIOStressIndex
+ * and report, waits for them once its own report is written, and aggregates every report into a summary, whose
+ * number of participants that got their video up is the capacity of the room for the run. The participants are waited
+ * for until their own deadline, joining and running included, has passed by a grace period; those still running then
+ * are terminated, and they, those that did not join and those that exited with an error are marked as failed in the
+ * summary and fail the run.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugStressTest : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	bool ShouldCreateSubsystem(UObject* Outer) const override;
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+private:
+	struct FSample
+	{
+		double Time = 0.0;
+		float CpuPercent = 0.0f;
+		uint64 UsedPhysical = 0;
+		uint64 FrameCounter = 0;
+		int64 FramesDelivered = 0;
+		/** Negative when no uplink statistics were reported. */
+		float UplinkKbps = -1.0f;
+		float RttMs = -1.0f;
+	};
+
+	UFUNCTION()
+	void HandleConnected(const FString& LocalParticipantID, const FString& ConferenceID);
+	UFUNCTION()
+	void HandleSwitchCompleted(const FDolbyIODebugSwitchResult& Result);
+
+	bool TakeSample(float DeltaTime);
+	bool Move(float DeltaTime);
+	void ScheduleToggle();
+	bool Toggle(float DeltaTime);
+	void LaunchParticipants();
+	void Finish();
+	/** Waits for the other participants if this process launched them, exits otherwise. */
+	void Conclude();
+	bool WaitForParticipants(float DeltaTime);
+	void WriteSummary();
+	/** PASSED, or FAILED with the reason when it is known. */
+	FString GetParticipantStatus(int32 Index, const TMap<FString, double>& Report);
+	void Exit();
+	/** Report of the participant, or the summary of the run for INDEX_NONE. */
+	FString GetReportPath(int32 Index) const;
+
+	FString ConferenceName;
+	int32 NumParticipants = 1;
+	int32 ParticipantIndex = 0;
+	float Duration = 60.0f;
+	float DwellTime = 2.0f;
+	float ConnectTimeout = 120.0f;
+
+	FString RunID;
+	FRandomStream Random;
+
+	struct FParticipantProcess
+	{
+		int32 Index = 0;
+		FProcHandle Handle;
+		bool bTerminated = false;
+	};
+
+	TArray<FParticipantProcess> ParticipantProcesses;
+	TArray<FSample> Samples;
+	TArray<double> SwitchLatencies;
+	FTSTicker::FDelegateHandle SampleTickerHandle;
+	FTSTicker::FDelegateHandle MoveTickerHandle;
+	FTSTicker::FDelegateHandle ToggleTickerHandle;
+	FTSTicker::FDelegateHandle WaitTickerHandle;
+	double InitializeTime = 0.0;
+	double ConnectedTime = -1.0;
+	FVector Location = FVector::ZeroVector;
+	FVector Velocity = FVector::ZeroVector;
+	int32 NumDeviceActivations = 0;
+	int32 NumSwitchesFailed = 0;
+	bool bConnectRequested = false;
+	bool bFinished = false;
+	bool bPassed = false;
+};
@@ -0,0 +1,186 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugSwitchBenchmark.h"
+#include "DolbyIODebug.h"
+
+#include "DolbyIOSubsystem.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace DolbyIODebugSwitchBenchmark
+{
+	struct FMetric
+	{
+		const TCHAR* Name;
+		EDolbyIODebugSwitchPhase From;
+		EDolbyIODebugSwitchPhase To;
+	};
+
+	const FMetric Metrics[] = {
+	    {TEXT("DisableLatency"), EDolbyIODebugSwitchPhase::DisableRequested, EDolbyIODebugSwitchPhase::VideoDisabled},
+	    {TEXT("EnableLatency"), EDolbyIODebugSwitchPhase::EnableRequested, EDolbyIODebugSwitchPhase::VideoEnabled},
+	    {TEXT("FirstFrameLatency"), EDolbyIODebugSwitchPhase::EnableRequested, EDolbyIODebugSwitchPhase::FirstFrame},
+	    {TEXT("SwitchLatency"), EDolbyIODebugSwitchPhase::DisableRequested, EDolbyIODebugSwitchPhase::FirstFrame},
+	};
+
+	FString FormatInterval(double IntervalMs)
+	{
+		return IntervalMs >= 0.0 ? FString::Printf(TEXT("%.3f"), IntervalMs) : FString();
+	}
+
+	FString EscapeCsv(const FString& Value)
+	{
+		return FString::Printf(TEXT("\"%s\""), *Value.Replace(TEXT("\""), TEXT("\"\"")));
+	}
+}
+
+FDolbyIODebugSwitchSample::FDolbyIODebugSwitchSample()
+{
+	for (double& Timestamp : Timestamps)
+	{
+		Timestamp = -1.0;
+	}
+}
+
+double FDolbyIODebugSwitchSample::GetIntervalMs(EDolbyIODebugSwitchPhase From, EDolbyIODebugSwitchPhase To) const
+{
+	if (!HasPhase(From) || !HasPhase(To))
+	{
+		return -1.0;
+	}
+	return (GetPhase(To) - GetPhase(From)) * 1000.0;
+}
+
+void FDolbyIODebugSwitchBenchmark::Reset(int32 InTargetSampleCount)
+{
+	Samples.Reset(InTargetSampleCount);
+	OpenSample = FDolbyIODebugSwitchSample{};
+	TargetSampleCount = InTargetSampleCount;
+	bHasOpenSample = false;
+}
+
+void FDolbyIODebugSwitchBenchmark::BeginSample()
+{
+	OpenSample = FDolbyIODebugSwitchSample{};
+	bHasOpenSample = true;
+}
+
+void FDolbyIODebugSwitchBenchmark::SetSampleDevice(const FDolbyIOVideoDevice& VideoDevice)
+{
+	OpenSample.DeviceName = VideoDevice.DisplayName;
+	OpenSample.DeviceUniqueID = VideoDevice.UniqueID;
+}
+
+void FDolbyIODebugSwitchBenchmark::MarkPhase(EDolbyIODebugSwitchPhase Phase)
+{
+	if (!bHasOpenSample || IsComplete())
+	{
+		return;
+	}
+
+	OpenSample.Timestamps[static_cast<int32>(Phase)] = FPlatformTime::Seconds();
+	if (Phase == EDolbyIODebugSwitchPhase::FirstFrame)
+	{
+		Samples.Add(MoveTemp(OpenSample));
+		bHasOpenSample = false;
+	}
+}
+
+FDolbyIODebugLatencySummary FDolbyIODebugSwitchBenchmark::Summarize(EDolbyIODebugSwitchPhase From, EDolbyIODebugSwitchPhase To,
+                                                                    const FString* DeviceUniqueID) const
+{
+	TArray<double> Values;
+	Values.Reserve(Samples.Num());
+	for (const FDolbyIODebugSwitchSample& Sample : Samples)
+	{
+		if (DeviceUniqueID && Sample.DeviceUniqueID != *DeviceUniqueID)
+		{
+			continue;
+		}
+
+		const double IntervalMs = Sample.GetIntervalMs(From, To);
+		if (IntervalMs >= 0.0)
+		{
+			Values.Add(IntervalMs);
+		}
+	}
+
+	FDolbyIODebugLatencySummary Summary;
+	Summary.Count = Values.Num();
+	if (Values.Num() > 0)
+	{
+		Values.Sort();
+		Summary.P50 = Percentile(Values, 50.0);
+		Summary.P95 = Percentile(Values, 95.0);
+		Summary.P99 = Percentile(Values, 99.0);
+	}
+	return Summary;
+}
+
+FString FDolbyIODebugSwitchBenchmark::WriteCsv(const FString& BaseName) const
+{
+	using namespace DolbyIODebugSwitchBenchmark;
+
+	const FString Directory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"));
+
+	FString SamplesCsv = TEXT("Sample,DeviceName,DeviceUniqueID");
+	for (const FMetric& Metric : Metrics)
+	{
+		SamplesCsv += FString::Printf(TEXT(",%sMs"), Metric.Name);
+	}
+	SamplesCsv += LINE_TERMINATOR;
+
+	TArray<FString> DeviceUniqueIDs;
+	for (int32 Index = 0; Index < Samples.Num(); ++Index)
+	{
+		const FDolbyIODebugSwitchSample& Sample = Samples[Index];
+		DeviceUniqueIDs.AddUnique(Sample.DeviceUniqueID);
+
+		SamplesCsv += FString::Printf(TEXT("%d,%s,%s"), Index, *EscapeCsv(Sample.DeviceName), *EscapeCsv(Sample.DeviceUniqueID));
+		for (const FMetric& Metric : Metrics)
+		{
+			SamplesCsv += TEXT(",") + FormatInterval(Sample.GetIntervalMs(Metric.From, Metric.To));
+		}
+		SamplesCsv += LINE_TERMINATOR;
+	}
+
+	FString SummaryCsv = TEXT("Metric,DeviceUniqueID,Count,P50Ms,P95Ms,P99Ms") LINE_TERMINATOR;
+	auto AppendSummary = [this, &SummaryCsv](const FMetric& Metric, const FString* DeviceUniqueID)
+	{
+		const FDolbyIODebugLatencySummary Summary = Summarize(Metric.From, Metric.To, DeviceUniqueID);
+		SummaryCsv += FString::Printf(TEXT("%s,%s,%d,%.3f,%.3f,%.3f") LINE_TERMINATOR, Metric.Name,
+		                              DeviceUniqueID ? *EscapeCsv(*DeviceUniqueID) : TEXT("All"), Summary.Count, Summary.P50,
+		                              Summary.P95, Summary.P99);
+	};
+	for (const FMetric& Metric : Metrics)
+	{
+		AppendSummary(Metric, nullptr);
+		for (const FString& DeviceUniqueID : DeviceUniqueIDs)
+		{
+			AppendSummary(Metric, &DeviceUniqueID);
+		}
+	}
+
+	const FString SamplesPath = FPaths::Combine(Directory, BaseName + TEXT("-samples.csv"));
+	const FString SummaryPath = FPaths::Combine(Directory, BaseName + TEXT("-summary.csv"));
+	if (!FFileHelper::SaveStringToFile(SamplesCsv, *SamplesPath) || !FFileHelper::SaveStringToFile(SummaryCsv, *SummaryPath))
+	{
+		UE_LOG(LogDolbyIODebug, Error, TEXT("Failed to write device switch benchmark to %s"), *Directory);
+		return FString();
+	}
+
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Device switch benchmark with %d samples written to %s"), Samples.Num(), *SummaryPath);
+	return SummaryPath;
+}
+
+double FDolbyIODebugSwitchBenchmark::Percentile(const TArray<double>& SortedValues, double Percent)
+{
+	if (SortedValues.Num() == 0)
+	{
+		return 0.0;
+	}
+
+	const int32 Rank = FMath::CeilToInt(Percent / 100.0 * SortedValues.Num());
+	return SortedValues[FMath::Clamp(Rank - 1, 0, SortedValues.Num() - 1)];
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FDolbyIOVideoDevice;
+
+/** The points of a device switch that the benchmark timestamps. */
+enum class EDolbyIODebugSwitchPhase : uint8
+{
+	DisableRequested,
+	VideoDisabled,
+	EnableRequested,
+	VideoEnabled,
+	FirstFrame,
+
+	Count
+};
+
+/** Timestamps of one switch to a device, in FPlatformTime::Seconds(). Phases that were not reached are negative. */
+struct FDolbyIODebugSwitchSample
+{
+	FDolbyIODebugSwitchSample();
+
+	bool HasPhase(EDolbyIODebugSwitchPhase Phase) const { return Timestamps[static_cast<int32>(Phase)] >= 0.0; }
+	double GetPhase(EDolbyIODebugSwitchPhase Phase) const { return Timestamps[static_cast<int32>(Phase)]; }
+
+	/** Milliseconds between two phases, or a negative value if either of them is missing. */
+	double GetIntervalMs(EDolbyIODebugSwitchPhase From, EDolbyIODebugSwitchPhase To) const;
+
+	FString DeviceName;
+	FString DeviceUniqueID;
+	double Timestamps[static_cast<int32>(EDolbyIODebugSwitchPhase::Count)];
+};
+
+/** p50/p95/p99 of one metric, in milliseconds. */
+struct FDolbyIODebugLatencySummary
+{
+	int32 Count = 0;
+	double P50 = 0.0;
+	double P95 = 0.0;
+	double P99 = 0.0;
+};
+
+/**
+ * Records per-phase timestamps of Disable Video -> Enable Video switches and reports the latency percentiles.
+ *
+ * The owner marks the phases as it observes them; a sample is completed when its first frame is marked.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugSwitchBenchmark
+{
+public:
+	void Reset(int32 InTargetSampleCount);
+
+	void BeginSample();
+	void SetSampleDevice(const FDolbyIOVideoDevice& VideoDevice);
+	void MarkPhase(EDolbyIODebugSwitchPhase Phase);
+	bool HasOpenSample() const { return bHasOpenSample; }
+
+	bool IsComplete() const { return Samples.Num() >= TargetSampleCount; }
+	int32 GetNumSamples() const { return Samples.Num(); }
+	const TArray<FDolbyIODebugSwitchSample>& GetSamples() const { return Samples; }
+
+	/** Summarizes the interval between two phases, optionally only for the samples of one device. */
+	FDolbyIODebugLatencySummary Summarize(EDolbyIODebugSwitchPhase From, EDolbyIODebugSwitchPhase To,
+	                                      const FString* DeviceUniqueID = nullptr) const;
+
+	/** Writes <BaseName>-samples.csv and <BaseName>-summary.csv to Saved/Benchmarks. Returns the summary path. */
+	FString WriteCsv(const FString& BaseName) const;
+
+	/** Nearest-rank percentile of an already sorted array. */
+	static double Percentile(const TArray<double>& SortedValues, double Percent);
+
+private:
+	TArray<FDolbyIODebugSwitchSample> Samples;
+	FDolbyIODebugSwitchSample OpenSample;
+	int32 TargetSampleCount = 0;
+	bool bHasOpenSample = false;
+};
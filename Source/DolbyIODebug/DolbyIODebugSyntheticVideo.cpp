@@ -0,0 +1,268 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugSyntheticVideo.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugPreviewBudget.h"
+#include "DolbyIODebugPreviewTexture.h"
+#include "DolbyIODebugVideoTelemetry.h"
+
+#include "Containers/Ticker.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+#include <atomic>
+
+namespace DolbyIODebugSyntheticVideo
+{
+	const TCHAR* const UniqueIDPrefix = TEXT("synthetic:");
+
+	/** Same limits as the Meta of FDolbyIODebugSyntheticDeviceSettings. */
+	constexpr int32 MinSize = 16;
+	constexpr float MinFrameRate = 1.0f;
+	constexpr float MaxFrameRate = 240.0f;
+
+	const TCHAR* GetPatternName(EDolbyIODebugSyntheticPattern Pattern)
+	{
+		switch (Pattern)
+		{
+			case EDolbyIODebugSyntheticPattern::Static:
+				return TEXT("Static");
+			case EDolbyIODebugSyntheticPattern::Gradient:
+				return TEXT("Gradient");
+			case EDolbyIODebugSyntheticPattern::Noise:
+				return TEXT("Noise");
+			default:
+				return TEXT("Unknown");
+		}
+	}
+}
+
+/** Generates the frames of one synthetic device on its own thread. */
+class FDolbyIODebugSyntheticGenerator : public FRunnable
+{
+public:
+	FDolbyIODebugSyntheticGenerator(const FDolbyIODebugSyntheticDeviceSettings& InSettings, UDolbyIODebugPreviewTexture* InSink)
+	    : Settings(InSettings), Sink(InSink)
+	{
+		Pixels.SetNumUninitialized(static_cast<int64>(Settings.Width) * Settings.Height * 4);
+		Thread.Reset(FRunnableThread::Create(this, TEXT("DolbyIODebugSyntheticVideo"), 0, TPri_Normal));
+	}
+
+	~FDolbyIODebugSyntheticGenerator() override
+	{
+		if (Thread)
+		{
+			Thread->Kill(true);
+		}
+	}
+
+	uint32 Run() override
+	{
+		double NextFrameTime = FPlatformTime::Seconds();
+		for (uint32 FrameNumber = 0; !bStopping; ++FrameNumber)
+		{
+			if (FrameNumber == 0 || Settings.Pattern != EDolbyIODebugSyntheticPattern::Static)
+			{
+				Generate(FrameNumber);
+			}
+
+			FDolbyIODebugVideoFrame Frame;
+			Frame.Data = Pixels.GetData();
+			Frame.Width = Settings.Width;
+			Frame.Height = Settings.Height;
+			Frame.Stride = Settings.Width * 4;
+			Frame.CaptureTime = FPlatformTime::Seconds();
+			Sink->SubmitFrame(Frame);
+
+			// Frames that are late are skipped rather than caught up with, like a camera would. Under a preview budget
+			// the generator slows down to the allowed rate, rather than generating frames the sink would throttle.
+			const double FrameInterval = FMath::Max(1.0 / Settings.FrameRate, FDolbyIODebugPreviewBudget::Get().GetMinFrameInterval());
+			NextFrameTime = FMath::Max(NextFrameTime + FrameInterval, FPlatformTime::Seconds());
+			const double SleepTime = NextFrameTime - FPlatformTime::Seconds();
+			if (SleepTime > 0.0)
+			{
+				FPlatformProcess::SleepNoStats(static_cast<float>(SleepTime));
+			}
+		}
+		return 0;
+	}
+
+	void Stop() override { bStopping = true; }
+
+private:
+	void Generate(uint32 FrameNumber)
+	{
+		uint8* Pixel = Pixels.GetData();
+		switch (Settings.Pattern)
+		{
+			case EDolbyIODebugSyntheticPattern::Static:
+			{
+				static const FColor Bars[] = {FColor::White, FColor::Yellow, FColor::Cyan,   FColor::Green,
+				                              FColor::Magenta, FColor::Red, FColor::Blue, FColor::Black};
+				for (int32 Y = 0; Y < Settings.Height; ++Y)
+				{
+					for (int32 X = 0; X < Settings.Width; ++X, Pixel += 4)
+					{
+						const FColor& Bar = Bars[X * UE_ARRAY_COUNT(Bars) / Settings.Width];
+						Pixel[0] = Bar.B;
+						Pixel[1] = Bar.G;
+						Pixel[2] = Bar.R;
+						Pixel[3] = 255;
+					}
+				}
+				break;
+			}
+			case EDolbyIODebugSyntheticPattern::Gradient:
+			{
+				for (int32 Y = 0; Y < Settings.Height; ++Y)
+				{
+					for (int32 X = 0; X < Settings.Width; ++X, Pixel += 4)
+					{
+						Pixel[0] = static_cast<uint8>(X + FrameNumber);
+						Pixel[1] = static_cast<uint8>(Y + FrameNumber);
+						Pixel[2] = static_cast<uint8>(FrameNumber);
+						Pixel[3] = 255;
+					}
+				}
+				break;
+			}
+			case EDolbyIODebugSyntheticPattern::Noise:
+			{
+				// xorshift32, seeded per frame so that runs are reproducible
+				uint32 State = 0x9E3779B9u ^ (FrameNumber * 0x85EBCA6Bu);
+				uint32* Word = reinterpret_cast<uint32*>(Pixel);
+				const int64 NumWords = Pixels.Num() / 4;
+				for (int64 Index = 0; Index < NumWords; ++Index)
+				{
+					State ^= State << 13;
+					State ^= State >> 17;
+					State ^= State << 5;
+					Word[Index] = State | 0xFF000000u;
+				}
+				break;
+			}
+		}
+	}
+
+	const FDolbyIODebugSyntheticDeviceSettings Settings;
+	UDolbyIODebugPreviewTexture* const Sink;
+	TArray64<uint8> Pixels;
+	TUniquePtr<FRunnableThread> Thread;
+	std::atomic<bool> bStopping{false};
+};
+
+void UDolbyIODebugSyntheticVideo::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FString CommandLinePatterns;
+	if (FParse::Value(FCommandLine::Get(), TEXT("DolbyIOSyntheticVideo="), CommandLinePatterns, false))
+	{
+		TArray<FString> PatternNames;
+		CommandLinePatterns.ParseIntoArray(PatternNames, TEXT(","));
+		for (const FString& PatternName : PatternNames)
+		{
+			const int64 Pattern = StaticEnum<EDolbyIODebugSyntheticPattern>()->GetValueByNameString(PatternName);
+			if (Pattern == INDEX_NONE)
+			{
+				UE_LOG(LogDolbyIODebug, Warning, TEXT("Unknown synthetic video pattern %s"), *PatternName);
+				continue;
+			}
+			Devices.AddDefaulted_GetRef().Pattern = static_cast<EDolbyIODebugSyntheticPattern>(Pattern);
+		}
+	}
+
+	for (int32 Index = 0; Index < Devices.Num(); ++Index)
+	{
+		// The config and the command line bypass the ClampMin/ClampMax of the properties, and a frame rate of 0 would
+		// make the generator sleep forever
+		FDolbyIODebugSyntheticDeviceSettings& Settings = Devices[Index];
+		Settings.Width = FMath::Max(Settings.Width, DolbyIODebugSyntheticVideo::MinSize);
+		Settings.Height = FMath::Max(Settings.Height, DolbyIODebugSyntheticVideo::MinSize);
+		Settings.FrameRate =
+		    FMath::Clamp(Settings.FrameRate, DolbyIODebugSyntheticVideo::MinFrameRate, DolbyIODebugSyntheticVideo::MaxFrameRate);
+		FDolbyIOVideoDevice& VideoDevice = VideoDevices.AddDefaulted_GetRef();
+		VideoDevice.DisplayName = FString::Printf(TEXT("Synthetic %s %dx%d@%g"), DolbyIODebugSyntheticVideo::GetPatternName(Settings.Pattern),
+		                                          Settings.Width, Settings.Height, Settings.FrameRate);
+		VideoDevice.UniqueID = FString::Printf(TEXT("%s%d"), DolbyIODebugSyntheticVideo::UniqueIDPrefix, Index);
+		TelemetrySources.Add(FDolbyIODebugVideoTelemetry::Get().RegisterSource(VideoDevice.DisplayName));
+	}
+
+	PreviewTexture = NewObject<UDolbyIODebugPreviewTexture>(this);
+	PreviewTexture->UpdateResource();
+}
+
+void UDolbyIODebugSyntheticVideo::Deinitialize()
+{
+	StopGenerator();
+	for (int32 TelemetrySource : TelemetrySources)
+	{
+		FDolbyIODebugVideoTelemetry::Get().UnregisterSource(TelemetrySource);
+	}
+	TelemetrySources.Reset();
+	Super::Deinitialize();
+}
+
+bool UDolbyIODebugSyntheticVideo::IsSynthetic(const FDolbyIOVideoDevice& VideoDevice)
+{
+	return VideoDevice.UniqueID.StartsWith(DolbyIODebugSyntheticVideo::UniqueIDPrefix);
+}
+
+void UDolbyIODebugSyntheticVideo::EnableVideo(const FDolbyIOVideoDevice& VideoDevice)
+{
+	const int32 Index = VideoDevices.IndexOfByPredicate([&VideoDevice](const FDolbyIOVideoDevice& Candidate)
+	                                                    { return Candidate.UniqueID == VideoDevice.UniqueID; });
+	if (Index == INDEX_NONE)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Unknown synthetic video device %s"), *VideoDevice.UniqueID);
+		return;
+	}
+
+	StopGenerator();
+	FramesPresentedAtEnable = PreviewTexture->GetStats().FramesPresented;
+	PreviewTexture->SetTelemetrySource(TelemetrySources[Index]);
+	Generator = MakeShared<FDolbyIODebugSyntheticGenerator>(Devices[Index], PreviewTexture);
+	EnabledVideoTrackID = VideoDevice.UniqueID;
+	BroadcastNextTick(OnVideoEnabledNative, EnabledVideoTrackID);
+}
+
+void UDolbyIODebugSyntheticVideo::DisableVideo()
+{
+	if (!Generator)
+	{
+		return;
+	}
+
+	StopGenerator();
+	BroadcastNextTick(OnVideoDisabledNative, EnabledVideoTrackID);
+	EnabledVideoTrackID.Reset();
+}
+
+UTexture* UDolbyIODebugSyntheticVideo::GetTexture(const FString& VideoTrackID) const
+{
+	if (!Generator || VideoTrackID != EnabledVideoTrackID || PreviewTexture->GetStats().FramesPresented <= FramesPresentedAtEnable)
+	{
+		return nullptr;
+	}
+	return PreviewTexture;
+}
+
+void UDolbyIODebugSyntheticVideo::StopGenerator()
+{
+	// Joins the generator thread, so no frame is submitted after this
+	Generator.Reset();
+}
+
+void UDolbyIODebugSyntheticVideo::BroadcastNextTick(const FDolbyIODebugOnSyntheticVideoChanged& Delegate, const FString& VideoTrackID)
+{
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this,
+	                                                                       [&Delegate, VideoTrackID](float)
+	                                                                       {
+		                                                                       Delegate.Broadcast(VideoTrackID);
+		                                                                       return false;
+	                                                                       }));
+}
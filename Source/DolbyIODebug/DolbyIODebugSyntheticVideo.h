@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugSyntheticVideo.generated.h"
+
+class UDolbyIODebugPreviewTexture;
+
+UENUM(BlueprintType)
+enum class EDolbyIODebugSyntheticPattern : uint8
+{
+	/** Colour bars, the same frame every time. */
+	Static,
+	/** A gradient scrolling by one pixel per frame. */
+	Gradient,
+	/** New high-entropy noise every frame, the worst case for an encoder. */
+	Noise,
+};
+
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugSyntheticDeviceSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug")
+	EDolbyIODebugSyntheticPattern Pattern = EDolbyIODebugSyntheticPattern::Gradient;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "16"))
+	int32 Width = 1280;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "16"))
+	int32 Height = 720;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "1", ClampMax = "240"))
+	float FrameRate = 30.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnSyntheticVideoChanged, const FString& /* VideoTrackID */);
+
+/**
+ * Capture devices that generate their frames, for benchmarks that must not depend on the webcams of the machine.
+ *
+ * The devices are listed in the Devices config array, or given with -DolbyIOSyntheticVideo=<pattern>[,<pattern>...]
+ * on the command line, and are merged by UDolbyIODebugDeviceRegistry into the devices reported by the SDK with a
+ * "synthetic:" unique ID. Enabling one starts a generator thread that submits frames to PreviewTexture at the
+ * configured rate, and the enable/disable events mirror those of the SDK, so UDolbyIODebugDeviceCyclerComponent
+ * switches to and from them like any other device. The SDK cannot capture from them: their frames only feed the
+ * module's own frame sinks.
+ */
+UCLASS(Config = Game)
+class DOLBYIODEBUG_API UDolbyIODebugSyntheticVideo : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug")
+	TArray<FDolbyIODebugSyntheticDeviceSettings> Devices;
+
+	/** Shows the frames of the enabled synthetic device. */
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Dolby.io Debug")
+	TObjectPtr<UDolbyIODebugPreviewTexture> PreviewTexture;
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	static bool IsSynthetic(const FDolbyIOVideoDevice& VideoDevice);
+
+	/** The synthetic devices, in the order of the Devices array. */
+	const TArray<FDolbyIOVideoDevice>& GetVideoDevices() const { return VideoDevices; }
+
+	/** Starts generating the frames of a synthetic device, replacing the one that is enabled if any. */
+	void EnableVideo(const FDolbyIOVideoDevice& VideoDevice);
+	void DisableVideo();
+
+	/** Returns PreviewTexture once the enabled device presented its first frame, nullptr otherwise. */
+	UTexture* GetTexture(const FString& VideoTrackID) const;
+
+	/** Broadcast on the next frame after enabling or disabling, like the SDK events of real devices. */
+	FDolbyIODebugOnSyntheticVideoChanged OnVideoEnabledNative;
+	FDolbyIODebugOnSyntheticVideoChanged OnVideoDisabledNative;
+
+private:
+	void StopGenerator();
+	void BroadcastNextTick(const FDolbyIODebugOnSyntheticVideoChanged& Delegate, const FString& VideoTrackID);
+
+	TArray<FDolbyIOVideoDevice> VideoDevices;
+	/** FDolbyIODebugVideoTelemetry source of each device. */
+	TArray<int32> TelemetrySources;
+	TSharedPtr<class FDolbyIODebugSyntheticGenerator> Generator;
+	FString EnabledVideoTrackID;
+	int64 FramesPresentedAtEnable = 0;
+};
@@ -0,0 +1,133 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugTokenProvider.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugStartupProfiler.h"
+
+#include "DolbyIOSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "Engine/GameInstance.h"
+#include "HAL/PlatformTime.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+void UDolbyIODebugTokenProvider::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+
+	FParse::Value(FCommandLine::Get(), TEXT("DolbyIOTokenUrl="), TokenServiceUrl);
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnTokenNeeded.AddDynamic(this, &UDolbyIODebugTokenProvider::HandleTokenNeeded);
+	}
+
+	Prefetch();
+}
+
+void UDolbyIODebugTokenProvider::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(FetchTickerHandle);
+	if (PendingRequest)
+	{
+		PendingRequest->OnProcessRequestComplete().Unbind();
+		PendingRequest->CancelRequest();
+		PendingRequest.Reset();
+	}
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnTokenNeeded.RemoveDynamic(this, &UDolbyIODebugTokenProvider::HandleTokenNeeded);
+	}
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugTokenProvider::Prefetch()
+{
+	if (TokenServiceUrl.IsEmpty() || PendingRequest)
+	{
+		return;
+	}
+
+	PendingRequest = FHttpModule::Get().CreateRequest();
+	PendingRequest->SetURL(TokenServiceUrl);
+	PendingRequest->SetVerb(TEXT("GET"));
+	PendingRequest->OnProcessRequestComplete().BindUObject(this, &UDolbyIODebugTokenProvider::HandleRequestComplete);
+	PendingRequest->ProcessRequest();
+}
+
+bool UDolbyIODebugTokenProvider::HasValidToken() const
+{
+	return !CachedToken.IsEmpty() && FPlatformTime::Seconds() < CachedTokenExpiryTime;
+}
+
+void UDolbyIODebugTokenProvider::HandleTokenNeeded()
+{
+	FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::TokenRequested);
+
+	UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+	if (DolbyIOSubsystem && HasValidToken())
+	{
+		DolbyIOSubsystem->SetToken(CachedToken);
+		FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::TokenSet);
+		return;
+	}
+
+	bTokenRequested = true;
+	Prefetch();
+}
+
+void UDolbyIODebugTokenProvider::HandleRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully)
+{
+	PendingRequest.Reset();
+
+	FString AccessToken;
+	double ExpiresIn = 0.0;
+	TSharedPtr<FJsonObject> JsonObject;
+	if (!bConnectedSuccessfully || !Response || !EHttpResponseCodes::IsOk(Response->GetResponseCode()) ||
+	    !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Response->GetContentAsString()), JsonObject) ||
+	    !JsonObject.IsValid() || !JsonObject->TryGetStringField(TEXT("access_token"), AccessToken) ||
+	    !JsonObject->TryGetNumberField(TEXT("expires_in"), ExpiresIn))
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Failed to fetch a token from %s (response code %d), retrying in %.1f s"),
+		       *TokenServiceUrl, Response ? Response->GetResponseCode() : 0, RetryDelay);
+		ScheduleFetch(RetryDelay);
+		return;
+	}
+
+	CachedToken = MoveTemp(AccessToken);
+	CachedTokenExpiryTime = FPlatformTime::Seconds() + ExpiresIn;
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Fetched a token valid for %.0f s"), ExpiresIn);
+
+	if (bTokenRequested)
+	{
+		bTokenRequested = false;
+		if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+		{
+			DolbyIOSubsystem->SetToken(CachedToken);
+			FDolbyIODebugStartupProfiler::Get().MarkPhase(EDolbyIODebugStartupPhase::TokenSet);
+		}
+	}
+
+	ScheduleFetch(FMath::Max(static_cast<float>(ExpiresIn) - RefreshLeadTime, RetryDelay));
+}
+
+void UDolbyIODebugTokenProvider::ScheduleFetch(float Delay)
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(FetchTickerHandle);
+	FetchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+	    FTickerDelegate::CreateWeakLambda(this,
+	                                      [this](float)
+	                                      {
+		                                      FetchTickerHandle.Reset();
+		                                      Prefetch();
+		                                      return false;
+	                                      }),
+	    Delay);
+}
@@ -0,0 +1,61 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugTokenProvider.generated.h"
+
+class UDolbyIOSubsystem;
+
+/**
+ * Answers OnTokenNeeded from a cached token so the connection never waits on the token service.
+ *
+ * The token is fetched from TokenServiceUrl as soon as the game instance starts and fetched again RefreshLeadTime
+ * seconds before it expires. The service must answer with a JSON object holding access_token and expires_in, which
+ * is what the Dolby.io client access token API returns. If the SDK asks for a token before one could be fetched, the
+ * token is set as soon as the request that is in flight completes.
+ */
+UCLASS(Config = Game)
+class DOLBYIODEBUG_API UDolbyIODebugTokenProvider : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** URL of the token service. Can be overridden with -DolbyIOTokenUrl=<url>. Nothing is fetched if empty. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug")
+	FString TokenServiceUrl;
+
+	/** Seconds before expiry at which a new token is fetched. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (Units = "s"))
+	float RefreshLeadTime = 60.0f;
+
+	/** Seconds to wait before trying again after a failed fetch. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (Units = "s"))
+	float RetryDelay = 5.0f;
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	/** Fetches a new token unless a request is already in flight. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void Prefetch();
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool HasValidToken() const;
+
+private:
+	UFUNCTION()
+	void HandleTokenNeeded();
+
+	void HandleRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bConnectedSuccessfully);
+	void ScheduleFetch(float Delay);
+
+	FString CachedToken;
+	double CachedTokenExpiryTime = 0.0;
+	FHttpRequestPtr PendingRequest;
+	FTSTicker::FDelegateHandle FetchTickerHandle;
+	bool bTokenRequested = false;
+};
@@ -0,0 +1,109 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugVideoEvents.h"
+#include "DolbyIODebug.h"
+
+#include "Engine/GameInstance.h"
+
+namespace DolbyIODebugVideoEvents
+{
+	/** The local video and a screen share, with room for a handover between devices. */
+	constexpr int32 InitialTrackSlots = 4;
+	/** Track IDs are GUIDs, possibly prefixed, so most fit without ever growing a slot. */
+	constexpr int32 TrackIDCapacity = 64;
+	constexpr int32 InitialDeviceIDs = 16;
+}
+
+void UDolbyIODebugVideoEvents::Initialize(FSubsystemCollectionBase& Collection)
+{
+	using namespace DolbyIODebugVideoEvents;
+	LLM_SCOPE_BYTAG(DolbyIODebug_Events);
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+
+	TrackSlots.Reserve(InitialTrackSlots);
+	for (int32 Index = 0; Index < InitialTrackSlots; ++Index)
+	{
+		TrackSlots.Add(MakeUnique<FTrackSlot>())->VideoTrackID.Reserve(TrackIDCapacity);
+	}
+	DeviceIDs.Reserve(InitialDeviceIDs);
+
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnVideoEnabled.AddDynamic(this, &UDolbyIODebugVideoEvents::HandleVideoEnabled);
+		DolbyIOSubsystem->OnVideoDisabled.AddDynamic(this, &UDolbyIODebugVideoEvents::HandleVideoDisabled);
+		DolbyIOSubsystem->OnVideoDevicesReceived.AddDynamic(this, &UDolbyIODebugVideoEvents::HandleVideoDevicesReceived);
+	}
+}
+
+void UDolbyIODebugVideoEvents::Deinitialize()
+{
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->OnVideoEnabled.RemoveDynamic(this, &UDolbyIODebugVideoEvents::HandleVideoEnabled);
+		DolbyIOSubsystem->OnVideoDisabled.RemoveDynamic(this, &UDolbyIODebugVideoEvents::HandleVideoDisabled);
+		DolbyIOSubsystem->OnVideoDevicesReceived.RemoveDynamic(this, &UDolbyIODebugVideoEvents::HandleVideoDevicesReceived);
+	}
+
+	Super::Deinitialize();
+}
+
+void UDolbyIODebugVideoEvents::AssignID(FString& Target, const FString& Source)
+{
+	// Resetting keeps the allocation, so only an ID longer than any before allocates
+	Target.Reset();
+	Target.Append(Source);
+}
+
+void UDolbyIODebugVideoEvents::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	LLM_SCOPE_BYTAG(DolbyIODebug_Events);
+	OnVideoEnabledNative.Broadcast(AcquireSlot(VideoTrackID).VideoTrackID);
+}
+
+void UDolbyIODebugVideoEvents::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	LLM_SCOPE_BYTAG(DolbyIODebug_Events);
+	FTrackSlot* Slot = FindSlot(VideoTrackID);
+	if (!Slot)
+	{
+		OnVideoDisabledNative.Broadcast(VideoTrackID);
+		return;
+	}
+
+	OnVideoDisabledNative.Broadcast(Slot->VideoTrackID);
+	Slot->bInUse = false;
+}
+
+void UDolbyIODebugVideoEvents::HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices)
+{
+	LLM_SCOPE_BYTAG(DolbyIODebug_Events);
+	DeviceIDs.Reset();
+	for (const FDolbyIOVideoDevice& VideoDevice : VideoDevices)
+	{
+		DeviceIDs.Emplace(*VideoDevice.UniqueID);
+	}
+	OnVideoDevicesReceivedNative.Broadcast(VideoDevices, DeviceIDs);
+}
+
+UDolbyIODebugVideoEvents::FTrackSlot& UDolbyIODebugVideoEvents::AcquireSlot(const FString& VideoTrackID)
+{
+	if (FTrackSlot* Slot = FindSlot(VideoTrackID))
+	{
+		return *Slot;
+	}
+
+	const TUniquePtr<FTrackSlot>* FreeSlot =
+	    TrackSlots.FindByPredicate([](const TUniquePtr<FTrackSlot>& Candidate) { return !Candidate->bInUse; });
+	FTrackSlot* Slot = FreeSlot ? FreeSlot->Get() : TrackSlots.Add_GetRef(MakeUnique<FTrackSlot>()).Get();
+	AssignID(Slot->VideoTrackID, VideoTrackID);
+	Slot->bInUse = true;
+	return *Slot;
+}
+
+UDolbyIODebugVideoEvents::FTrackSlot* UDolbyIODebugVideoEvents::FindSlot(const FString& VideoTrackID)
+{
+	const TUniquePtr<FTrackSlot>* Slot = TrackSlots.FindByPredicate([&VideoTrackID](const TUniquePtr<FTrackSlot>& Candidate)
+	                                                                { return Candidate->bInUse && Candidate->VideoTrackID == VideoTrackID; });
+	return Slot ? Slot->Get() : nullptr;
+}
@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugVideoEvents.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnVideoTrackChangedNative, const FString& /* VideoTrackID */);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FDolbyIODebugOnVideoDevicesReceivedNative, const TArray<FDolbyIOVideoDevice>& /* VideoDevices */,
+                                     TConstArrayView<FName> /* DeviceIDs */);
+
+/**
+ * The video events of the SDK for native code, without the copies the Blueprint events make.
+ *
+ * The SDK's dynamic delegates are bound once here and forwarded by reference. Track IDs are copied into a small pool
+ * of strings that keep their allocation from one track to the next, and stay valid from the enable of the track to
+ * the end of its disable broadcast. Device IDs are FNames, interned the first time a device is seen, in an array
+ * reused across device lists. Once every device has been seen and the pool is warm, the track events of a device
+ * switch go through here and every listener of the module without allocating, which the automation test
+ * DolbyIODebug.Performance.VideoEventAllocations checks; what allocates is tracked under the DolbyIODebug/Events LLM tag.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugVideoEvents : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	FDolbyIODebugOnVideoTrackChangedNative OnVideoEnabledNative;
+	FDolbyIODebugOnVideoTrackChangedNative OnVideoDisabledNative;
+	FDolbyIODebugOnVideoDevicesReceivedNative OnVideoDevicesReceivedNative;
+
+	/**
+	 * Broadcast events that do not come from the SDK, those of a replayed recording for instance, to the same listeners
+	 * and through the same pool as the events of the SDK. Game thread.
+	 */
+	void InjectVideoEnabled(const FString& VideoTrackID) { HandleVideoEnabled(VideoTrackID); }
+	void InjectVideoDisabled(const FString& VideoTrackID) { HandleVideoDisabled(VideoTrackID); }
+	void InjectVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices) { HandleVideoDevicesReceived(VideoDevices); }
+
+	/** Copies an ID into Target, reusing its allocation when it is large enough. */
+	static void AssignID(FString& Target, const FString& Source);
+
+private:
+	struct FTrackSlot
+	{
+		FString VideoTrackID;
+		bool bInUse = false;
+	};
+
+	UFUNCTION()
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	UFUNCTION()
+	void HandleVideoDisabled(const FString& VideoTrackID);
+	UFUNCTION()
+	void HandleVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& VideoDevices);
+
+	/** Returns the slot of the track, taking a free one if it is not in use yet. */
+	FTrackSlot& AcquireSlot(const FString& VideoTrackID);
+	FTrackSlot* FindSlot(const FString& VideoTrackID);
+
+	/** Indirect, so that the IDs being broadcast stay put if a listener enables another track. */
+	TArray<TUniquePtr<FTrackSlot>> TrackSlots;
+	TArray<FName> DeviceIDs;
+};
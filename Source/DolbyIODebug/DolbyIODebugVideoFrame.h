@@ -0,0 +1,176 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RHI.h"
+
+enum class EDolbyIODebugPixelFormat : uint8
+{
+	BGRA8,
+	/** Full resolution Y plane followed by an interleaved half resolution UV plane. */
+	NV12,
+	/** Packed Y0 U Y1 V, two pixels every four bytes. */
+	YUY2,
+	/** Full resolution Y plane, half resolution U and V planes. */
+	I420,
+};
+
+/** Resolution and pixel format of a frame, used to key pooled frame memory. */
+struct FDolbyIODebugFrameFormat
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	EDolbyIODebugPixelFormat PixelFormat = EDolbyIODebugPixelFormat::BGRA8;
+
+	/** Size of a tightly packed frame of this format. */
+	int64 GetSizeBytes() const
+	{
+		const int64 NumPixels = static_cast<int64>(Width) * Height;
+		switch (PixelFormat)
+		{
+			case EDolbyIODebugPixelFormat::YUY2:
+				return NumPixels * 2;
+			case EDolbyIODebugPixelFormat::NV12:
+			case EDolbyIODebugPixelFormat::I420:
+				return NumPixels * 3 / 2;
+			default:
+				return NumPixels * 4;
+		}
+	}
+
+	/** Bytes per row of the first plane of a tightly packed frame. */
+	int64 GetRowBytes() const
+	{
+		switch (PixelFormat)
+		{
+			case EDolbyIODebugPixelFormat::YUY2:
+				return static_cast<int64>(Width) * 2;
+			case EDolbyIODebugPixelFormat::NV12:
+			case EDolbyIODebugPixelFormat::I420:
+				return Width;
+			default:
+				return static_cast<int64>(Width) * 4;
+		}
+	}
+
+	/** Bytes per row of each chroma plane of a tightly packed frame, which are half as high as the first plane. */
+	int64 GetChromaRowBytes() const { return PixelFormat == EDolbyIODebugPixelFormat::NV12 ? Width : Width / 2; }
+
+	int32 GetNumChromaPlanes() const
+	{
+		return PixelFormat == EDolbyIODebugPixelFormat::NV12 ? 1 : PixelFormat == EDolbyIODebugPixelFormat::I420 ? 2 : 0;
+	}
+
+	friend bool operator==(const FDolbyIODebugFrameFormat& Lhs, const FDolbyIODebugFrameFormat& Rhs)
+	{
+		return Lhs.Width == Rhs.Width && Lhs.Height == Rhs.Height && Lhs.PixelFormat == Rhs.PixelFormat;
+	}
+
+	friend uint32 GetTypeHash(const FDolbyIODebugFrameFormat& Format)
+	{
+		return HashCombine(HashCombine(::GetTypeHash(Format.Width), ::GetTypeHash(Format.Height)),
+		                   ::GetTypeHash(static_cast<uint8>(Format.PixelFormat)));
+	}
+};
+
+/**
+ * A video frame handed to the module's frame sinks.
+ *
+ * The frame does not own its pixels: Data only has to stay valid for the duration of the call it is passed to.
+ * Producers that already hold the frame on the GPU can set NativeTexture instead, which is then shared as is.
+ * Data is the first plane, the packed pixels or the Y plane; the chroma planes of NV12 (UV) and I420 (U, V) are in
+ * ChromaData and share ChromaStride. Frames that are not BGRA8 are converted by their sink.
+ */
+struct FDolbyIODebugVideoFrame
+{
+	const uint8* Data = nullptr;
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 Stride = 0;
+	EDolbyIODebugPixelFormat Format = EDolbyIODebugPixelFormat::BGRA8;
+
+	const uint8* ChromaData[2] = {nullptr, nullptr};
+	int32 ChromaStride = 0;
+
+	/** FPlatformTime::Seconds() at which the frame was captured. */
+	double CaptureTime = 0.0;
+
+	FTextureRHIRef NativeTexture;
+
+	/** A frame over tightly packed planes of Format, as written by CopyPacked. */
+	static FDolbyIODebugVideoFrame MakePacked(const FDolbyIODebugFrameFormat& PackedFormat, const uint8* PackedData)
+	{
+		FDolbyIODebugVideoFrame Frame;
+		Frame.Data = PackedData;
+		Frame.Width = PackedFormat.Width;
+		Frame.Height = PackedFormat.Height;
+		Frame.Format = PackedFormat.PixelFormat;
+		Frame.Stride = static_cast<int32>(PackedFormat.GetRowBytes());
+		Frame.ChromaStride = static_cast<int32>(PackedFormat.GetChromaRowBytes());
+		Frame.ChromaData[0] = PackedData + PackedFormat.GetRowBytes() * PackedFormat.Height;
+		Frame.ChromaData[1] = Frame.ChromaData[0] + PackedFormat.GetChromaRowBytes() * (PackedFormat.Height / 2);
+		return Frame;
+	}
+
+	/** Copies the planes without their row padding into Destination, which holds GetFormat().GetSizeBytes(). */
+	void CopyPacked(uint8* Destination) const
+	{
+		const FDolbyIODebugFrameFormat PackedFormat = GetFormat();
+		const auto CopyPlane = [&Destination](const uint8* Source, int64 SourceStride, int64 RowBytes, int32 NumRows)
+		{
+			if (SourceStride == RowBytes)
+			{
+				FMemory::Memcpy(Destination, Source, RowBytes * NumRows);
+			}
+			else
+			{
+				for (int32 Row = 0; Row < NumRows; ++Row)
+				{
+					FMemory::Memcpy(Destination + Row * RowBytes, Source + Row * SourceStride, RowBytes);
+				}
+			}
+			Destination += RowBytes * NumRows;
+		};
+
+		CopyPlane(Data, Stride, PackedFormat.GetRowBytes(), Height);
+		for (int32 Plane = 0; Plane < PackedFormat.GetNumChromaPlanes(); ++Plane)
+		{
+			CopyPlane(ChromaData[Plane], ChromaStride, PackedFormat.GetChromaRowBytes(), Height / 2);
+		}
+	}
+
+	FDolbyIODebugFrameFormat GetFormat() const { return {Width, Height, Format}; }
+	int64 GetSizeBytes() const
+	{
+		return static_cast<int64>(Stride) * Height + static_cast<int64>(ChromaStride) * (Height / 2) * GetFormat().GetNumChromaPlanes();
+	}
+
+	bool IsValid() const
+	{
+		if (Width <= 0 || Height <= 0)
+		{
+			return false;
+		}
+		if (NativeTexture.IsValid())
+		{
+			return true;
+		}
+
+		// The YUV formats are subsampled by two horizontally, and NV12 and I420 vertically as well
+		switch (Format)
+		{
+			case EDolbyIODebugPixelFormat::BGRA8:
+				return Data && Stride >= Width * 4;
+			case EDolbyIODebugPixelFormat::YUY2:
+				return Data && Width % 2 == 0 && Stride >= Width * 2;
+			case EDolbyIODebugPixelFormat::NV12:
+				return Data && ChromaData[0] && Width % 2 == 0 && Height % 2 == 0 && Stride >= Width && ChromaStride >= Width;
+			case EDolbyIODebugPixelFormat::I420:
+				return Data && ChromaData[0] && ChromaData[1] && Width % 2 == 0 && Height % 2 == 0 && Stride >= Width &&
+				       ChromaStride >= Width / 2;
+			default:
+				return false;
+		}
+	}
+};
@@ -0,0 +1,272 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugVideoInterest.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugStartupProfiler.h"
+#include "DolbyIODebugVideoEvents.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Components/PrimitiveComponent.h"
+#include "DolbyIOSubsystem.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+void UDolbyIODebugVideoInterestManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugVideoInterestManager::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugVideoInterestManager::HandleVideoDisabled);
+	}
+}
+
+void UDolbyIODebugVideoInterestManager::Deinitialize()
+{
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	Super::Deinitialize();
+}
+
+bool UDolbyIODebugVideoInterestManager::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDolbyIODebugVideoInterestManager::Tick(float DeltaTime)
+{
+	TimeSinceEvaluation += DeltaTime;
+	if (TimeSinceEvaluation >= EvaluationInterval)
+	{
+		TimeSinceEvaluation = 0.0f;
+		Evaluate();
+	}
+}
+
+TStatId UDolbyIODebugVideoInterestManager::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDolbyIODebugVideoInterestManager, STATGROUP_Tickables);
+}
+
+void UDolbyIODebugVideoInterestManager::RegisterDisplay(const FString& VideoTrackID, UPrimitiveComponent* Display,
+                                                        UMaterialInstanceDynamic* Material, FName ParameterName)
+{
+	if (!Display || !Material)
+	{
+		return;
+	}
+
+	UnregisterDisplay(Display);
+	Displays.Add({VideoTrackID, Display, Material, ParameterName});
+	FDolbyIODebugVideoTrackInterest& Track = Tracks.FindOrAdd(VideoTrackID);
+	Track.VideoTrackID = VideoTrackID;
+	BindDisplay(Displays.Last(), Track.Interest != EDolbyIODebugVideoInterest::Paused, DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this));
+}
+
+void UDolbyIODebugVideoInterestManager::UnregisterDisplay(UPrimitiveComponent* Display)
+{
+	Displays.RemoveAllSwap([Display](const FDisplay& Registered) { return Registered.Component == Display; });
+}
+
+EDolbyIODebugVideoInterest UDolbyIODebugVideoInterestManager::GetInterest(const FString& VideoTrackID) const
+{
+	const FDolbyIODebugVideoTrackInterest* Track = Tracks.Find(VideoTrackID);
+	return Track ? Track->Interest : EDolbyIODebugVideoInterest::Paused;
+}
+
+TArray<FDolbyIODebugVideoTrackInterest> UDolbyIODebugVideoInterestManager::GetTracks() const
+{
+	TArray<FDolbyIODebugVideoTrackInterest> Result;
+	Tracks.GenerateValueArray(Result);
+	return Result;
+}
+
+void UDolbyIODebugVideoInterestManager::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	EnabledTracks.Add(VideoTrackID);
+	FDolbyIODebugVideoTrackInterest& Track = Tracks.FindOrAdd(VideoTrackID);
+	Track.VideoTrackID = VideoTrackID;
+}
+
+void UDolbyIODebugVideoInterestManager::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	EnabledTracks.Remove(VideoTrackID);
+	FDolbyIODebugVideoTrackInterest* Track = Tracks.Find(VideoTrackID);
+	if (Track && SetInterest(*Track, EDolbyIODebugVideoInterest::Paused))
+	{
+		BroadcastInterest(VideoTrackID, EDolbyIODebugVideoInterest::Paused);
+	}
+	PruneTracks();
+}
+
+void UDolbyIODebugVideoInterestManager::PruneTracks()
+{
+	// A track is only worth remembering while it is enabled or has a display waiting for it
+	for (TMap<FString, FDolbyIODebugVideoTrackInterest>::TIterator It = Tracks.CreateIterator(); It; ++It)
+	{
+		if (!EnabledTracks.Contains(It.Key()) &&
+		    !Displays.ContainsByPredicate([&It](const FDisplay& Display) { return Display.VideoTrackID == It.Key(); }))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UDolbyIODebugVideoInterestManager::Evaluate()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(DolbyIODebugVideoInterest, DolbyIODebugChannel);
+	Displays.RemoveAllSwap([](const FDisplay& Display) { return !Display.Component.IsValid() || !Display.Material.IsValid(); });
+
+	FVector ViewLocation;
+	FVector ViewDirection;
+	float HalfFov = 0.0f;
+	float AspectRatio = 1.0f;
+	const bool bHasView = GetView(ViewLocation, ViewDirection, HalfFov, AspectRatio);
+	// The field of view of the camera is horizontal, the screen size a fraction of the height
+	const float TanHalfVerticalFov = FMath::Tan(HalfFov) / AspectRatio;
+
+	// A track is as visible as the most visible of its displays
+	for (TPair<FString, FDolbyIODebugVideoTrackInterest>& Track : Tracks)
+	{
+		Track.Value.ScreenSize = 0.0f;
+		Track.Value.Distance = TNumericLimits<float>::Max();
+		Track.Value.bInView = false;
+	}
+	for (const FDisplay& Display : Displays)
+	{
+		FDolbyIODebugVideoTrackInterest* Track = Tracks.Find(Display.VideoTrackID);
+		if (!Track || !bHasView)
+		{
+			continue;
+		}
+
+		const FBoxSphereBounds& Bounds = Display.Component->Bounds;
+		const FVector ToDisplay = Bounds.Origin - ViewLocation;
+		const float Distance = FMath::Max(static_cast<float>(ToDisplay.Size()), static_cast<float>(Bounds.SphereRadius));
+		Track->Distance = FMath::Min(Track->Distance, Distance);
+
+		// The view cone widened by the angular radius of the bounds, then whether anything of it was drawn, to skip occluded displays
+		const float AngularRadius = FMath::Asin(FMath::Clamp(static_cast<float>(Bounds.SphereRadius) / Distance, 0.0f, 1.0f));
+		const float Angle = FMath::Acos(FMath::Clamp(static_cast<float>(FVector::DotProduct(ToDisplay.GetSafeNormal(), ViewDirection)), -1.0f, 1.0f));
+		if (Angle > HalfFov + AngularRadius || !Display.Component->WasRecentlyRendered(EvaluationInterval * 2.0f))
+		{
+			continue;
+		}
+
+		Track->bInView = true;
+		Track->ScreenSize = FMath::Max(Track->ScreenSize, static_cast<float>(Bounds.SphereRadius) / (Distance * TanHalfVerticalFov));
+	}
+
+	// Rank the candidates by screen size, the thresholds moved by the hysteresis away from the current state
+	TArray<FDolbyIODebugVideoTrackInterest*> Candidates;
+	for (TPair<FString, FDolbyIODebugVideoTrackInterest>& Track : Tracks)
+	{
+		const bool bPaused = Track.Value.Interest == EDolbyIODebugVideoInterest::Paused;
+		const float Threshold = MinScreenSize * (bPaused ? 1.0f + Hysteresis : 1.0f - Hysteresis);
+		if (Track.Value.bInView && Track.Value.Distance <= MaxDistance && Track.Value.ScreenSize >= Threshold)
+		{
+			Candidates.Add(&Track.Value);
+		}
+	}
+	// At the cap, a track only displaces one that is kept once it is larger by the hysteresis
+	const auto GetRank = [this](const FDolbyIODebugVideoTrackInterest& Track)
+	{ return Track.Interest == EDolbyIODebugVideoInterest::Paused ? Track.ScreenSize : Track.ScreenSize * (1.0f + Hysteresis); };
+	Candidates.Sort([&GetRank](const FDolbyIODebugVideoTrackInterest& Lhs, const FDolbyIODebugVideoTrackInterest& Rhs)
+	                { return GetRank(Lhs) > GetRank(Rhs); });
+
+	// Broadcast once the evaluation is done, as handlers may register displays
+	TArray<TPair<FString, EDolbyIODebugVideoInterest>> Changes;
+	TSet<const FDolbyIODebugVideoTrackInterest*> Kept;
+	for (int32 Index = 0; Index < FMath::Min(Candidates.Num(), MaxConcurrentTracks); ++Index)
+	{
+		FDolbyIODebugVideoTrackInterest& Track = *Candidates[Index];
+		const bool bActive = Track.Interest == EDolbyIODebugVideoInterest::Active;
+		const float Threshold = DowngradeScreenSize * (bActive ? 1.0f - Hysteresis : 1.0f + Hysteresis);
+		if (SetInterest(Track, Track.ScreenSize >= Threshold ? EDolbyIODebugVideoInterest::Active : EDolbyIODebugVideoInterest::Downgraded))
+		{
+			Changes.Emplace(Track.VideoTrackID, Track.Interest);
+		}
+		Kept.Add(&Track);
+	}
+	for (TPair<FString, FDolbyIODebugVideoTrackInterest>& Track : Tracks)
+	{
+		if (!Kept.Contains(&Track.Value) && SetInterest(Track.Value, EDolbyIODebugVideoInterest::Paused))
+		{
+			Changes.Emplace(Track.Key, EDolbyIODebugVideoInterest::Paused);
+		}
+	}
+
+	// Textures may only exist some time after a track is enabled, so bindings are refreshed on every evaluation
+	UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this);
+	for (const FDisplay& Display : Displays)
+	{
+		BindDisplay(Display, GetInterest(Display.VideoTrackID) != EDolbyIODebugVideoInterest::Paused, DolbyIOSubsystem);
+	}
+
+	for (const TPair<FString, EDolbyIODebugVideoInterest>& Change : Changes)
+	{
+		BroadcastInterest(Change.Key, Change.Value);
+	}
+	PruneTracks();
+}
+
+bool UDolbyIODebugVideoInterestManager::SetInterest(FDolbyIODebugVideoTrackInterest& Track, EDolbyIODebugVideoInterest Interest)
+{
+	if (Track.Interest == Interest)
+	{
+		return false;
+	}
+
+	Track.Interest = Interest;
+	UE_LOG(LogDolbyIODebug, Verbose, TEXT("Video track %s is now %s (screen size %.3f, %.0f cm)"), *Track.VideoTrackID,
+	       *UEnum::GetValueAsString(Interest), Track.ScreenSize, Track.Distance);
+	return true;
+}
+
+void UDolbyIODebugVideoInterestManager::BroadcastInterest(const FString& VideoTrackID, EDolbyIODebugVideoInterest Interest)
+{
+	OnVideoInterestChangedNative.Broadcast(VideoTrackID, Interest);
+	OnVideoInterestChanged.Broadcast(VideoTrackID, Interest);
+}
+
+void UDolbyIODebugVideoInterestManager::BindDisplay(const FDisplay& Display, bool bBound, UDolbyIOSubsystem* DolbyIOSubsystem) const
+{
+	UTexture* Texture = bBound && DolbyIOSubsystem && EnabledTracks.Contains(Display.VideoTrackID)
+	                        ? DolbyIOSubsystem->GetTexture(Display.VideoTrackID)
+	                        : nullptr;
+
+	UTexture* CurrentTexture = nullptr;
+	Display.Material->GetTextureParameterValue(Display.ParameterName, CurrentTexture);
+	if (CurrentTexture != Texture)
+	{
+		Display.Material->SetTextureParameterValue(Display.ParameterName, Texture);
+	}
+}
+
+bool UDolbyIODebugVideoInterestManager::GetView(FVector& OutLocation, FVector& OutDirection, float& OutHalfFovRadians,
+                                                float& OutAspectRatio) const
+{
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (!PlayerController || !PlayerController->PlayerCameraManager)
+	{
+		return false;
+	}
+
+	FRotator ViewRotation;
+	PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+	OutDirection = ViewRotation.Vector();
+	OutHalfFovRadians = FMath::DegreesToRadians(PlayerController->PlayerCameraManager->GetFOVAngle() * 0.5f);
+	int32 ViewportWidth = 0;
+	int32 ViewportHeight = 0;
+	PlayerController->GetViewportSize(ViewportWidth, ViewportHeight);
+	OutAspectRatio = ViewportWidth > 0 && ViewportHeight > 0 ? static_cast<float>(ViewportWidth) / ViewportHeight : 1.0f;
+	return true;
+}
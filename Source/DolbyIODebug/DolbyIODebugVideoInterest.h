@@ -0,0 +1,143 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DolbyIODebugVideoInterest.generated.h"
+
+class UMaterialInstanceDynamic;
+class UPrimitiveComponent;
+
+UENUM(BlueprintType)
+enum class EDolbyIODebugVideoInterest : uint8
+{
+	/** Not worth decoding: out of view, too far, too small or over the cap. The display shows its material's default. */
+	Paused,
+	/** Visible but small on screen, a low resolution is enough. */
+	Downgraded,
+	/** Visible and large on screen. */
+	Active,
+};
+
+/** What the interest manager last decided for a remote video track, with the measurements it was based on. */
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugVideoTrackInterest
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString VideoTrackID;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	EDolbyIODebugVideoInterest Interest = EDolbyIODebugVideoInterest::Paused;
+
+	/** Height of the display's bounds on screen, as a fraction of the screen height. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	float ScreenSize = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "cm"))
+	float Distance = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	bool bInView = false;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FDolbyIODebugOnVideoInterestChangedNative, const FString& /* VideoTrackID */, EDolbyIODebugVideoInterest);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FDolbyIODebugOnVideoInterestChanged, const FString&, VideoTrackID, EDolbyIODebugVideoInterest, Interest);
+
+/**
+ * Decides which remote video tracks are worth showing, from where their displays are relative to the local view.
+ *
+ * Every primitive that shows a remote track is registered with the material parameter its texture goes to. A few
+ * times per second the displays are tested against the view cone of the local player and whether they were rendered
+ * recently, and ranked by their size on screen; the largest MaxConcurrentTracks visible ones within MaxDistance are
+ * kept, Active above DowngradeScreenSize and Downgraded below it, and the others are Paused. The texture of a track
+ * is only bound to its displays while it is not paused, so paused tracks are never sampled. The SDK forwards every
+ * remote track to the client regardless, so the decisions are also broadcast for whatever can act on them upstream,
+ * such as the simulcast layer of a track. A track is forgotten once it is disabled and no registered display is left
+ * for it.
+ */
+UCLASS(Config = Game)
+class DOLBYIODEBUG_API UDolbyIODebugVideoInterestManager : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Tracks kept at most, whatever the screen sizes. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0"))
+	int32 MaxConcurrentTracks = 8;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", Units = "cm"))
+	float MaxDistance = 5000.0f;
+
+	/** Displays smaller than this fraction of the screen height are paused. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MinScreenSize = 0.02f;
+
+	/** Displays smaller than this fraction of the screen height are downgraded. */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float DowngradeScreenSize = 0.15f;
+
+	/**
+	 * A track keeps its state until its screen size is this much past a threshold, or this much larger than a kept track
+	 * it would displace at the cap, so it does not flicker around either.
+	 */
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Hysteresis = 0.2f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Dolby.io Debug", Meta = (ClampMin = "0.02", Units = "s"))
+	float EvaluationInterval = 0.2f;
+
+	/** Shows a remote track on Display through the texture parameter ParameterName of Material. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void RegisterDisplay(const FString& VideoTrackID, UPrimitiveComponent* Display, UMaterialInstanceDynamic* Material, FName ParameterName);
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void UnregisterDisplay(UPrimitiveComponent* Display);
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	EDolbyIODebugVideoInterest GetInterest(const FString& VideoTrackID) const;
+
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	TArray<FDolbyIODebugVideoTrackInterest> GetTracks() const;
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnVideoInterestChanged OnVideoInterestChanged;
+	FDolbyIODebugOnVideoInterestChangedNative OnVideoInterestChangedNative;
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+	void Tick(float DeltaTime) override;
+	TStatId GetStatId() const override;
+
+protected:
+	bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FDisplay
+	{
+		FString VideoTrackID;
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		TWeakObjectPtr<UMaterialInstanceDynamic> Material;
+		FName ParameterName;
+	};
+
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+
+	void Evaluate();
+	/** Forgets the tracks that are neither enabled nor shown by a registered display. */
+	void PruneTracks();
+	/** Returns whether the interest changed. */
+	bool SetInterest(FDolbyIODebugVideoTrackInterest& Track, EDolbyIODebugVideoInterest Interest);
+	void BroadcastInterest(const FString& VideoTrackID, EDolbyIODebugVideoInterest Interest);
+	void BindDisplay(const FDisplay& Display, bool bBound, class UDolbyIOSubsystem* DolbyIOSubsystem) const;
+	/** The field of view is horizontal, and the aspect ratio that of the viewport. */
+	bool GetView(FVector& OutLocation, FVector& OutDirection, float& OutHalfFovRadians, float& OutAspectRatio) const;
+
+	TArray<FDisplay> Displays;
+	TMap<FString, FDolbyIODebugVideoTrackInterest> Tracks;
+	TSet<FString> EnabledTracks;
+	float TimeSinceEvaluation = 0.0f;
+};
@@ -0,0 +1,364 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugVideoSwitcher.h"
+#include "DolbyIODebug.h"
+#include "DolbyIODebugDeviceRegistry.h"
+#include "DolbyIODebugEncoderProbe.h"
+#include "DolbyIODebugSyntheticVideo.h"
+#include "DolbyIODebugVideoEvents.h"
+
+#include "Engine/GameInstance.h"
+#include "HAL/PlatformTime.h"
+
+void UDolbyIODebugVideoSwitcher::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	Collection.InitializeDependency<UDolbyIOSubsystem>();
+	Collection.InitializeDependency<UDolbyIODebugSyntheticVideo>();
+	Collection.InitializeDependency<UDolbyIODebugEncoderProbe>();
+	Collection.InitializeDependency<UDolbyIODebugDeviceRegistry>();
+	Collection.InitializeDependency<UDolbyIODebugVideoEvents>();
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugVideoSwitcher::HandleVideoEnabled);
+		VideoEvents->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugVideoSwitcher::HandleVideoDisabled);
+	}
+
+	if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		SyntheticVideo->OnVideoEnabledNative.AddUObject(this, &UDolbyIODebugVideoSwitcher::HandleVideoEnabled);
+		SyntheticVideo->OnVideoDisabledNative.AddUObject(this, &UDolbyIODebugVideoSwitcher::HandleVideoDisabled);
+	}
+}
+
+void UDolbyIODebugVideoSwitcher::Deinitialize()
+{
+	// Nobody may be left waiting on a future that is never set
+	if (Waiting)
+	{
+		Complete(MoveTemp(Waiting), EDolbyIODebugSwitchOutcome::Cancelled);
+	}
+	if (InFlight && !InFlight->bTimedOut)
+	{
+		Complete(MoveTemp(InFlight), EDolbyIODebugSwitchOutcome::Cancelled);
+	}
+	FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+
+	if (UDolbyIODebugVideoEvents* VideoEvents = DolbyIODebug::GetSubsystem<UDolbyIODebugVideoEvents>(this))
+	{
+		VideoEvents->OnVideoEnabledNative.RemoveAll(this);
+		VideoEvents->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+	{
+		SyntheticVideo->OnVideoEnabledNative.RemoveAll(this);
+		SyntheticVideo->OnVideoDisabledNative.RemoveAll(this);
+	}
+
+	Super::Deinitialize();
+}
+
+FDolbyIODebugSwitchHandle UDolbyIODebugVideoSwitcher::SwitchTo(const FDolbyIOVideoDevice& VideoDevice)
+{
+	return Submit(VideoDevice);
+}
+
+FDolbyIODebugSwitchHandle UDolbyIODebugVideoSwitcher::SwitchOff()
+{
+	return Submit({});
+}
+
+void UDolbyIODebugVideoSwitcher::Cancel(int32 RequestID)
+{
+	if (Waiting && Waiting->RequestID == RequestID)
+	{
+		Complete(MoveTemp(Waiting), EDolbyIODebugSwitchOutcome::Cancelled);
+	}
+	else if (InFlight && InFlight->RequestID == RequestID)
+	{
+		InFlight->bCancelled = true;
+	}
+}
+
+FDolbyIODebugSwitchHandle UDolbyIODebugVideoSwitcher::Submit(TOptional<FDolbyIOVideoDevice> Device)
+{
+	TUniquePtr<FRequest> Request = MakeUnique<FRequest>();
+	Request->RequestID = NextRequestID++;
+	Request->Device = MoveTemp(Device);
+	Request->RequestTime = FPlatformTime::Seconds();
+	FDolbyIODebugSwitchHandle Handle{Request->RequestID, Request->Promise.GetFuture()};
+
+	if (!InFlight)
+	{
+		Start(MoveTemp(Request));
+		return Handle;
+	}
+
+	// Latest wins: only the newest request waits, and the one in flight is no longer wanted
+	if (Waiting)
+	{
+		Complete(MoveTemp(Waiting), EDolbyIODebugSwitchOutcome::Superseded);
+	}
+	InFlight->bCancelled = true;
+	Waiting = MoveTemp(Request);
+	return Handle;
+}
+
+void UDolbyIODebugVideoSwitcher::Start(TUniquePtr<FRequest> Request)
+{
+	check(!InFlight);
+
+	if (!bCurrentUnknown && IsCurrent(Request->Device))
+	{
+		Complete(MoveTemp(Request), EDolbyIODebugSwitchOutcome::Succeeded);
+		return;
+	}
+
+	InFlight = MoveTemp(Request);
+	ArmTimeout(GetTimeout(InFlight->Device));
+
+	if (!InFlight->Device)
+	{
+		DisableCurrent();
+		return;
+	}
+
+	// The SDK hands over between its own devices, but not to or from a synthetic one, nor from a device it is not known to have
+	if (bCurrentUnknown ||
+	    (CurrentDevice && UDolbyIODebugSyntheticVideo::IsSynthetic(*CurrentDevice) != UDolbyIODebugSyntheticVideo::IsSynthetic(*InFlight->Device)))
+	{
+		InFlight->bDisablingFirst = true;
+		DisableCurrent();
+		return;
+	}
+	EnableDevice(*InFlight->Device);
+}
+
+void UDolbyIODebugVideoSwitcher::StartNext()
+{
+	if (Waiting)
+	{
+		Start(MoveTemp(Waiting));
+	}
+}
+
+void UDolbyIODebugVideoSwitcher::EnableDevice(const FDolbyIOVideoDevice& VideoDevice)
+{
+	UE_LOG(LogDolbyIODebug, Log, TEXT("Switching video to %s"), *VideoDevice.DisplayName);
+	if (UDolbyIODebugSyntheticVideo::IsSynthetic(VideoDevice))
+	{
+		if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+		{
+			SyntheticVideo->EnableVideo(VideoDevice);
+		}
+	}
+	else if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		if (UDolbyIODebugEncoderProbe* EncoderProbe = DolbyIODebug::GetSubsystem<UDolbyIODebugEncoderProbe>(this))
+		{
+			EncoderProbe->NotifyEnableRequested(VideoDevice);
+		}
+		DolbyIOSubsystem->EnableVideo(VideoDevice);
+	}
+}
+
+void UDolbyIODebugVideoSwitcher::DisableCurrent()
+{
+	if (CurrentDevice && UDolbyIODebugSyntheticVideo::IsSynthetic(*CurrentDevice))
+	{
+		if (UDolbyIODebugSyntheticVideo* SyntheticVideo = DolbyIODebug::GetSubsystem<UDolbyIODebugSyntheticVideo>(this))
+		{
+			SyntheticVideo->DisableVideo();
+		}
+	}
+	else if (UDolbyIOSubsystem* DolbyIOSubsystem = DolbyIODebug::GetSubsystem<UDolbyIOSubsystem>(this))
+	{
+		DolbyIOSubsystem->DisableVideo();
+	}
+}
+
+void UDolbyIODebugVideoSwitcher::Complete(TUniquePtr<FRequest> Request, EDolbyIODebugSwitchOutcome Outcome)
+{
+	if (!InFlight)
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+		TimeoutHandle.Reset();
+	}
+
+	Resolve(*Request, Outcome);
+}
+
+void UDolbyIODebugVideoSwitcher::Resolve(FRequest& Request, EDolbyIODebugSwitchOutcome Outcome)
+{
+	FDolbyIODebugSwitchResult Result;
+	Result.RequestID = Request.RequestID;
+	Result.Outcome = Outcome;
+	Result.VideoTrackID = Outcome == EDolbyIODebugSwitchOutcome::Succeeded ? CurrentVideoTrackID : FString();
+	Result.Duration = static_cast<float>(FPlatformTime::Seconds() - Request.RequestTime);
+	Request.Promise.SetValue(Result);
+	OnSwitchCompleted.Broadcast(Result);
+}
+
+void UDolbyIODebugVideoSwitcher::FinishTimedOut()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+	TimeoutHandle.Reset();
+	InFlight.Reset();
+
+	// Whoever asked for the device was told it failed, so it does not stay open unless another one is wanted
+	if (!Waiting && CurrentDevice)
+	{
+		SwitchOff();
+		return;
+	}
+	StartNext();
+}
+
+void UDolbyIODebugVideoSwitcher::ArmTimeout(float Timeout)
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TimeoutHandle);
+	TimeoutHandle =
+	    FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UDolbyIODebugVideoSwitcher::HandleTimeout), Timeout);
+}
+
+float UDolbyIODebugVideoSwitcher::GetTimeout(const TOptional<FDolbyIOVideoDevice>& Device) const
+{
+	// A device that enabled before is given a few times as long as it took, rather than the full timeout
+	const UDolbyIODebugEncoderProbe* EncoderProbe = DolbyIODebug::GetSubsystem<UDolbyIODebugEncoderProbe>(this);
+	const float ExpectedEnableTime = Device && EncoderProbe ? EncoderProbe->GetExpectedEnableTime(*Device) : 0.0f;
+	if (ExpectedEnableTime <= 0.0f)
+	{
+		return RequestTimeout;
+	}
+	return FMath::Clamp(ExpectedEnableTime * KnownDeviceTimeoutFactor, KnownDeviceMinTimeout, RequestTimeout);
+}
+
+bool UDolbyIODebugVideoSwitcher::HandleTimeout(float DeltaTime)
+{
+	TimeoutHandle.Reset();
+	if (!InFlight)
+	{
+		return false;
+	}
+
+	if (bCurrentUnknown && InFlight->bDisablingFirst)
+	{
+		// Nothing to disable is the likeliest reason for the SDK not to answer a disable
+		UE_LOG(LogDolbyIODebug, Log, TEXT("No answer to the disable before video switch %d, taking the video as off"), InFlight->RequestID);
+		bCurrentUnknown = false;
+		InFlight->bDisablingFirst = false;
+		ArmTimeout(GetTimeout(InFlight->Device));
+		EnableDevice(*InFlight->Device);
+		return false;
+	}
+
+	if (!InFlight->bTimedOut)
+	{
+		UE_LOG(LogDolbyIODebug, Warning, TEXT("Video switch %d not answered by the SDK within %.1f s, waiting for its answer before the next one"),
+		       InFlight->RequestID, GetTimeout(InFlight->Device));
+		InFlight->bTimedOut = true;
+		Resolve(*InFlight, EDolbyIODebugSwitchOutcome::TimedOut);
+		ArmTimeout(RequestTimeout);
+		return false;
+	}
+
+	UE_LOG(LogDolbyIODebug, Warning, TEXT("Video switch %d never answered by the SDK, disabling the video before the next one"),
+	       InFlight->RequestID);
+	bCurrentUnknown = true;
+	CurrentDevice.Reset();
+	CurrentVideoTrackID.Reset();
+	FinishTimedOut();
+	return false;
+}
+
+bool UDolbyIODebugVideoSwitcher::IsCurrent(const TOptional<FDolbyIOVideoDevice>& Device) const
+{
+	if (!Device)
+	{
+		return !CurrentDevice;
+	}
+	return CurrentDevice && CurrentDevice->UniqueID == Device->UniqueID;
+}
+
+void UDolbyIODebugVideoSwitcher::HandleVideoEnabled(const FString& VideoTrackID)
+{
+	if (!InFlight || !InFlight->Device || InFlight->bDisablingFirst)
+	{
+		HandleUnrequestedVideoEnabled(VideoTrackID);
+		return;
+	}
+
+	CurrentDevice = InFlight->Device;
+	bCurrentUnknown = false;
+	if (InFlight->bTimedOut)
+	{
+		// The late answer of the request that timed out, the device it asked for is the one live
+		UDolbyIODebugVideoEvents::AssignID(CurrentVideoTrackID, VideoTrackID);
+		FinishTimedOut();
+		return;
+	}
+
+	UDolbyIODebugVideoEvents::AssignID(CurrentVideoTrackID, VideoTrackID);
+	const bool bCancelled = InFlight->bCancelled;
+	Complete(MoveTemp(InFlight), bCancelled ? EDolbyIODebugSwitchOutcome::Cancelled : EDolbyIODebugSwitchOutcome::Succeeded);
+
+	// A device that is not wanted any more does not stay open
+	if (bCancelled && !Waiting)
+	{
+		SwitchOff();
+		return;
+	}
+	StartNext();
+}
+
+void UDolbyIODebugVideoSwitcher::HandleUnrequestedVideoEnabled(const FString& VideoTrackID)
+{
+	// The track of a synthetic device is named after the device; that of an SDK device does not tell which it is
+	UDolbyIODebugVideoEvents::AssignID(CurrentVideoTrackID, VideoTrackID);
+	const UDolbyIODebugDeviceRegistry* DeviceRegistry = DolbyIODebug::GetSubsystem<UDolbyIODebugDeviceRegistry>(this);
+	const int32 DeviceIndex = DeviceRegistry ? DeviceRegistry->FindIndex(VideoTrackID) : INDEX_NONE;
+	if (DeviceIndex != INDEX_NONE)
+	{
+		CurrentDevice = DeviceRegistry->GetDevice(DeviceIndex);
+		bCurrentUnknown = false;
+	}
+	else
+	{
+		CurrentDevice.Reset();
+		bCurrentUnknown = true;
+	}
+}
+
+void UDolbyIODebugVideoSwitcher::HandleVideoDisabled(const FString& VideoTrackID)
+{
+	CurrentDevice.Reset();
+	CurrentVideoTrackID.Reset();
+	bCurrentUnknown = false;
+	if (!InFlight)
+	{
+		return;
+	}
+
+	if (InFlight->bTimedOut)
+	{
+		// Whether it was the disable asked for or the one before an enable, the video is now off
+		FinishTimedOut();
+		return;
+	}
+
+	if (InFlight->bDisablingFirst)
+	{
+		InFlight->bDisablingFirst = false;
+		EnableDevice(*InFlight->Device);
+		return;
+	}
+
+	if (!InFlight->Device)
+	{
+		const bool bCancelled = InFlight->bCancelled;
+		Complete(MoveTemp(InFlight), bCancelled ? EDolbyIODebugSwitchOutcome::Cancelled : EDolbyIODebugSwitchOutcome::Succeeded);
+		StartNext();
+	}
+}
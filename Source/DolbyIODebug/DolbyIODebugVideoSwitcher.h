@@ -0,0 +1,156 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Ticker.h"
+#include "DolbyIOSubsystem.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "DolbyIODebugVideoSwitcher.generated.h"
+
+UENUM(BlueprintType)
+enum class EDolbyIODebugSwitchOutcome : uint8
+{
+	/** The requested device is live, or the video is disabled if none was requested. */
+	Succeeded,
+	/** Replaced by a later request before it was started. */
+	Superseded,
+	/** Cancelled, or replaced by a later request while the SDK was already opening it. */
+	Cancelled,
+	/** The SDK did not report the switch within the timeout. */
+	TimedOut,
+};
+
+USTRUCT(BlueprintType)
+struct DOLBYIODEBUG_API FDolbyIODebugSwitchResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	int32 RequestID = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	EDolbyIODebugSwitchOutcome Outcome = EDolbyIODebugSwitchOutcome::Succeeded;
+
+	/** Track of the device that is live, empty if the video is disabled or the switch did not succeed. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug")
+	FString VideoTrackID;
+
+	/** From the request to its outcome. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Debug", Meta = (Units = "s"))
+	float Duration = 0.0f;
+};
+
+/** A pending switch. The future is set on the game thread when the request reaches its outcome. */
+struct FDolbyIODebugSwitchHandle
+{
+	int32 RequestID = 0;
+	TFuture<FDolbyIODebugSwitchResult> Result;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDolbyIODebugOnSwitchCompletedDelegate, const FDolbyIODebugSwitchResult&, Result);
+
+/**
+ * Switches the local video between devices without letting requests pile up.
+ *
+ * At most one request is handed to the SDK at a time and at most one more waits behind it: a new request replaces
+ * the waiting one, which completes as Superseded without ever opening its device, so rapid input costs at most one
+ * extra open whatever its rate. The SDK cannot abort an open, so a request replaced or cancelled while in flight
+ * completes as Cancelled when the SDK reports it, and the waiting request (or a disable, if nothing is waiting)
+ * follows immediately. Switches between devices of the same kind are handed over by the SDK without disabling the
+ * video first; synthetic devices go through UDolbyIODebugSyntheticVideo. Requests the SDK does not answer within
+ * RequestTimeout time out, which bounds how long a switch can take; devices that enabled before time out sooner, after
+ * a few times as long as UDolbyIODebugEncoderProbe saw them take. A request that timed out still waits for the SDK
+ * before the next one is started, so that a late answer is not taken for the next request's, and is followed by a
+ * disable if nothing is waiting. If the SDK does not answer within another RequestTimeout either, what is live is no
+ * longer known, and the next request disables the video before enabling its device. The same goes for a video
+ * enabled by anything other than a switch, unless it is a synthetic device, whose track tells which it is.
+ */
+UCLASS()
+class DOLBYIODEBUG_API UDolbyIODebugVideoSwitcher : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.1", Units = "s"))
+	float RequestTimeout = 10.0f;
+
+	/** Devices UDolbyIODebugEncoderProbe has seen enable time out after this many times as long, within RequestTimeout. */
+	UPROPERTY(BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "1.0"))
+	float KnownDeviceTimeoutFactor = 4.0f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "Dolby.io Debug", Meta = (ClampMin = "0.1", Units = "s"))
+	float KnownDeviceMinTimeout = 2.0f;
+
+	void Initialize(FSubsystemCollectionBase& Collection) override;
+	void Deinitialize() override;
+
+	FDolbyIODebugSwitchHandle SwitchTo(const FDolbyIOVideoDevice& VideoDevice);
+	FDolbyIODebugSwitchHandle SwitchOff();
+
+	/** Returns the request ID; OnSwitchCompleted reports its outcome. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug", Meta = (DisplayName = "Switch To"))
+	int32 K2_SwitchTo(const FDolbyIOVideoDevice& VideoDevice) { return SwitchTo(VideoDevice).RequestID; }
+
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug", Meta = (DisplayName = "Switch Off"))
+	int32 K2_SwitchOff() { return SwitchOff().RequestID; }
+
+	/** Cancels a request that has not completed yet. */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Debug")
+	void Cancel(int32 RequestID);
+
+	/** The device that is live, unset if the video is disabled. */
+	const TOptional<FDolbyIOVideoDevice>& GetCurrentDevice() const { return CurrentDevice; }
+
+	/** Whether a request is waiting for the SDK. */
+	UFUNCTION(BlueprintPure, Category = "Dolby.io Debug")
+	bool IsSwitching() const { return InFlight.IsValid(); }
+
+	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Debug")
+	FDolbyIODebugOnSwitchCompletedDelegate OnSwitchCompleted;
+
+private:
+	struct FRequest
+	{
+		int32 RequestID = 0;
+		/** Unset to disable the video. */
+		TOptional<FDolbyIOVideoDevice> Device;
+		double RequestTime = 0.0;
+		bool bCancelled = false;
+		/** Set while the current device of the other kind is being disabled before Device is enabled. */
+		bool bDisablingFirst = false;
+		/** Completed as TimedOut, but still waiting for the SDK to answer. */
+		bool bTimedOut = false;
+		TPromise<FDolbyIODebugSwitchResult> Promise;
+	};
+
+	FDolbyIODebugSwitchHandle Submit(TOptional<FDolbyIOVideoDevice> Device);
+	void Start(TUniquePtr<FRequest> Request);
+	void StartNext();
+	void EnableDevice(const FDolbyIOVideoDevice& VideoDevice);
+	void DisableCurrent();
+	void Complete(TUniquePtr<FRequest> Request, EDolbyIODebugSwitchOutcome Outcome);
+	/** Sets the outcome of a request the SDK may still answer. */
+	void Resolve(FRequest& Request, EDolbyIODebugSwitchOutcome Outcome);
+	/** Drops the request in flight once the SDK answered it, or gave up on it, after a timeout. */
+	void FinishTimedOut();
+	void ArmTimeout(float Timeout);
+	float GetTimeout(const TOptional<FDolbyIOVideoDevice>& Device) const;
+	bool HandleTimeout(float DeltaTime);
+	bool IsCurrent(const TOptional<FDolbyIOVideoDevice>& Device) const;
+
+	void HandleVideoEnabled(const FString& VideoTrackID);
+	/** Follows a video enabled by something other than a switch, so that the next switch starts from what is live. */
+	void HandleUnrequestedVideoEnabled(const FString& VideoTrackID);
+	void HandleVideoDisabled(const FString& VideoTrackID);
+
+	TUniquePtr<FRequest> InFlight;
+	TUniquePtr<FRequest> Waiting;
+	TOptional<FDolbyIOVideoDevice> CurrentDevice;
+	FString CurrentVideoTrackID;
+	/** Set when the SDK never answered a request, or enabled a device no switch asked for, so that the device live is not known. */
+	bool bCurrentUnknown = false;
+	FTSTicker::FDelegateHandle TimeoutHandle;
+	int32 NextRequestID = 1;
+};
@@ -0,0 +1,230 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugVideoTelemetry.h"
+#include "DolbyIODebug.h"
+
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Capture to sink (worst source, ms)"), STAT_DolbyIOVideoCaptureLatency, STATGROUP_DolbyIOVideo);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Convert (worst source, ms)"), STAT_DolbyIOVideoConvertTime, STATGROUP_DolbyIOVideo);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Queue depth (all sources)"), STAT_DolbyIOVideoQueueDepth, STATGROUP_DolbyIOVideo);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frames submitted (all sources)"), STAT_DolbyIOVideoFramesSubmitted, STATGROUP_DolbyIOVideo);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frames dropped (all sources)"), STAT_DolbyIOVideoFramesDropped, STATGROUP_DolbyIOVideo);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sources"), STAT_DolbyIOVideoSources, STATGROUP_DolbyIOVideo);
+
+namespace DolbyIODebugVideoTelemetry
+{
+	int32 SampleInterval = 1;
+	FAutoConsoleVariableRef CVarSampleInterval(TEXT("DolbyIODebug.Telemetry.SampleInterval"), SampleInterval,
+	                                           TEXT("Time one frame out of this many per video source, 0 to only count frames."));
+
+	FAutoConsoleCommand CmdDump(TEXT("DolbyIODebug.Telemetry.Dump"), TEXT("Logs the video pipeline telemetry of every source."),
+	                            FConsoleCommandDelegate::CreateLambda(
+	                                []
+	                                {
+		                                for (const FDolbyIODebugVideoSourceTelemetry& Source : FDolbyIODebugVideoTelemetry::Get().GetSources())
+		                                {
+			                                UE_LOG(LogDolbyIODebug, Display,
+			                                       TEXT("%-32s capture %6.2f ms  convert %6.2f ms  queue %d  submitted %lld  dropped %lld"),
+			                                       *Source.Name, Source.CaptureLatencyMs, Source.ConvertTimeMs, Source.QueueDepth,
+			                                       Source.FramesSubmitted, Source.FramesDropped);
+		                                }
+	                                }));
+}
+
+/** The Insights counters of one source, named after it. */
+class FDolbyIODebugVideoTraceCounters
+{
+public:
+#if COUNTERSTRACE_ENABLED
+	explicit FDolbyIODebugVideoTraceCounters(const FString& SourceName)
+	    : CaptureLatencyName(FString::Printf(TEXT("DolbyIOVideo/%s/CaptureLatencyMs"), *SourceName))
+	    , ConvertTimeName(FString::Printf(TEXT("DolbyIOVideo/%s/ConvertTimeMs"), *SourceName))
+	    , QueueDepthName(FString::Printf(TEXT("DolbyIOVideo/%s/QueueDepth"), *SourceName))
+	    , FramesDroppedName(FString::Printf(TEXT("DolbyIOVideo/%s/FramesDropped"), *SourceName))
+	    , CaptureLatency(*CaptureLatencyName, TraceCounterDisplayHint_None)
+	    , ConvertTime(*ConvertTimeName, TraceCounterDisplayHint_None)
+	    , QueueDepth(*QueueDepthName, TraceCounterDisplayHint_None)
+	    , FramesDropped(*FramesDroppedName, TraceCounterDisplayHint_None)
+	{
+	}
+
+	void Set(const FDolbyIODebugVideoSourceTelemetry& Telemetry)
+	{
+		CaptureLatency.Set(Telemetry.CaptureLatencyMs);
+		ConvertTime.Set(Telemetry.ConvertTimeMs);
+		QueueDepth.Set(Telemetry.QueueDepth);
+		FramesDropped.Set(Telemetry.FramesDropped);
+	}
+
+private:
+	// The counters keep pointers to their names
+	const FString CaptureLatencyName;
+	const FString ConvertTimeName;
+	const FString QueueDepthName;
+	const FString FramesDroppedName;
+	FCountersTrace::TCounter<double, TraceCounterType_Float> CaptureLatency;
+	FCountersTrace::TCounter<double, TraceCounterType_Float> ConvertTime;
+	FCountersTrace::TCounter<int64, TraceCounterType_Int> QueueDepth;
+	FCountersTrace::TCounter<int64, TraceCounterType_Int> FramesDropped;
+#else
+	explicit FDolbyIODebugVideoTraceCounters(const FString& SourceName) {}
+	void Set(const FDolbyIODebugVideoSourceTelemetry& Telemetry) {}
+#endif
+};
+
+FDolbyIODebugVideoTelemetry& FDolbyIODebugVideoTelemetry::Get()
+{
+	static FDolbyIODebugVideoTelemetry Instance;
+	return Instance;
+}
+
+int32 FDolbyIODebugVideoTelemetry::RegisterSource(const FString& Name)
+{
+	check(IsInGameThread());
+
+	for (int32 Source = 0; Source < MaxSources; ++Source)
+	{
+		FSlot& Slot = Slots[Source];
+		if (Slot.bRegistered)
+		{
+			continue;
+		}
+
+		Slot.FrameCounter = 0;
+		Slot.FramesSubmitted = 0;
+		Slot.FramesDropped = 0;
+		Slot.QueueDepth = 0;
+		Slot.NumSamples = 0;
+		Slot.NumCaptureSamples = 0;
+		Slot.CaptureLatencyUsSum = 0;
+		Slot.ConvertTimeUsSum = 0;
+		Slot.Published = FDolbyIODebugVideoSourceTelemetry();
+		Slot.Published.Name = Name;
+		Slot.TraceCounters = MakeShared<FDolbyIODebugVideoTraceCounters>(Name);
+		Slot.bRegistered = true;
+		return Source;
+	}
+
+	UE_LOG(LogDolbyIODebug, Warning, TEXT("No telemetry slot left for video source %s"), *Name);
+	return INDEX_NONE;
+}
+
+void FDolbyIODebugVideoTelemetry::UnregisterSource(int32 Source)
+{
+	check(IsInGameThread());
+
+	if (Source >= 0 && Source < MaxSources)
+	{
+		Slots[Source].bRegistered = false;
+		Slots[Source].TraceCounters.Reset();
+	}
+}
+
+bool FDolbyIODebugVideoTelemetry::ShouldSample(int32 Source)
+{
+	if (Source < 0 || Source >= MaxSources || DolbyIODebugVideoTelemetry::SampleInterval <= 0)
+	{
+		return false;
+	}
+	const uint32 FrameNumber = Slots[Source].FrameCounter.fetch_add(1, std::memory_order_relaxed);
+	return FrameNumber % static_cast<uint32>(DolbyIODebugVideoTelemetry::SampleInterval) == 0;
+}
+
+void FDolbyIODebugVideoTelemetry::RecordFrame(int32 Source, int32 QueueDepth)
+{
+	if (Source >= 0 && Source < MaxSources)
+	{
+		Slots[Source].FramesSubmitted.fetch_add(1, std::memory_order_relaxed);
+		Slots[Source].QueueDepth.store(QueueDepth, std::memory_order_relaxed);
+	}
+}
+
+void FDolbyIODebugVideoTelemetry::RecordTimings(int32 Source, double CaptureLatency, double ConvertTime)
+{
+	if (Source < 0 || Source >= MaxSources)
+	{
+		return;
+	}
+
+	FSlot& Slot = Slots[Source];
+	Slot.NumSamples.fetch_add(1, std::memory_order_relaxed);
+	Slot.ConvertTimeUsSum.fetch_add(static_cast<int64>(ConvertTime * 1e6), std::memory_order_relaxed);
+	if (CaptureLatency >= 0.0)
+	{
+		Slot.NumCaptureSamples.fetch_add(1, std::memory_order_relaxed);
+		Slot.CaptureLatencyUsSum.fetch_add(static_cast<int64>(CaptureLatency * 1e6), std::memory_order_relaxed);
+	}
+}
+
+void FDolbyIODebugVideoTelemetry::RecordDroppedFrame(int32 Source)
+{
+	if (Source >= 0 && Source < MaxSources)
+	{
+		Slots[Source].FramesDropped.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void FDolbyIODebugVideoTelemetry::Publish()
+{
+	check(IsInGameThread());
+
+	float WorstCaptureLatencyMs = 0.0f;
+	float WorstConvertTimeMs = 0.0f;
+	int32 TotalQueueDepth = 0;
+	int64 TotalFramesSubmitted = 0;
+	int64 TotalFramesDropped = 0;
+	int32 NumSources = 0;
+	for (FSlot& Slot : Slots)
+	{
+		if (!Slot.bRegistered)
+		{
+			continue;
+		}
+
+		// Sources that produced no timed frame since the last publish keep their previous averages
+		FDolbyIODebugVideoSourceTelemetry& Published = Slot.Published;
+		if (const int64 NumSamples = Slot.NumSamples.exchange(0, std::memory_order_relaxed))
+		{
+			Published.ConvertTimeMs = Slot.ConvertTimeUsSum.exchange(0, std::memory_order_relaxed) / 1000.0f / NumSamples;
+		}
+		if (const int64 NumCaptureSamples = Slot.NumCaptureSamples.exchange(0, std::memory_order_relaxed))
+		{
+			Published.CaptureLatencyMs = Slot.CaptureLatencyUsSum.exchange(0, std::memory_order_relaxed) / 1000.0f / NumCaptureSamples;
+		}
+		Published.QueueDepth = Slot.QueueDepth.load(std::memory_order_relaxed);
+		Published.FramesSubmitted = Slot.FramesSubmitted.load(std::memory_order_relaxed);
+		Published.FramesDropped = Slot.FramesDropped.load(std::memory_order_relaxed);
+		Slot.TraceCounters->Set(Published);
+
+		WorstCaptureLatencyMs = FMath::Max(WorstCaptureLatencyMs, Published.CaptureLatencyMs);
+		WorstConvertTimeMs = FMath::Max(WorstConvertTimeMs, Published.ConvertTimeMs);
+		TotalQueueDepth += Published.QueueDepth;
+		TotalFramesSubmitted += Published.FramesSubmitted;
+		TotalFramesDropped += Published.FramesDropped;
+		++NumSources;
+	}
+
+	SET_FLOAT_STAT(STAT_DolbyIOVideoCaptureLatency, WorstCaptureLatencyMs);
+	SET_FLOAT_STAT(STAT_DolbyIOVideoConvertTime, WorstConvertTimeMs);
+	SET_DWORD_STAT(STAT_DolbyIOVideoQueueDepth, TotalQueueDepth);
+	SET_DWORD_STAT(STAT_DolbyIOVideoFramesSubmitted, TotalFramesSubmitted);
+	SET_DWORD_STAT(STAT_DolbyIOVideoFramesDropped, TotalFramesDropped);
+	SET_DWORD_STAT(STAT_DolbyIOVideoSources, NumSources);
+}
+
+TArray<FDolbyIODebugVideoSourceTelemetry> FDolbyIODebugVideoTelemetry::GetSources() const
+{
+	check(IsInGameThread());
+
+	TArray<FDolbyIODebugVideoSourceTelemetry> Sources;
+	for (const FSlot& Slot : Slots)
+	{
+		if (Slot.bRegistered)
+		{
+			Sources.Add(Slot.Published);
+		}
+	}
+	return Sources;
+}
@@ -0,0 +1,80 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+#include <atomic>
+
+DECLARE_STATS_GROUP(TEXT("DolbyIOVideo"), STATGROUP_DolbyIOVideo, STATCAT_Advanced);
+
+/** Averages of one video source over the last published frame. */
+struct FDolbyIODebugVideoSourceTelemetry
+{
+	FString Name;
+	/** From the capture timestamp of a frame to the frame reaching its sink. */
+	float CaptureLatencyMs = 0.0f;
+	/** Spent converting and copying a frame into the sink's staging memory. */
+	float ConvertTimeMs = 0.0f;
+	/** Frames handed to the sink that the render thread has not presented yet. */
+	int32 QueueDepth = 0;
+	int64 FramesSubmitted = 0;
+	int64 FramesDropped = 0;
+};
+
+/**
+ * Per-source timings of the module's video pipeline, shown by stat DolbyIOVideo and as Insights counters.
+ *
+ * Producing threads record into fixed per-source slots with relaxed atomics only, so recording never locks and can be
+ * left on in shipping builds; DolbyIODebug.Telemetry.SampleInterval controls how many frames are timed. The game
+ * thread publishes the averages once per frame. The SDK's own encoder and network stages are not observable from the
+ * module, so the pipeline covered is the one between the module's frame sources and its frame sinks.
+ */
+class DOLBYIODEBUG_API FDolbyIODebugVideoTelemetry
+{
+public:
+	static constexpr int32 MaxSources = 16;
+
+	static FDolbyIODebugVideoTelemetry& Get();
+
+	/** Game thread only. Returns INDEX_NONE if all the slots are taken. */
+	int32 RegisterSource(const FString& Name);
+	void UnregisterSource(int32 Source);
+
+	/** Whether the next frame of a source should be timed. Any thread. */
+	bool ShouldSample(int32 Source);
+
+	/** Any thread, for every frame. */
+	void RecordFrame(int32 Source, int32 QueueDepth);
+	void RecordDroppedFrame(int32 Source);
+
+	/** Any thread, for the sampled frames. In seconds; a negative capture latency means the frame had no timestamp. */
+	void RecordTimings(int32 Source, double CaptureLatency, double ConvertTime);
+
+	/** Game thread only. Updates the stats, the trace counters and the published averages. */
+	void Publish();
+
+	/** Game thread only. The published averages of the registered sources. */
+	TArray<FDolbyIODebugVideoSourceTelemetry> GetSources() const;
+
+private:
+	struct FSlot
+	{
+		std::atomic<bool> bRegistered{false};
+		std::atomic<uint32> FrameCounter{0};
+		std::atomic<int64> FramesSubmitted{0};
+		std::atomic<int64> FramesDropped{0};
+		std::atomic<int32> QueueDepth{0};
+		std::atomic<int64> NumSamples{0};
+		std::atomic<int64> NumCaptureSamples{0};
+		std::atomic<int64> CaptureLatencyUsSum{0};
+		std::atomic<int64> ConvertTimeUsSum{0};
+
+		/** Game thread only. */
+		FDolbyIODebugVideoSourceTelemetry Published;
+		TSharedPtr<class FDolbyIODebugVideoTraceCounters> TraceCounters;
+	};
+
+	FSlot Slots[MaxSources];
+};
@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugColorConversion.h"
+#include "DolbyIODebugVideoFrame.h"
+
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDolbyIODebugConversionKernelsTest, "DolbyIODebug.Conversion.KernelsMatchScalar",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDolbyIODebugConversionKernelsTest::RunTest(const FString& Parameters)
+{
+	// Not a multiple of the 16 pixel blocks, so the scalar tail of every kernel is covered too, and rows are padded
+	constexpr int32 Width = 118;
+	constexpr int32 Height = 34;
+	constexpr int32 Padding = 10;
+	const EDolbyIODebugPixelFormat Formats[] = {EDolbyIODebugPixelFormat::NV12, EDolbyIODebugPixelFormat::YUY2,
+	                                            EDolbyIODebugPixelFormat::I420};
+	const TCHAR* const FormatNames[] = {TEXT("NV12"), TEXT("YUY2"), TEXT("I420")};
+
+	FRandomStream Random(0x5EED);
+	for (int32 FormatIndex = 0; FormatIndex < UE_ARRAY_COUNT(Formats); ++FormatIndex)
+	{
+		const FDolbyIODebugFrameFormat Format{Width, Height, Formats[FormatIndex]};
+		TArray<uint8> Planes[3];
+		const int32 Stride = static_cast<int32>(Format.GetRowBytes()) + Padding;
+		const int32 ChromaStride = static_cast<int32>(Format.GetChromaRowBytes()) + Padding;
+		Planes[0].SetNumUninitialized(Stride * Height);
+		for (int32 Plane = 0; Plane < Format.GetNumChromaPlanes(); ++Plane)
+		{
+			Planes[Plane + 1].SetNumUninitialized(ChromaStride * (Height / 2));
+		}
+		for (TArray<uint8>& Plane : Planes)
+		{
+			for (uint8& Byte : Plane)
+			{
+				Byte = static_cast<uint8>(Random.RandRange(0, 255));
+			}
+		}
+
+		FDolbyIODebugVideoFrame Frame;
+		Frame.Data = Planes[0].GetData();
+		Frame.Width = Width;
+		Frame.Height = Height;
+		Frame.Stride = Stride;
+		Frame.Format = Format.PixelFormat;
+		Frame.ChromaData[0] = Planes[1].GetData();
+		Frame.ChromaData[1] = Planes[2].GetData();
+		Frame.ChromaStride = ChromaStride;
+		TestTrue(FString::Printf(TEXT("%s frame is valid"), FormatNames[FormatIndex]), Frame.IsValid());
+
+		TArray<uint8> Expected;
+		Expected.SetNumZeroed(Width * 4 * Height);
+		FDolbyIODebugColorConversion::ConvertToBGRA(Frame, Expected.GetData(), Width * 4, EDolbyIODebugConversionKernel::Scalar);
+
+		for (int32 Kernel = 0; Kernel < static_cast<int32>(EDolbyIODebugConversionKernel::Count); ++Kernel)
+		{
+			const EDolbyIODebugConversionKernel ConversionKernel = static_cast<EDolbyIODebugConversionKernel>(Kernel);
+			if (ConversionKernel == EDolbyIODebugConversionKernel::Scalar || !FDolbyIODebugColorConversion::IsSupported(ConversionKernel))
+			{
+				continue;
+			}
+
+			TArray<uint8> Actual;
+			Actual.SetNumZeroed(Expected.Num());
+			FDolbyIODebugColorConversion::ConvertToBGRA(Frame, Actual.GetData(), Width * 4, ConversionKernel);
+			TestTrue(FString::Printf(TEXT("%s with %s matches the scalar kernel"), FormatNames[FormatIndex],
+			                         FDolbyIODebugColorConversion::GetKernelName(ConversionKernel)),
+			         FMemory::Memcmp(Actual.GetData(), Expected.GetData(), Expected.Num()) == 0);
+		}
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,607 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugDeviceCyclerComponent.h"
+#include "DolbyIODebugDeviceRegistry.h"
+#include "DolbyIODebugPreviewTexture.h"
+#include "DolbyIODebugSession.h"
+#include "DolbyIODebugSwitchBenchmark.h"
+#include "DolbyIODebugSyntheticVideo.h"
+#include "DolbyIODebugVideoEvents.h"
+#include "DolbyIODebugVideoSwitcher.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ConfigCacheIni.h"
+#include "RenderingThread.h"
+#include "TextureResource.h"
+#include "UObject/UObjectIterator.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ * These tests drive the devices of a running game: run them in PIE or with -ExecCmds="Automation RunTests DolbyIODebug"
+ * on the command line, with a token and the conference joined for the devices of the SDK to be used.
+ */
+namespace DolbyIODebugDeviceTests
+{
+	/** Seconds a step of a walk may wait for the SDK before the device is reported as failed. */
+	constexpr double StepTimeout = 15.0;
+
+	/** Thumbnails closer than this, in mean absolute difference per channel, show the same image. */
+	constexpr float SameImageThreshold = 3.0f;
+	constexpr int32 ThumbnailSize = 8;
+
+	UGameInstance* FindGameInstance()
+	{
+		if (GEngine)
+		{
+			for (const FWorldContext& Context : GEngine->GetWorldContexts())
+			{
+				if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.OwningGameInstance)
+				{
+					return Context.OwningGameInstance;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	UTexture* GetLiveTexture(UGameInstance* GameInstance, const FDolbyIOVideoDevice& VideoDevice, const FString& VideoTrackID)
+	{
+		if (UDolbyIODebugSyntheticVideo::IsSynthetic(VideoDevice))
+		{
+			const UDolbyIODebugSyntheticVideo* SyntheticVideo = GameInstance->GetSubsystem<UDolbyIODebugSyntheticVideo>();
+			return SyntheticVideo ? SyntheticVideo->GetTexture(VideoTrackID) : nullptr;
+		}
+		UDolbyIOSubsystem* DolbyIOSubsystem = GameInstance->GetSubsystem<UDolbyIOSubsystem>();
+		return DolbyIOSubsystem ? DolbyIOSubsystem->GetTexture(VideoTrackID) : nullptr;
+	}
+
+	/** Reads a texture back and averages it down to ThumbnailSize x ThumbnailSize colours. Empty if it cannot be read. */
+	TArray<FLinearColor> ReadThumbnail(UTexture* Texture)
+	{
+		TArray<FLinearColor> Thumbnail;
+		FTextureResource* Resource = Texture ? Texture->GetResource() : nullptr;
+		if (!Resource)
+		{
+			return Thumbnail;
+		}
+
+		ENQUEUE_RENDER_COMMAND(DolbyIODebugReadThumbnail)(
+		    [Resource, &Thumbnail](FRHICommandListImmediate& RHICmdList)
+		    {
+			    FRHITexture* TextureRHI = Resource->GetTextureRHI();
+			    if (!TextureRHI)
+			    {
+				    return;
+			    }
+			    const FIntPoint Size = TextureRHI->GetSizeXY();
+			    TArray<FColor> Pixels;
+			    RHICmdList.ReadSurfaceData(TextureRHI, FIntRect(FIntPoint::ZeroValue, Size), Pixels, FReadSurfaceDataFlags());
+			    if (Pixels.Num() != Size.X * Size.Y || Size.X < ThumbnailSize || Size.Y < ThumbnailSize)
+			    {
+				    return;
+			    }
+
+			    Thumbnail.SetNumZeroed(ThumbnailSize * ThumbnailSize);
+			    for (int32 Y = 0; Y < Size.Y; ++Y)
+			    {
+				    for (int32 X = 0; X < Size.X; ++X)
+				    {
+					    const FColor& Pixel = Pixels[Y * Size.X + X];
+					    Thumbnail[(Y * ThumbnailSize / Size.Y) * ThumbnailSize + X * ThumbnailSize / Size.X] +=
+					        FLinearColor(Pixel.R, Pixel.G, Pixel.B, 0.0f);
+				    }
+			    }
+			    const float PixelsPerCell = static_cast<float>(Size.X) * Size.Y / (ThumbnailSize * ThumbnailSize);
+			    for (FLinearColor& Cell : Thumbnail)
+			    {
+				    Cell /= PixelsPerCell;
+			    }
+		    });
+		FlushRenderingCommands();
+		return Thumbnail;
+	}
+
+	float GetMeanAbsoluteDifference(const TArray<FLinearColor>& Lhs, const TArray<FLinearColor>& Rhs)
+	{
+		float Sum = 0.0f;
+		for (int32 Index = 0; Index < Lhs.Num(); ++Index)
+		{
+			Sum += FMath::Abs(Lhs[Index].R - Rhs[Index].R) + FMath::Abs(Lhs[Index].G - Rhs[Index].G) + FMath::Abs(Lhs[Index].B - Rhs[Index].B);
+		}
+		return Sum / (Lhs.Num() * 3);
+	}
+
+	/** One device of a walk, from its switch request to the end of its dwell. */
+	struct FVisit
+	{
+		FDolbyIOVideoDevice Device;
+		FString VideoTrackID;
+		int32 Pass = 0;
+		UTexture* Texture = nullptr;
+	};
+
+	/**
+	 * Switches through devices with UDolbyIODebugVideoSwitcher, one after the other, and keeps each of them live for a
+	 * dwell once it presented its first frame. Failed switches are reported on the test and skipped.
+	 */
+	class FDeviceWalkCommand : public IAutomationLatentCommand
+	{
+	public:
+		TFunction<void(const FVisit&)> OnEnableRequested;
+		TFunction<void(const FVisit&)> OnVideoEnabled;
+		TFunction<void(const FVisit&)> OnFirstFrame;
+		TFunction<void(const FVisit&)> OnDwellEnded;
+		TFunction<void()> OnFinished;
+
+		FDeviceWalkCommand(FAutomationTestBase* InTest, UGameInstance* InGameInstance, TArray<FDolbyIOVideoDevice> InDevices, int32 InNumPasses,
+		                   double InDwellTime)
+		    : Test(InTest), GameInstance(InGameInstance), Devices(MoveTemp(InDevices)), NumPasses(InNumPasses), DwellTime(InDwellTime)
+		{
+		}
+
+		bool Update() override
+		{
+			UDolbyIODebugVideoSwitcher* Switcher = GameInstance.IsValid() ? GameInstance->GetSubsystem<UDolbyIODebugVideoSwitcher>() : nullptr;
+			if (!Switcher)
+			{
+				Test->AddError(TEXT("The game instance went away during the test"));
+				return true;
+			}
+
+			if (Step >= Devices.Num() * NumPasses)
+			{
+				Switcher->SwitchOff();
+				if (OnFinished)
+				{
+					OnFinished();
+				}
+				return true;
+			}
+
+			const double Now = FPlatformTime::Seconds();
+			switch (Phase)
+			{
+				case EPhase::Switch:
+				{
+					Visit = FVisit();
+					Visit.Device = Devices[Step % Devices.Num()];
+					Visit.Pass = Step / Devices.Num();
+					Switch = Switcher->SwitchTo(Visit.Device);
+					PhaseStartTime = Now;
+					Phase = EPhase::WaitForVideo;
+					Notify(OnEnableRequested);
+					break;
+				}
+				case EPhase::WaitForVideo:
+				{
+					if (!Switch.Result.IsReady())
+					{
+						break;
+					}
+					const FDolbyIODebugSwitchResult& Result = Switch.Result.Get();
+					if (Result.Outcome != EDolbyIODebugSwitchOutcome::Succeeded)
+					{
+						Test->AddError(FString::Printf(TEXT("Switching to %s did not succeed (%s)"), *Visit.Device.DisplayName,
+						                               *StaticEnum<EDolbyIODebugSwitchOutcome>()->GetNameStringByValue(static_cast<int64>(Result.Outcome))));
+						NextStep();
+						break;
+					}
+					Visit.VideoTrackID = Result.VideoTrackID;
+					PhaseStartTime = Now;
+					Phase = EPhase::WaitForFrame;
+					Notify(OnVideoEnabled);
+					break;
+				}
+				case EPhase::WaitForFrame:
+				{
+					Visit.Texture = GetLiveTexture(GameInstance.Get(), Visit.Device, Visit.VideoTrackID);
+					if (Visit.Texture)
+					{
+						PhaseStartTime = Now;
+						Phase = EPhase::Dwell;
+						Notify(OnFirstFrame);
+					}
+					else if (Now - PhaseStartTime > StepTimeout)
+					{
+						Test->AddError(FString::Printf(TEXT("%s presented no frame within %.0f s"), *Visit.Device.DisplayName, StepTimeout));
+						NextStep();
+					}
+					break;
+				}
+				case EPhase::Dwell:
+				{
+					if (Now - PhaseStartTime >= DwellTime)
+					{
+						Visit.Texture = GetLiveTexture(GameInstance.Get(), Visit.Device, Visit.VideoTrackID);
+						Notify(OnDwellEnded);
+						NextStep();
+					}
+					break;
+				}
+			}
+			return false;
+		}
+
+	private:
+		enum class EPhase : uint8
+		{
+			Switch,
+			WaitForVideo,
+			WaitForFrame,
+			Dwell,
+		};
+
+		void Notify(const TFunction<void(const FVisit&)>& Callback) const
+		{
+			if (Callback)
+			{
+				Callback(Visit);
+			}
+		}
+
+		void NextStep()
+		{
+			++Step;
+			Phase = EPhase::Switch;
+		}
+
+		FAutomationTestBase* const Test;
+		const TWeakObjectPtr<UGameInstance> GameInstance;
+		const TArray<FDolbyIOVideoDevice> Devices;
+		const int32 NumPasses;
+		const double DwellTime;
+
+		int32 Step = 0;
+		EPhase Phase = EPhase::Switch;
+		double PhaseStartTime = 0.0;
+		FVisit Visit;
+		FDolbyIODebugSwitchHandle Switch;
+	};
+
+	/**
+	 * Stands in for the global allocator while it is alive and counts the allocations of the thread that created it,
+	 * forwarding everything to the allocator it replaced so that memory can be freed on either side of it.
+	 */
+	class FAllocationCounter final : public FMalloc
+	{
+	public:
+		FAllocationCounter() : Inner(GMalloc), ThreadId(FPlatformTLS::GetCurrentThreadId()) { GMalloc = this; }
+		~FAllocationCounter() override { GMalloc = Inner; }
+
+		void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			Track(Count);
+			return Inner->Malloc(Count, Alignment);
+		}
+		void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			Track(Count);
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+		void Free(void* Original) override { Inner->Free(Original); }
+		SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		int32 GetNum() const { return Num; }
+
+	private:
+		void Track(SIZE_T Count)
+		{
+			if (Count != 0 && FPlatformTLS::GetCurrentThreadId() == ThreadId)
+			{
+				++Num;
+			}
+		}
+
+		FMalloc* const Inner;
+		const uint32 ThreadId;
+		std::atomic<int32> Num{0};
+	};
+
+	/** The devices of the registry the test can use: all of them in a conference, only the synthetic ones otherwise. */
+	TArray<FDolbyIOVideoDevice> GetTestDevices(UGameInstance* GameInstance, bool bSyntheticAllowed)
+	{
+		TArray<FDolbyIOVideoDevice> Devices;
+		const UDolbyIODebugDeviceRegistry* Registry = GameInstance->GetSubsystem<UDolbyIODebugDeviceRegistry>();
+		const UDolbyIODebugSession* Session = GameInstance->GetSubsystem<UDolbyIODebugSession>();
+		const bool bConnected = Session && Session->IsConnected();
+		for (const FDolbyIOVideoDevice& VideoDevice : Registry ? Registry->GetPresentDevices() : TArray<FDolbyIOVideoDevice>())
+		{
+			const bool bSynthetic = UDolbyIODebugSyntheticVideo::IsSynthetic(VideoDevice);
+			if (bSynthetic ? bSyntheticAllowed : bConnected)
+			{
+				Devices.Add(VideoDevice);
+			}
+		}
+		return Devices;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDolbyIODebugEnabledDeviceCapturesTest, "DolbyIODebug.Device.EnabledDeviceCaptures",
+                                 EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/**
+ * The issue this project reproduces: whatever device Enable Video is given, the SDK captures from the default one.
+ * Every camera is enabled in turn and its preview read back; two cameras showing the same image means that one of
+ * them is not the device capturing.
+ */
+bool FDolbyIODebugEnabledDeviceCapturesTest::RunTest(const FString& Parameters)
+{
+	using namespace DolbyIODebugDeviceTests;
+
+	UGameInstance* GameInstance = FindGameInstance();
+	if (!GameInstance)
+	{
+		AddWarning(TEXT("No game is running, start PIE or the game before running this test"));
+		return true;
+	}
+
+	const TArray<FDolbyIOVideoDevice> Devices = GetTestDevices(GameInstance, false);
+	if (Devices.Num() < 2)
+	{
+		AddWarning(FString::Printf(TEXT("Needs two cameras and a joined conference, %d camera(s) usable"), Devices.Num()));
+		return true;
+	}
+
+	struct FCapture
+	{
+		FString DeviceName;
+		TArray<FLinearColor> Thumbnail;
+	};
+	TSharedRef<TArray<FCapture>> Captures = MakeShared<TArray<FCapture>>();
+
+	// The dwell lets auto exposure settle, so that the images compared are what each camera sees
+	FDeviceWalkCommand* Command = new FDeviceWalkCommand(this, GameInstance, Devices, 1, 2.0);
+	Command->OnDwellEnded = [this, Captures](const FVisit& Visit)
+	{
+		TArray<FLinearColor> Thumbnail = ReadThumbnail(Visit.Texture);
+		if (Thumbnail.Num() == 0)
+		{
+			AddError(FString::Printf(TEXT("Could not read back the preview of %s"), *Visit.Device.DisplayName));
+			return;
+		}
+		Captures->Add({Visit.Device.DisplayName, MoveTemp(Thumbnail)});
+	};
+	Command->OnFinished = [this, Captures]
+	{
+		for (int32 First = 0; First < Captures->Num(); ++First)
+		{
+			for (int32 Second = First + 1; Second < Captures->Num(); ++Second)
+			{
+				const float Difference = GetMeanAbsoluteDifference((*Captures)[First].Thumbnail, (*Captures)[Second].Thumbnail);
+				if (Difference < SameImageThreshold)
+				{
+					AddError(FString::Printf(TEXT("%s and %s show the same image (difference %.1f): the device passed to Enable Video is not "
+					                              "the one capturing"),
+					                         *(*Captures)[First].DeviceName, *(*Captures)[Second].DeviceName, Difference));
+				}
+			}
+		}
+	};
+	AddCommand(Command);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDolbyIODebugDeviceCyclePerformanceTest, "DolbyIODebug.Performance.DeviceCycle",
+                                 EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Cycles through the devices and fails when the switch latency, the memory kept per switch or the frame delivery
+ * rate is worse than the baseline in the [DolbyIODebug.PerformanceBaseline] section of the game config, by more than
+ * its Tolerance. The first pass warms the devices and the frame pool up and is not measured. The samples are written
+ * to Saved/Benchmarks like those of the benchmark mode of the device cycler.
+ */
+bool FDolbyIODebugDeviceCyclePerformanceTest::RunTest(const FString& Parameters)
+{
+	using namespace DolbyIODebugDeviceTests;
+
+	UGameInstance* GameInstance = FindGameInstance();
+	if (!GameInstance)
+	{
+		AddWarning(TEXT("No game is running, start PIE or the game before running this test"));
+		return true;
+	}
+
+	const TArray<FDolbyIOVideoDevice> Devices = GetTestDevices(GameInstance, true);
+	if (Devices.Num() == 0)
+	{
+		AddWarning(TEXT("No usable device, pass -DolbyIOSyntheticVideo=Gradient,Noise or join a conference"));
+		return true;
+	}
+
+	const TCHAR* const BaselineSection = TEXT("DolbyIODebug.PerformanceBaseline");
+	float BaselineLatencyMs = 0.0f;
+	float BaselineMemoryKB = 0.0f;
+	float BaselineDeliveryRatio = 0.0f;
+	float Tolerance = 0.2f;
+	GConfig->GetFloat(BaselineSection, TEXT("SwitchLatencyP95Ms"), BaselineLatencyMs, GGameIni);
+	GConfig->GetFloat(BaselineSection, TEXT("MemoryDeltaPerSwitchKB"), BaselineMemoryKB, GGameIni);
+	GConfig->GetFloat(BaselineSection, TEXT("FrameDeliveryRatio"), BaselineDeliveryRatio, GGameIni);
+	GConfig->GetFloat(BaselineSection, TEXT("Tolerance"), Tolerance, GGameIni);
+
+	struct FMeasurements
+	{
+		FDolbyIODebugSwitchBenchmark Benchmark;
+		uint64 WarmMemory = 0;
+		int32 NumMeasuredSwitches = 0;
+		int64 FramesAtFirstFrame = 0;
+		float MinDeliveryRatio = 1.0f;
+		bool bDeliveryMeasured = false;
+	};
+	TSharedRef<FMeasurements> Measurements = MakeShared<FMeasurements>();
+	constexpr int32 NumPasses = 4;
+	constexpr double DwellTime = 1.0;
+	Measurements->Benchmark.Reset(Devices.Num() * (NumPasses - 1));
+
+	TWeakObjectPtr<UDolbyIODebugSyntheticVideo> SyntheticVideo = GameInstance->GetSubsystem<UDolbyIODebugSyntheticVideo>();
+	auto GetFramesPresented = [SyntheticVideo]
+	{ return SyntheticVideo.IsValid() && SyntheticVideo->PreviewTexture ? SyntheticVideo->PreviewTexture->GetStats().FramesPresented : 0; };
+
+	FDeviceWalkCommand* Command = new FDeviceWalkCommand(this, GameInstance, Devices, NumPasses, DwellTime);
+	Command->OnEnableRequested = [Measurements](const FVisit& Visit)
+	{
+		if (Visit.Pass == 1 && Measurements->WarmMemory == 0)
+		{
+			Measurements->WarmMemory = FPlatformMemory::GetStats().UsedPhysical;
+		}
+		if (Visit.Pass > 0)
+		{
+			Measurements->Benchmark.BeginSample();
+			Measurements->Benchmark.SetSampleDevice(Visit.Device);
+			Measurements->Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::EnableRequested);
+		}
+	};
+	Command->OnVideoEnabled = [Measurements](const FVisit& Visit)
+	{
+		if (Visit.Pass > 0)
+		{
+			Measurements->Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::VideoEnabled);
+		}
+	};
+	Command->OnFirstFrame = [Measurements, GetFramesPresented](const FVisit& Visit)
+	{
+		Measurements->FramesAtFirstFrame = GetFramesPresented();
+		if (Visit.Pass > 0)
+		{
+			Measurements->Benchmark.MarkPhase(EDolbyIODebugSwitchPhase::FirstFrame);
+			++Measurements->NumMeasuredSwitches;
+		}
+	};
+	Command->OnDwellEnded = [Measurements, GetFramesPresented, SyntheticVideo](const FVisit& Visit)
+	{
+		// Only the synthetic devices have a known rate, and frames the module can count
+		const int32 SyntheticIndex = SyntheticVideo.IsValid() ? SyntheticVideo->GetVideoDevices().IndexOfByPredicate(
+		                                                            [&Visit](const FDolbyIOVideoDevice& Candidate)
+		                                                            { return Candidate.UniqueID == Visit.Device.UniqueID; })
+		                                                      : INDEX_NONE;
+		if (Visit.Pass > 0 && SyntheticIndex != INDEX_NONE)
+		{
+			const float ExpectedFrames = SyntheticVideo->Devices[SyntheticIndex].FrameRate * DwellTime;
+			const float DeliveryRatio = (GetFramesPresented() - Measurements->FramesAtFirstFrame) / ExpectedFrames;
+			Measurements->MinDeliveryRatio = FMath::Min(Measurements->MinDeliveryRatio, DeliveryRatio);
+			Measurements->bDeliveryMeasured = true;
+		}
+	};
+	Command->OnFinished = [this, Measurements, BaselineLatencyMs, BaselineMemoryKB, BaselineDeliveryRatio, Tolerance]
+	{
+		const FDolbyIODebugLatencySummary Latency =
+		    Measurements->Benchmark.Summarize(EDolbyIODebugSwitchPhase::EnableRequested, EDolbyIODebugSwitchPhase::FirstFrame);
+		const float MemoryKB = Measurements->NumMeasuredSwitches > 0
+		                           ? (static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(Measurements->WarmMemory)) /
+		                                 1024.0f / Measurements->NumMeasuredSwitches
+		                           : 0.0f;
+		Measurements->Benchmark.WriteCsv(TEXT("AutomationDeviceCycle"));
+		AddInfo(FString::Printf(TEXT("Switch latency p50 %.1f ms, p95 %.1f ms over %d switches; %.1f KB kept per switch; frame delivery %s"),
+		                        Latency.P50, Latency.P95, Latency.Count, MemoryKB,
+		                        Measurements->bDeliveryMeasured ? *FString::Printf(TEXT("%.0f%%"), Measurements->MinDeliveryRatio * 100.0f)
+		                                                              : TEXT("not measured")));
+
+		if (Latency.Count == 0)
+		{
+			AddError(TEXT("No switch completed"));
+			return;
+		}
+		if (BaselineLatencyMs > 0.0f && Latency.P95 > BaselineLatencyMs * (1.0f + Tolerance))
+		{
+			AddError(FString::Printf(TEXT("Switch latency p95 %.1f ms is over the baseline of %.1f ms"), Latency.P95, BaselineLatencyMs));
+		}
+		if (BaselineMemoryKB > 0.0f && MemoryKB > BaselineMemoryKB * (1.0f + Tolerance))
+		{
+			AddError(FString::Printf(TEXT("%.1f KB kept per switch is over the baseline of %.1f KB"), MemoryKB, BaselineMemoryKB));
+		}
+		if (BaselineDeliveryRatio > 0.0f && Measurements->bDeliveryMeasured &&
+		    Measurements->MinDeliveryRatio < BaselineDeliveryRatio * (1.0f - Tolerance))
+		{
+			AddError(FString::Printf(TEXT("Frame delivery of %.0f%% is under the baseline of %.0f%%"), Measurements->MinDeliveryRatio * 100.0f,
+			                         BaselineDeliveryRatio * 100.0f));
+		}
+	};
+	AddCommand(Command);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDolbyIODebugVideoEventAllocationsTest, "DolbyIODebug.Performance.VideoEventAllocations",
+                                 EAutomationTestFlags::ClientContext | EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+/**
+ * Feeds the track events of device switches to UDolbyIODebugVideoEvents the way the SDK broadcasts them, and fails
+ * if the module allocates anything for them once warm. Only the module is measured: the SDK's own broadcast copies
+ * the track ID before the module sees it. Needs the local video off, so that the events do not disturb a switch.
+ */
+bool FDolbyIODebugVideoEventAllocationsTest::RunTest(const FString& Parameters)
+{
+	using namespace DolbyIODebugDeviceTests;
+
+	UGameInstance* GameInstance = FindGameInstance();
+	if (!GameInstance)
+	{
+		AddWarning(TEXT("No game is running, start PIE or the game before running this test"));
+		return true;
+	}
+
+	UDolbyIODebugVideoEvents* VideoEvents = GameInstance->GetSubsystem<UDolbyIODebugVideoEvents>();
+	const UDolbyIODebugSession* Session = GameInstance->GetSubsystem<UDolbyIODebugSession>();
+	const UDolbyIODebugVideoSwitcher* Switcher = GameInstance->GetSubsystem<UDolbyIODebugVideoSwitcher>();
+	bool bCycling = false;
+	for (TObjectIterator<UDolbyIODebugDeviceCyclerComponent> It; It; ++It)
+	{
+		bCycling |= It->IsCycling();
+	}
+	if (!VideoEvents || !Session || !Switcher || !Session->GetLiveVideoTrackID().IsEmpty() || Switcher->IsSwitching() || bCycling)
+	{
+		AddWarning(TEXT("Needs the local video off, with no switch in flight and no device cycler running"));
+		return true;
+	}
+
+	UFunction* EnabledFunction = VideoEvents->FindFunction(TEXT("HandleVideoEnabled"));
+	UFunction* DisabledFunction = VideoEvents->FindFunction(TEXT("HandleVideoDisabled"));
+	if (!TestNotNull(TEXT("Video enabled handler"), EnabledFunction) || !TestNotNull(TEXT("Video disabled handler"), DisabledFunction))
+	{
+		return false;
+	}
+
+	// The parameters of the SDK's broadcast, made before counting as the SDK makes them
+	struct FParms
+	{
+		FString VideoTrackID;
+	};
+	FParms Tracks[] = {{TEXT("a0b1c2d3-e4f5-4a6b-8c7d-9e0f1a2b3c4d")}, {TEXT("5e6f7a8b-9c0d-4e1f-a2b3-c4d5e6f7a8b9")}};
+	auto Switch = [&]
+	{
+		for (FParms& Track : Tracks)
+		{
+			VideoEvents->ProcessEvent(EnabledFunction, &Track);
+			VideoEvents->ProcessEvent(DisabledFunction, &Track);
+		}
+	};
+
+	constexpr int32 NumSwitches = 50;
+	Switch();
+	int32 NumAllocations = 0;
+	{
+		FAllocationCounter Counter;
+		for (int32 Index = 0; Index < NumSwitches; ++Index)
+		{
+			Switch();
+		}
+		NumAllocations = Counter.GetNum();
+	}
+
+	AddInfo(FString::Printf(TEXT("%d allocations over %d warm enable and disable pairs"), NumAllocations,
+	                        NumSwitches * static_cast<int32>(UE_ARRAY_COUNT(Tracks))));
+	TestEqual(TEXT("Allocations for the track events once warm"), NumAllocations, 0);
+	return true;
+}
+
+#endif
@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugFrameScheduler.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace DolbyIODebugFrameSchedulerTests
+{
+	constexpr double Timeout = 5.0;
+
+	template <typename TPredicate>
+	bool WaitFor(TPredicate Predicate)
+	{
+		const double Deadline = FPlatformTime::Seconds() + Timeout;
+		while (!Predicate())
+		{
+			if (FPlatformTime::Seconds() > Deadline)
+			{
+				return false;
+			}
+			FPlatformProcess::SleepNoStats(0.001f);
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDolbyIODebugFrameTrackTest, "DolbyIODebug.FrameScheduler.OrderDropsAndClose",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDolbyIODebugFrameTrackTest::RunTest(const FString& Parameters)
+{
+	using namespace DolbyIODebugFrameSchedulerTests;
+
+	const IConsoleVariable* MaxQueuedFramesVariable =
+	    IConsoleManager::Get().FindConsoleVariable(TEXT("DolbyIODebug.FrameScheduler.MaxQueuedFrames"));
+	const int32 MaxQueuedFrames = FMath::Max(MaxQueuedFramesVariable ? MaxQueuedFramesVariable->GetInt() : 2, 1);
+	constexpr int32 NumFrames = 10;
+	constexpr int32 Width = 8;
+	constexpr int32 Height = 2;
+
+	// The sink holds on to the first frame, so the frames submitted meanwhile have to be queued or dropped
+	FCriticalSection CriticalSection;
+	TArray<uint8> ReceivedFrames;
+	std::atomic<bool> bSinkEntered{false};
+	std::atomic<bool> bSinkBlocked{true};
+	TSharedRef<FDolbyIODebugFrameTrack, ESPMode::ThreadSafe> FrameTrack = FDolbyIODebugFrameTrack::Open(
+	    TEXT("FrameTrackTest"),
+	    [&](const FDolbyIODebugVideoFrame& Frame)
+	    {
+		    bSinkEntered = true;
+		    while (bSinkBlocked)
+		    {
+			    FPlatformProcess::SleepNoStats(0.001f);
+		    }
+		    FScopeLock Lock(&CriticalSection);
+		    ReceivedFrames.Add(Frame.Data[0]);
+	    });
+
+	TArray<uint8> Pixels;
+	Pixels.SetNumZeroed(Width * Height * 4);
+	FDolbyIODebugVideoFrame Frame;
+	Frame.Data = Pixels.GetData();
+	Frame.Width = Width;
+	Frame.Height = Height;
+	Frame.Stride = Width * 4;
+
+	// Every frame is tagged with its index, and copied by Submit, so the pixels can be reused right away
+	const auto SubmitFrame = [&](int32 Index)
+	{
+		Pixels[0] = static_cast<uint8>(Index);
+		FrameTrack->Submit(Frame);
+	};
+
+	SubmitFrame(0);
+	if (!TestTrue(TEXT("Sink is called"), WaitFor([&bSinkEntered] { return bSinkEntered.load(); })))
+	{
+		bSinkBlocked = false;
+		FrameTrack->Close();
+		return false;
+	}
+	for (int32 Index = 1; Index < NumFrames; ++Index)
+	{
+		SubmitFrame(Index);
+	}
+	bSinkBlocked = false;
+
+	const int32 NumExpected = 1 + FMath::Min(MaxQueuedFrames, NumFrames - 1);
+	const auto HasReceivedExpected = [&]
+	{
+		FScopeLock Lock(&CriticalSection);
+		return ReceivedFrames.Num() >= NumExpected;
+	};
+	TestTrue(TEXT("Queued frames are presented"), WaitFor(HasReceivedExpected));
+	FrameTrack->Close();
+	SubmitFrame(NumFrames);
+
+	FScopeLock Lock(&CriticalSection);
+	TestEqual(TEXT("Frames presented"), ReceivedFrames.Num(), NumExpected);
+	TestEqual(TEXT("Frames dropped"), FrameTrack->GetFramesDropped(), static_cast<int64>(NumFrames - NumExpected));
+	for (int32 Index = 1; Index < ReceivedFrames.Num(); ++Index)
+	{
+		TestTrue(TEXT("Frames are presented in order"), ReceivedFrames[Index - 1] < ReceivedFrames[Index]);
+	}
+	if (ReceivedFrames.Num() > 0)
+	{
+		TestEqual(TEXT("The newest frame is kept"), static_cast<int32>(ReceivedFrames.Last()), NumFrames - 1);
+	}
+	return true;
+}
+
+#endif
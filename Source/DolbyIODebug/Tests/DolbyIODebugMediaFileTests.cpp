@@ -0,0 +1,117 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugMediaFile.h"
+
+#include "DolbyIOSubsystem.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDolbyIODebugMediaFileRoundTripTest, "DolbyIODebug.MediaFile.RoundTrip",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDolbyIODebugMediaFileRoundTripTest::RunTest(const FString& Parameters)
+{
+	FDolbyIODebugMediaWriter& Writer = FDolbyIODebugMediaWriter::Get();
+	if (Writer.IsOpen())
+	{
+		AddWarning(TEXT("Media is being recorded, the writer cannot be tested"));
+		return true;
+	}
+
+	// An NV12 frame with padded rows, which the recording stores without the padding
+	constexpr int32 Width = 32;
+	constexpr int32 Height = 16;
+	constexpr int32 Stride = Width + 8;
+	TArray<uint8> Luma;
+	TArray<uint8> Chroma;
+	Luma.SetNumUninitialized(Stride * Height);
+	Chroma.SetNumUninitialized(Stride * Height / 2);
+	for (int32 Index = 0; Index < Luma.Num(); ++Index)
+	{
+		Luma[Index] = static_cast<uint8>(Index * 7);
+	}
+	for (int32 Index = 0; Index < Chroma.Num(); ++Index)
+	{
+		Chroma[Index] = static_cast<uint8>(Index * 13);
+	}
+
+	FDolbyIODebugVideoFrame Frame;
+	Frame.Data = Luma.GetData();
+	Frame.Width = Width;
+	Frame.Height = Height;
+	Frame.Stride = Stride;
+	Frame.Format = EDolbyIODebugPixelFormat::NV12;
+	Frame.ChromaData[0] = Chroma.GetData();
+	Frame.ChromaStride = Stride;
+
+	const float Samples[] = {0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 0.25f};
+	FDolbyIOVideoDevice VideoDevice;
+	VideoDevice.DisplayName = TEXT("Cam\u00e9ra int\u00e9gr\u00e9e");
+	VideoDevice.UniqueID = TEXT("device:1");
+
+	const FString Path = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MediaFileRoundTrip.dior"));
+	if (!TestTrue(TEXT("Writer opens"), Writer.Open(Path)))
+	{
+		return false;
+	}
+	Writer.WriteVideoEvent(EDolbyIODebugMediaRecordType::VideoEnabled, VideoDevice.UniqueID);
+	Writer.WriteVideoFrame(3, Frame);
+	Writer.WriteAudioBuffer(Samples, UE_ARRAY_COUNT(Samples), 2, 48000);
+	Writer.WriteVideoDevices({VideoDevice});
+	Writer.Close();
+
+	{
+		FDolbyIODebugMediaReader Reader;
+		if (!TestTrue(TEXT("Reader maps the recording"), Reader.Open(Path)))
+		{
+			return false;
+		}
+
+		const TArray<FDolbyIODebugMediaReader::FRecord>& Records = Reader.GetRecords();
+		if (!TestEqual(TEXT("Number of records"), Records.Num(), 4))
+		{
+			return false;
+		}
+
+		TestTrue(TEXT("Records are in order"), Records[0].Header->Time <= Records[3].Header->Time);
+		TestEqual(TEXT("Enabled track"), FDolbyIODebugMediaReader::ReadVideoEvent(Records[0]), VideoDevice.UniqueID);
+
+		int32 Stream = INDEX_NONE;
+		const FDolbyIODebugVideoFrame ReadFrame = FDolbyIODebugMediaReader::ReadVideoFrame(Records[1], Stream);
+		TestEqual(TEXT("Stream"), Stream, 3);
+		if (TestTrue(TEXT("Replayed frame is valid"), ReadFrame.IsValid()))
+		{
+			bool bPixelsMatch = true;
+			for (int32 Row = 0; Row < Height; ++Row)
+			{
+				bPixelsMatch &= FMemory::Memcmp(ReadFrame.Data + Row * ReadFrame.Stride, Luma.GetData() + Row * Stride, Width) == 0;
+			}
+			for (int32 Row = 0; Row < Height / 2; ++Row)
+			{
+				bPixelsMatch &=
+				    FMemory::Memcmp(ReadFrame.ChromaData[0] + Row * ReadFrame.ChromaStride, Chroma.GetData() + Row * Stride, Width) == 0;
+			}
+			TestTrue(TEXT("Replayed pixels match the recorded ones"), bPixelsMatch);
+		}
+
+		FDolbyIODebugMediaAudioBufferHeader BufferHeader;
+		FMemory::Memcpy(&BufferHeader, Records[2].Payload, sizeof(BufferHeader));
+		TestEqual(TEXT("Audio samples"), BufferHeader.NumSamples, static_cast<int32>(UE_ARRAY_COUNT(Samples)));
+		TestTrue(TEXT("Audio matches"), FMemory::Memcmp(Records[2].Payload + sizeof(BufferHeader), Samples, sizeof(Samples)) == 0);
+
+		const TArray<FDolbyIOVideoDevice> VideoDevices = FDolbyIODebugMediaReader::ReadVideoDevices(Records[3]);
+		if (TestEqual(TEXT("Number of devices"), VideoDevices.Num(), 1))
+		{
+			TestEqual(TEXT("Device name"), VideoDevices[0].DisplayName, VideoDevice.DisplayName);
+			TestEqual(TEXT("Device ID"), VideoDevices[0].UniqueID, VideoDevice.UniqueID);
+		}
+	}
+
+	IFileManager::Get().Delete(*Path);
+	return true;
+}
+
+#endif
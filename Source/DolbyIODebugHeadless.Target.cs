@@ -0,0 +1,20 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+// Game target for GPU-less CI agents. Run with -nullrhi -nosplash -unattended -DolbyIOStress=<conference>.
+public class DolbyIODebugHeadlessTarget : TargetRules
+{
+	public DolbyIODebugHeadlessTarget( TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Game;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
+		ExtraModuleNames.Add("DolbyIODebug");
+
+		// The RHI is picked before game modules load, so rendering can only be turned off with -nullrhi;
+		// the module warns when a headless build is started without it
+		ProjectDefinitions.Add("DOLBYIODEBUG_HEADLESS=1");
+	}
+}
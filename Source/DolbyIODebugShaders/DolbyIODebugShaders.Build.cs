@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class DolbyIODebugShaders : ModuleRules
+{
+	public DolbyIODebugShaders(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "RenderCore", "RHI" });
+
+		PrivateDependencyModuleNames.AddRange(new string[] { "Projects" });
+	}
+}
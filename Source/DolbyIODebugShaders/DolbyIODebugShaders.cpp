@@ -0,0 +1,13 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugShaders.h"
+
+#include "Misc/Paths.h"
+#include "ShaderCore.h"
+
+void FDolbyIODebugShadersModule::StartupModule()
+{
+	AddShaderSourceDirectoryMapping(TEXT("/DolbyIODebug"), FPaths::Combine(FPaths::ProjectDir(), TEXT("Shaders")));
+}
+
+IMPLEMENT_MODULE(FDolbyIODebugShadersModule, DolbyIODebugShaders);
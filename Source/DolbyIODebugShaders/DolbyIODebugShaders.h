@@ -0,0 +1,13 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleInterface.h"
+
+/** Loaded before the engine compiles its global shaders, so that the project shaders under /DolbyIODebug are found. */
+class FDolbyIODebugShadersModule : public IModuleInterface
+{
+public:
+	void StartupModule() override;
+};
@@ -0,0 +1,59 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "DolbyIODebugYuvToRgba.h"
+
+#include "GlobalShader.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "ShaderParameterStruct.h"
+
+class FDolbyIODebugYuvToRgbaCS : public FGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FDolbyIODebugYuvToRgbaCS);
+	SHADER_USE_PARAMETER_STRUCT(FDolbyIODebugYuvToRgbaCS, FGlobalShader);
+
+	static constexpr int32 ThreadGroupSize = 8;
+
+	class FLayoutDim : SHADER_PERMUTATION_INT("YUV_LAYOUT", static_cast<int32>(EDolbyIODebugYuvLayout::Count));
+	using FPermutationDomain = TShaderPermutationDomain<FLayoutDim>;
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(FIntPoint, OutputSize)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PlaneY)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PlaneU)
+		SHADER_PARAMETER_RDG_TEXTURE(Texture2D, PlaneV)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D<float4>, Output)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREAD_GROUP_SIZE"), ThreadGroupSize);
+	}
+};
+
+IMPLEMENT_GLOBAL_SHADER(FDolbyIODebugYuvToRgbaCS, "/DolbyIODebug/Private/YuvToRgba.usf", "MainCS", SF_Compute);
+
+void AddYuvToRgbaPass(FRDGBuilder& GraphBuilder, EDolbyIODebugYuvLayout Layout, FIntPoint Size, FRDGTextureRef PlaneY, FRDGTextureRef PlaneU,
+                      FRDGTextureRef PlaneV, FRDGTextureRef Output)
+{
+	FDolbyIODebugYuvToRgbaCS::FPermutationDomain PermutationVector;
+	PermutationVector.Set<FDolbyIODebugYuvToRgbaCS::FLayoutDim>(static_cast<int32>(Layout));
+	TShaderMapRef<FDolbyIODebugYuvToRgbaCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel), PermutationVector);
+
+	FDolbyIODebugYuvToRgbaCS::FParameters* Parameters = GraphBuilder.AllocParameters<FDolbyIODebugYuvToRgbaCS::FParameters>();
+	Parameters->OutputSize = Size;
+	Parameters->PlaneY = PlaneY;
+	Parameters->PlaneU = PlaneU ? PlaneU : PlaneY;
+	Parameters->PlaneV = PlaneV ? PlaneV : Parameters->PlaneU;
+	Parameters->Output = GraphBuilder.CreateUAV(Output);
+
+	FComputeShaderUtils::AddPass(GraphBuilder, RDG_EVENT_NAME("DolbyIODebugYuvToRgba %dx%d", Size.X, Size.Y), ComputeShader, Parameters,
+	                             FComputeShaderUtils::GetGroupCount(Size, FDolbyIODebugYuvToRgbaCS::ThreadGroupSize));
+}
@@ -0,0 +1,28 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphFwd.h"
+
+/** Plane layouts the compute conversion reads, the GPU counterparts of the YUV frame formats. */
+enum class EDolbyIODebugYuvLayout : uint8
+{
+	/** PlaneY is R8 at full resolution, PlaneU is R8G8 (UV) at half resolution. */
+	NV12,
+	/** PlaneY is R8G8B8A8 at half width, each texel holding Y0 U Y1 V. */
+	YUY2,
+	/** PlaneY is R8 at full resolution, PlaneU and PlaneV are R8 at half resolution. */
+	I420,
+
+	Count
+};
+
+/**
+ * Adds a compute pass converting YUV planes to Output, with the BT.601 limited range coefficients of the CPU kernels.
+ *
+ * Output must be a UAV-compatible RGBA texture of the frame resolution; sRGB formats cannot be, so convert into a
+ * linear target and copy it if the consumer samples sRGB. PlaneV is only read for I420.
+ */
+DOLBYIODEBUGSHADERS_API void AddYuvToRgbaPass(FRDGBuilder& GraphBuilder, EDolbyIODebugYuvLayout Layout, FIntPoint Size, FRDGTextureRef PlaneY,
+                                              FRDGTextureRef PlaneU, FRDGTextureRef PlaneV, FRDGTextureRef Output);